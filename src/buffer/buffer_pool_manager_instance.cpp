@@ -12,6 +12,8 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <algorithm>
+
 #include "common/macros.h"
 
 #include "common/logger.h"
@@ -19,33 +21,60 @@
 namespace bustub {
 
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager,
-                                                     LogManager *log_manager)
-    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, log_manager) {}
+                                                     LogManager *log_manager, ReplacerType replacer_type)
+    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, log_manager, replacer_type) {}
 
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances,  // NOLINT
                                                      uint32_t instance_index, DiskManager *disk_manager,
-                                                     LogManager *log_manager)
+                                                     LogManager *log_manager, ReplacerType replacer_type,
+                                                     int numa_node)
     : pool_size_(pool_size),
       num_instances_(num_instances),
       instance_index_(instance_index),
       next_page_id_(static_cast<page_id_t>(instance_index)),
+      frame_arena_(pool_size, buffer_pool_huge_pages, numa_node),
       disk_manager_(disk_manager),
       log_manager_(log_manager) {
   BUSTUB_ASSERT(num_instances > 0, "If BPI is not part of a pool, then the pool size should just be 1");
   BUSTUB_ASSERT(
       instance_index < num_instances,
       "BPI index cannot be greater than the number of BPIs in the pool. In non-parallel case, index should just be 1.");
-  // We allocate a consecutive memory space for the buffer pool.
+  // We allocate a consecutive memory space for the buffer pool. The frame data lives in the arena, apart from the
+  // metadata and latches, so that it is page-aligned and densely packed into huge pages.
   pages_ = new Page[pool_size_];
-  replacer_ = new LRUReplacer(pool_size);
+  for (size_t i = 0; i < pool_size_; ++i) {
+    pages_[i].data_ = frame_arena_.GetFrameData(static_cast<frame_id_t>(i));
+  }
+  switch (replacer_type) {
+    case ReplacerType::LRU:
+      replacer_ = new LRUReplacer(pool_size);
+      break;
+    case ReplacerType::LRU_K:
+      replacer_ = new LRUKReplacer(pool_size);
+      break;
+    case ReplacerType::CLOCK:
+      replacer_ = new ClockReplacer(pool_size);
+      break;
+  }
 
   // Initially, every page is in the free list.
   for (size_t i = 0; i < pool_size_; ++i) {
     free_list_.emplace_back(static_cast<int>(i));
   }
+  free_page_list_.Init(INVALID_PAGE_ID, INVALID_PAGE_ID);
 }
 
 BufferPoolManagerInstance::~BufferPoolManagerInstance() {
+  StopBackgroundWriter();
+  {
+    std::lock_guard<std::mutex> guard(prefetch_latch_);
+    prefetch_running_ = false;
+  }
+  if (prefetch_thread_ != nullptr) {
+    prefetch_cv_.notify_one();
+    prefetch_thread_->join();
+    delete prefetch_thread_;
+  }
   delete[] pages_;
   delete replacer_;
 }
@@ -53,23 +82,18 @@ BufferPoolManagerInstance::~BufferPoolManagerInstance() {
 bool BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) {
   // Make sure you call DiskManager::WritePage!
   std::lock_guard<std::mutex> guard(latch_);
-  if (page_table_.find(page_id) == page_table_.end()) {
+  PageTableShard &shard = GetShard(page_id);
+  std::shared_lock<std::shared_mutex> shard_guard(shard.latch_);
+  auto iter = shard.table_.find(page_id);
+  if (iter == shard.table_.end()) {
     // The given page_id doesn't exist.
     return false;
   }
-  frame_id_t frame_id = page_table_[page_id];
-  Page *page = &pages_[frame_id];
+  Page *page = &pages_[iter->second];
   if (page->GetPageId() == INVALID_PAGE_ID) {
     return false;
   }
-  // Write the page data to the disk.
-  //  if (page->IsDirty()) {
-  //    disk_manager_->WritePage(page_id, page->GetData());
-  //    page->is_dirty_ = false;
-  //  }
-  if (page_id < 3) {
-    LOG_DEBUG("flush page:%d", page_id);
-  }
+  WaitForWriteBack(page_id);
   disk_manager_->WritePage(page_id, page->GetData());
   page->is_dirty_ = false;
   return true;
@@ -80,18 +104,91 @@ void BufferPoolManagerInstance::FlushAllPgsImp() {
   LOG_DEBUG("flush all pages");
   for (size_t i = 0; i < pool_size_; ++i) {
     if (pages_[i].GetPageId() == INVALID_PAGE_ID) {
-      // if (page_id == 6) {
-      //   LOG_DEBUG("pin cnt:%u", page->GetPinCount());
-      // }
       continue;
     }
-    //    if (pages_[i].IsDirty()) {
-    //      disk_manager_->WritePage(pages_[i].GetPageId(), pages_[i].GetData());
-    //      pages_[i].is_dirty_ = false;
-    //    }
+    WaitForWriteBack(pages_[i].GetPageId());
     disk_manager_->WritePage(pages_[i].GetPageId(), pages_[i].GetData());
     pages_[i].is_dirty_ = false;
   }
+  std::lock_guard<std::mutex> guard(latch_);
+  FlushFreePageList();
+}
+
+size_t BufferPoolManagerInstance::GetNumHits() {
+  size_t num_hits = 0;
+  for (PageTableShard &shard : page_table_) {
+    num_hits += shard.num_hits_.load(std::memory_order_relaxed);
+  }
+  return num_hits;
+}
+
+size_t BufferPoolManagerInstance::GetNumPinnedFrames() {
+  size_t num_pinned_frames = 0;
+  for (size_t i = 0; i < pool_size_; ++i) {
+    if (pages_[i].pin_count_ > 0) {
+      ++num_pinned_frames;
+    }
+  }
+  return num_pinned_frames;
+}
+
+BufferPoolStats BufferPoolManagerInstance::GetStats() {
+  return BufferPoolStats{pool_size_,           GetNumHits(),          GetNumMisses(),
+                         GetNumCleanEvictions(), GetNumDirtyEvictions(), GetNumPinnedFrames()};
+}
+
+Page *BufferPoolManagerInstance::PinIfResident(page_id_t page_id) {
+  PageTableShard &shard = GetShard(page_id);
+  std::shared_lock<std::shared_mutex> shard_guard(shard.latch_);
+  auto iter = shard.table_.find(page_id);
+  if (iter == shard.table_.end()) {
+    return nullptr;
+  }
+  // Eviction erases the mapping under the exclusive shard latch after checking the pin count, so the page cannot be
+  // evicted between the lookup and the increment. Only the first pinner has to take the page out of the replacer, but
+  // every hit counts as an access.
+  Page *page = &pages_[iter->second];
+  if (page->pin_count_.fetch_add(1) == 0) {
+    replacer_->Pin(iter->second);
+  } else {
+    replacer_->RecordAccess(iter->second);
+  }
+  shard.num_hits_.fetch_add(1, std::memory_order_relaxed);
+  return page;
+}
+
+bool BufferPoolManagerInstance::FindFreeFrame(frame_id_t *frame_id, bool evict) {
+  if (!free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+    return true;
+  }
+  if (!evict) {
+    return false;
+  }
+  // We need to evict one page through the replacer.
+  while (replacer_->Victim(frame_id)) {
+    Page *page = &pages_[*frame_id];
+    PageTableShard &shard = GetShard(page->GetPageId());
+    std::unique_lock<std::shared_mutex> shard_guard(shard.latch_);
+    if (page->GetPinCount() > 0) {
+      // A concurrent hit pinned the frame after it was unpinned. Drop it here; the last unpin puts it back.
+      continue;
+    }
+    shard.table_.erase(page->GetPageId());
+    shard_guard.unlock();
+    if (page->IsDirty()) {
+      ++num_dirty_evictions_;
+      WaitForWriteBack(page->GetPageId());
+      disk_manager_->WritePage(page->GetPageId(), page->GetData());
+      // The background writer fell behind; let it catch up before the next miss.
+      writer_cv_.notify_one();
+    } else {
+      ++num_clean_evictions_;
+    }
+    return true;
+  }
+  return false;
 }
 
 Page *BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) {
@@ -100,37 +197,33 @@ Page *BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) {
   // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
   // 3.   Update P's metadata, zero out memory and add P to the page table.
   // 4.   Set the page ID output parameter. Return a pointer to P.
+  return NewPageInFreeFrame(page_id, true);
+}
+
+Page *BufferPoolManagerInstance::NewPageWithoutEviction(page_id_t *page_id) {
+  return NewPageInFreeFrame(page_id, false);
+}
+
+Page *BufferPoolManagerInstance::NewPageInFreeFrame(page_id_t *page_id, bool evict) {
   std::lock_guard<std::mutex> guard(latch_);
   frame_id_t frame_id;
-  if (free_list_.empty()) {
-    // We need to evict one page through the replacer.
-    if (!replacer_->Victim(&frame_id)) {
-      return nullptr;
-    }
-    Page *page = &pages_[frame_id];
-    if (page->IsDirty()) {
-      disk_manager_->WritePage(page->GetPageId(), page->GetData());
-    }
-    page_table_.erase(page->GetPageId());
-  } else {
-    // There exists one free frame.
-    frame_id = free_list_.front();
-    free_list_.pop_front();
+  if (!FindFreeFrame(&frame_id, evict)) {
+    return nullptr;
   }
-
   replacer_->Pin(frame_id);
 
   Page *page = &pages_[frame_id];
   page->ResetMemory();
-  // I'm not sure here...
   page->page_id_ = AllocatePage();
   page->pin_count_ = 1;
   page->is_dirty_ = false;
   *page_id = page->page_id_;
-  // if (*page_id < 6) {
-  //   LOG_DEBUG("insert page:%d", *page_id);
-  // }
-  page_table_.insert({*page_id, frame_id});
+
+  // Neither FetchPage nor a read-ahead brings in a page while it is deallocated, so a reused id is never cached.
+  PageTableShard &shard = GetShard(*page_id);
+  std::unique_lock<std::shared_mutex> shard_guard(shard.latch_);
+  bool inserted = shard.table_.insert({*page_id, frame_id}).second;
+  BUSTUB_ASSERT(inserted, "a deallocated page is still cached");
   return page;
 }
 
@@ -142,51 +235,44 @@ Page *BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) {
   // 2.     If R is dirty, write it back to the disk.
   // 3.     Delete R from the page table and insert P.
   // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
-  std::lock_guard<std::mutex> guard(latch_);
-  // if (page_id < 3) {
-  // LOG_DEBUG("fetch page:%d.", page_id);
-  // }
-  if (page_table_.find(page_id) == page_table_.end()) {
-    // P doesn't exist
-    frame_id_t frame_id;
-    if (free_list_.empty()) {
-      // We need to evict one page through the replacer.
-      if (!replacer_->Victim(&frame_id)) {
-        return nullptr;
-      }
-      Page *page = &pages_[frame_id];
-      if (page->IsDirty()) {
-        disk_manager_->WritePage(page->GetPageId(), page->GetData());
-      }
-      page_table_.erase(page->GetPageId());
-      page_table_.insert({page_id, frame_id});
-    } else {
-      // There exists one free frame.
-      frame_id = free_list_.front();
-      free_list_.pop_front();
-      page_table_.insert({page_id, frame_id});
-    }
-
-    replacer_->Pin(frame_id);
+  Page *page = PinIfResident(page_id);
+  if (page != nullptr) {
+    return page;
+  }
 
-    Page *page = &pages_[frame_id];
-    page->page_id_ = page_id;
-    // not sure
-    page->pin_count_ = 1;
-    page->is_dirty_ = false;
-    // Read the page content of this page.
-    disk_manager_->ReadPage(page_id, page->data_);
+  std::unique_lock<std::mutex> guard(latch_);
+  // If P is being read ahead, wait for that read rather than issuing a second one.
+  prefetch_done_cv_.wait(guard, [&] { return prefetch_in_flight_.count(page_id) == 0; });
+  // Another thread may have brought P in while we were waiting for the latch.
+  page = PinIfResident(page_id);
+  if (page != nullptr) {
     return page;
   }
+  // A deallocated page is not resident, and reading it in would hand out a page that NewPage may give to someone else.
+  // Readers that fetch a page id before validating it take nullptr as a sign to start over.
+  if (IsFreePage(page_id)) {
+    return nullptr;
+  }
 
-  // P exists
-  frame_id_t frame_id = page_table_[page_id];
-  Page *page = &pages_[frame_id];
-  ++page->pin_count_;
+  // P doesn't exist
+  frame_id_t frame_id;
+  if (!FindFreeFrame(&frame_id)) {
+    return nullptr;
+  }
   replacer_->Pin(frame_id);
+  ++num_misses_;
 
-  assert(page->pin_count_ > 0);
+  page = &pages_[frame_id];
+  page->page_id_ = page_id;
+  page->pin_count_ = 1;
+  page->is_dirty_ = false;
+  // Read the page content before publishing P in the page table, so hits never see a half-loaded frame.
+  WaitForWriteBack(page_id);
+  disk_manager_->ReadPage(page_id, page->data_);
 
+  PageTableShard &shard = GetShard(page_id);
+  std::unique_lock<std::shared_mutex> shard_guard(shard.latch_);
+  shard.table_.insert({page_id, frame_id});
   return page;
 }
 
@@ -197,24 +283,27 @@ bool BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) {
   // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
   // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
   std::lock_guard<std::mutex> guard(latch_);
-  // LOG_DEBUG("delete page %d", page_id);
-  if (page_table_.find(page_id) == page_table_.end()) {
+  // A read ahead of P that is still in flight must not publish it afterwards.
+  prefetch_in_flight_.erase(page_id);
+  PageTableShard &shard = GetShard(page_id);
+  std::unique_lock<std::shared_mutex> shard_guard(shard.latch_);
+  auto iter = shard.table_.find(page_id);
+  if (iter == shard.table_.end()) {
+    DeallocatePage(page_id);
     return true;
   }
-  frame_id_t frame_id = page_table_[page_id];
+  frame_id_t frame_id = iter->second;
   Page *page = &pages_[frame_id];
   if (page->GetPinCount() != 0) {
     LOG_DEBUG("delete fail, pin cnt:%u, page id:%u", page->GetPinCount(), page_id);
     return false;
   }
+  shard.table_.erase(iter);
+  shard_guard.unlock();
+  // The frame goes back to the free list, so it must no longer be a replacement candidate. Its contents are dead, so
+  // even a dirty page is not written back.
+  replacer_->Remove(frame_id);
   DeallocatePage(page_id);
-  page_table_.erase(page_id);
-  if (page->IsDirty()) {
-    disk_manager_->WritePage(page->GetPageId(), page->GetData());
-  }
-  // if (page_id < 3) {
-  // LOG_DEBUG("delete page:%d", page_id);
-  // }
   page->page_id_ = INVALID_PAGE_ID;
   page->is_dirty_ = false;
   page->ResetMemory();
@@ -223,51 +312,274 @@ bool BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) {
 }
 
 bool BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) {
-  std::lock_guard<std::mutex> guard(latch_);
-  if (page_table_.find(page_id) == page_table_.end()) {
+  PageTableShard &shard = GetShard(page_id);
+  std::shared_lock<std::shared_mutex> shard_guard(shard.latch_);
+  auto iter = shard.table_.find(page_id);
+  if (iter == shard.table_.end()) {
     LOG_DEBUG("unpin fail1. page id %u", page_id);
     return false;
   }
 
-  frame_id_t frame_id = page_table_[page_id];
+  frame_id_t frame_id = iter->second;
   Page *page = &pages_[frame_id];
-  if (page->GetPinCount() <= 0) {
-    LOG_DEBUG("Unpin fail2. PinCount:%d, page id %u", page->GetPinCount(), page_id);
-    return false;
-  }
-  // if (page_id < 3) {
-  // LOG_DEBUG("unpin page:%d, is_dirty:%d", page_id, is_dirty);
-  // }
 
   // Quite important!
-  // If the page is dirty last time, then we should keep it dirty.
-  if (!page->IsDirty()) {
-    page->is_dirty_ = is_dirty;
+  // If the page is dirty last time, then we should keep it dirty. The flag is set before the pin is released so that
+  // whoever evicts the page afterwards sees it.
+  if (is_dirty) {
+    page->is_dirty_ = true;
   }
-  --page->pin_count_;
 
-  if (page->pin_count_ == 0) {
+  int pin_count = page->pin_count_.load();
+  do {
+    if (pin_count <= 0) {
+      LOG_DEBUG("Unpin fail2. PinCount:%d, page id %u", pin_count, page_id);
+      return false;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count - 1));
+
+  if (pin_count == 1) {
     replacer_->Unpin(frame_id);
   }
-
-  // LOG_DEBUG("page id %u, pin cnt:%u", page->GetPageId(), page->GetPinCount());
-  // // if (page_id == 6) {
-  // //   LOG_DEBUG("pin cnt:%u", page->GetPinCount());
-  // // }
-  // for (size_t i = 0; i < pool_size_; ++i) {
-  //   LOG_DEBUG("page id %u, pin cnt %u", pages_[i].GetPageId(), pages_[i].GetPinCount());
-  // }
-  // std::cout << "\n";
   return true;
 }
 
+void BufferPoolManagerInstance::PrefetchPages(const std::vector<page_id_t> &page_ids) {
+  std::lock_guard<std::mutex> guard(prefetch_latch_);
+  prefetch_queue_.insert(prefetch_queue_.end(), page_ids.begin(), page_ids.end());
+  if (prefetch_thread_ == nullptr) {
+    prefetch_running_ = true;
+    prefetch_thread_ = new std::thread(&BufferPoolManagerInstance::RunPrefetcher, this);
+    return;
+  }
+  prefetch_cv_.notify_one();
+}
+
+void BufferPoolManagerInstance::RunPrefetcher() {
+  std::unique_lock<std::mutex> lock(prefetch_latch_);
+  while (true) {
+    prefetch_cv_.wait(lock, [&] { return !prefetch_running_ || !prefetch_queue_.empty(); });
+    if (!prefetch_running_) {
+      break;
+    }
+    std::vector<page_id_t> page_ids;
+    while (!prefetch_queue_.empty() && page_ids.size() < PREFETCH_BATCH_SIZE) {
+      page_ids.push_back(prefetch_queue_.front());
+      prefetch_queue_.pop_front();
+    }
+    lock.unlock();
+    PrefetchBatch(page_ids);
+    lock.lock();
+  }
+}
+
+void BufferPoolManagerInstance::PrefetchBatch(const std::vector<page_id_t> &page_ids) {
+  std::vector<DiskRequest> requests;
+  std::vector<frame_id_t> frame_ids;
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    for (page_id_t page_id : page_ids) {
+      // Read-ahead must not push the pages a scan is working on out of the pool, so only a quarter of the frames may be
+      // reserved for it at a time.
+      if (prefetch_in_flight_.size() >= std::max<size_t>(pool_size_ / 4, 1)) {
+        break;
+      }
+      // Pages that are not allocated, yet or any more, are skipped, or NewPage would find them mapped already.
+      if (page_id < 0 || page_id >= next_page_id_ || IsFreePage(page_id) || prefetch_in_flight_.count(page_id) != 0) {
+        continue;
+      }
+      {
+        PageTableShard &shard = GetShard(page_id);
+        std::shared_lock<std::shared_mutex> shard_guard(shard.latch_);
+        if (shard.table_.count(page_id) != 0) {
+          continue;
+        }
+      }
+      frame_id_t frame_id;
+      if (!FindFreeFrame(&frame_id)) {
+        break;
+      }
+      // The frame is in neither the page table, the free list nor the replacer, so nobody else can touch it. Its page
+      // id stays invalid until the read lands, which keeps FlushAllPages away from it.
+      pages_[frame_id].page_id_ = INVALID_PAGE_ID;
+      prefetch_in_flight_.insert(page_id);
+      requests.push_back(DiskRequest{false, page_id, pages_[frame_id].data_});
+      frame_ids.push_back(frame_id);
+    }
+  }
+  if (requests.empty()) {
+    return;
+  }
+
+  for (const DiskRequest &request : requests) {
+    WaitForWriteBack(request.page_id_);
+  }
+  disk_manager_->ExecuteRequests(requests.data(), requests.size());
+
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    for (size_t i = 0; i < requests.size(); ++i) {
+      page_id_t page_id = requests[i].page_id_;
+      frame_id_t frame_id = frame_ids[i];
+      if (prefetch_in_flight_.erase(page_id) == 0) {
+        // The page was deleted while it was being read.
+        free_list_.push_back(frame_id);
+        continue;
+      }
+      Page *page = &pages_[frame_id];
+      page->page_id_ = page_id;
+      page->pin_count_ = 0;
+      page->is_dirty_ = false;
+      // Make the frame evictable before publishing it, so a hit that pins it right away takes it out again.
+      replacer_->Unpin(frame_id);
+      PageTableShard &shard = GetShard(page_id);
+      std::unique_lock<std::shared_mutex> shard_guard(shard.latch_);
+      shard.table_.insert({page_id, frame_id});
+      ++num_prefetches_;
+    }
+  }
+  prefetch_done_cv_.notify_all();
+}
+
+void BufferPoolManagerInstance::StartBackgroundWriter(size_t num_clean_frames) {
+  std::lock_guard<std::mutex> guard(writer_latch_);
+  if (writer_thread_ != nullptr) {
+    return;
+  }
+  num_clean_frames_ = num_clean_frames;
+  writer_running_ = true;
+  writer_thread_ = new std::thread(&BufferPoolManagerInstance::RunBackgroundWriter, this);
+}
+
+void BufferPoolManagerInstance::StopBackgroundWriter() {
+  {
+    std::lock_guard<std::mutex> guard(writer_latch_);
+    if (writer_thread_ == nullptr) {
+      return;
+    }
+    writer_running_ = false;
+  }
+  writer_cv_.notify_one();
+  writer_thread_->join();
+  delete writer_thread_;
+  writer_thread_ = nullptr;
+}
+
+void BufferPoolManagerInstance::RunBackgroundWriter() {
+  std::unique_lock<std::mutex> lock(writer_latch_);
+  while (writer_running_) {
+    writer_cv_.wait_for(lock, background_writer_interval);
+    if (!writer_running_) {
+      break;
+    }
+    lock.unlock();
+    CleanFrames();
+    lock.lock();
+  }
+}
+
+void BufferPoolManagerInstance::CleanFrames() {
+  char buffer[PAGE_SIZE];
+  for (frame_id_t frame_id : replacer_->PeekVictims(num_clean_frames_)) {
+    page_id_t page_id;
+    {
+      std::lock_guard<std::mutex> guard(latch_);
+      Page *page = &pages_[frame_id];
+      page_id = page->GetPageId();
+      if (page_id == INVALID_PAGE_ID) {
+        continue;
+      }
+      // Holding the shard latch exclusively keeps hits away while the page is copied.
+      PageTableShard &shard = GetShard(page_id);
+      std::lock_guard<std::shared_mutex> shard_guard(shard.latch_);
+      if (page->GetPinCount() > 0 || !page->IsDirty()) {
+        continue;
+      }
+      memcpy(buffer, page->GetData(), PAGE_SIZE);
+      page->is_dirty_ = false;
+      std::lock_guard<std::mutex> writer_guard(writer_latch_);
+      write_back_page_id_ = page_id;
+    }
+    disk_manager_->WritePage(page_id, buffer);
+    {
+      std::lock_guard<std::mutex> writer_guard(writer_latch_);
+      write_back_page_id_ = INVALID_PAGE_ID;
+    }
+    write_back_cv_.notify_all();
+  }
+}
+
+void BufferPoolManagerInstance::WaitForWriteBack(page_id_t page_id) {
+  std::unique_lock<std::mutex> lock(writer_latch_);
+  write_back_cv_.wait(lock, [&] { return write_back_page_id_ != page_id; });
+}
+
 page_id_t BufferPoolManagerInstance::AllocatePage() {
+  if (free_page_list_.GetPageId() != INVALID_PAGE_ID) {
+    free_page_list_dirty_ = true;
+    if (!free_page_list_.IsEmpty()) {
+      page_id_t page_id = free_page_list_.Pop();
+      is_free_page_[page_id / num_instances_] = false;
+      return page_id;
+    }
+    // All the ids recorded on the head page have been reused, so the head page itself is next and the following list
+    // page takes its place.
+    page_id_t page_id = free_page_list_.GetPageId();
+    page_id_t next_page_id = free_page_list_.GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID) {
+      free_page_list_.Init(INVALID_PAGE_ID, INVALID_PAGE_ID);
+    } else {
+      disk_manager_->ReadPage(next_page_id, reinterpret_cast<char *>(&free_page_list_));
+      free_page_list_dirty_ = false;
+    }
+    is_free_page_[page_id / num_instances_] = false;
+    return page_id;
+  }
   const page_id_t next_page_id = next_page_id_;
   next_page_id_ += static_cast<page_id_t>(num_instances_);
   ValidatePageId(next_page_id);
   return next_page_id;
 }
 
+bool BufferPoolManagerInstance::IsFreePage(page_id_t page_id) const {
+  size_t index = page_id / num_instances_;
+  return index < is_free_page_.size() && is_free_page_[index];
+}
+
+void BufferPoolManagerInstance::DeallocatePage(page_id_t page_id) {
+  if (page_id < 0 || page_id >= next_page_id_) {
+    // Never allocated, so there is nothing to give back.
+    return;
+  }
+  ValidatePageId(page_id);
+  size_t index = page_id / num_instances_;
+  if (index >= is_free_page_.size()) {
+    is_free_page_.resize(index + 1);
+  } else if (is_free_page_[index]) {
+    // Already freed, and listing it twice would hand it out twice.
+    return;
+  }
+  is_free_page_[index] = true;
+  if (free_page_list_.GetPageId() == INVALID_PAGE_ID || free_page_list_.IsFull()) {
+    // The page itself becomes the new head of the list; the old head has to go to disk before it is only reachable
+    // from there.
+    FlushFreePageList();
+    free_page_list_.Init(page_id, free_page_list_.GetPageId());
+  } else {
+    free_page_list_.Push(page_id);
+  }
+  free_page_list_dirty_ = true;
+}
+
+void BufferPoolManagerInstance::FlushFreePageList() {
+  if (!free_page_list_dirty_ || free_page_list_.GetPageId() == INVALID_PAGE_ID) {
+    return;
+  }
+  WaitForWriteBack(free_page_list_.GetPageId());
+  disk_manager_->WritePage(free_page_list_.GetPageId(), reinterpret_cast<char *>(&free_page_list_));
+  free_page_list_dirty_ = false;
+}
+
 void BufferPoolManagerInstance::ValidatePageId(const page_id_t page_id) const {
   assert(page_id % num_instances_ == instance_index_);  // allocated pages mod back to this BPI
 }
@@ -14,16 +14,59 @@
 
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {}
+ClockReplacer::ClockReplacer(size_t num_pages) : frames_(num_pages) {}
 
 ClockReplacer::~ClockReplacer() = default;
 
-bool ClockReplacer::Victim(frame_id_t *frame_id) { return false; }
+bool ClockReplacer::Victim(frame_id_t *frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
 
-void ClockReplacer::Pin(frame_id_t frame_id) {}
+  // Two full turns clear every reference bit, so a third one finding nothing means the replacer is empty.
+  for (size_t step = 0; step < 3 * frames_.size(); ++step) {
+    auto &state = frames_[hand_];
+    auto current = static_cast<frame_id_t>(hand_);
+    hand_ = (hand_ + 1) % frames_.size();
 
-void ClockReplacer::Unpin(frame_id_t frame_id) {}
+    uint8_t expected = state.load(std::memory_order_relaxed);
+    if (expected == REFERENCED) {
+      // Give the frame a second chance. If this races with Pin or Unpin, they win.
+      state.compare_exchange_strong(expected, UNREFERENCED, std::memory_order_relaxed);
+    } else if (expected == UNREFERENCED && state.compare_exchange_strong(expected, ABSENT, std::memory_order_relaxed)) {
+      *frame_id = current;
+      return true;
+    }
+  }
+  return false;
+}
 
-size_t ClockReplacer::Size() { return 0; }
+void ClockReplacer::Pin(frame_id_t frame_id) { frames_[frame_id].store(ABSENT, std::memory_order_relaxed); }
+
+void ClockReplacer::Unpin(frame_id_t frame_id) { frames_[frame_id].store(REFERENCED, std::memory_order_relaxed); }
+
+size_t ClockReplacer::Size() {
+  size_t size = 0;
+  for (auto &state : frames_) {
+    if (state.load(std::memory_order_relaxed) != ABSENT) {
+      ++size;
+    }
+  }
+  return size;
+}
+
+std::vector<frame_id_t> ClockReplacer::PeekVictims(size_t max_frames) {
+  std::lock_guard<std::mutex> guard(latch_);
+
+  // Frames whose reference bit is clear go first, in hand order, then the referenced ones.
+  std::vector<frame_id_t> frames;
+  for (uint8_t wanted : {UNREFERENCED, REFERENCED}) {
+    for (size_t step = 0; step < frames_.size() && frames.size() < max_frames; ++step) {
+      size_t index = (hand_ + step) % frames_.size();
+      if (frames_[index].load(std::memory_order_relaxed) == wanted) {
+        frames.push_back(static_cast<frame_id_t>(index));
+      }
+    }
+  }
+  return frames;
+}
 
 }  // namespace bustub
@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.cpp
+//
+// Identification: src/buffer/frame_arena.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+
+size_t RoundUp(size_t size, size_t alignment) { return (size + alignment - 1) / alignment * alignment; }
+
+}  // namespace
+
+FrameArena::FrameArena(size_t num_frames, bool huge_pages, int numa_node) {
+  size_t data_size = std::max<size_t>(num_frames, 1) * PAGE_SIZE;
+  if (huge_pages) {
+    size_ = RoundUp(data_size, HUGE_PAGE_SIZE);
+    void *mem = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (mem != MAP_FAILED) {
+      data_ = static_cast<char *>(mem);
+      huge_page_mode_ = HugePageMode::HUGETLB;
+    }
+  }
+
+  if (data_ == nullptr) {
+    // No huge pages are reserved. Map regular pages, with one huge page extra so that the region can start on a huge
+    // page boundary, which transparent huge pages need.
+    size_ = huge_pages ? RoundUp(data_size, HUGE_PAGE_SIZE) : data_size;
+    size_t map_size = huge_pages ? size_ + HUGE_PAGE_SIZE : size_;
+    void *mem = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot map the buffer pool frames");
+    }
+    data_ = static_cast<char *>(mem);
+    if (huge_pages) {
+      auto start = reinterpret_cast<uintptr_t>(mem);
+      size_t head = RoundUp(start, HUGE_PAGE_SIZE) - start;
+      if (head > 0) {
+        munmap(mem, head);
+      }
+      if (HUGE_PAGE_SIZE - head > 0) {
+        munmap(data_ + head + size_, HUGE_PAGE_SIZE - head);
+      }
+      data_ += head;
+      if (madvise(data_, size_, MADV_HUGEPAGE) == 0) {
+        huge_page_mode_ = HugePageMode::TRANSPARENT;
+      }
+    } else {
+      // Keep the OS from backing the region with transparent huge pages anyway, so that turning them off means it.
+      madvise(data_, size_, MADV_NOHUGEPAGE);
+    }
+  }
+
+  // The region has not been touched yet, so setting the policy now decides where all of its pages end up.
+  if (numa_node >= 0 && static_cast<size_t>(numa_node) < GetNumNumaNodes() && GetNumNumaNodes() > 1) {
+    uint64_t node_mask = 1ULL << numa_node;
+    if (syscall(SYS_mbind, data_, size_, MPOL_PREFERRED, &node_mask, sizeof(node_mask) * 8, 0) == 0) {
+      numa_node_ = numa_node;
+    }
+  }
+}
+
+FrameArena::~FrameArena() { munmap(data_, size_); }
+
+size_t FrameArena::GetNumNumaNodes() {
+  static const size_t num_numa_nodes = [] {
+    // The file lists the online nodes as ranges, e.g. "0-3" or "0,2-3".
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string nodes;
+    if (!(online >> nodes) || nodes.empty()) {
+      return static_cast<size_t>(1);
+    }
+    size_t last = nodes.find_last_of(",-");
+    size_t max_node = std::stoul(last == std::string::npos ? nodes : nodes.substr(last + 1));
+    return std::min<size_t>(max_node + 1, 64);
+  }();
+  return num_numa_nodes;
+}
+
+}  // namespace bustub
@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.cpp
+//
+// Identification: src/buffer/lru_k_replacer.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/lru_k_replacer.h"
+
+namespace bustub {
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k) : k_(k), frames_(num_pages) {}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+
+  auto *queue = history_queue_.empty() ? &cache_queue_ : &history_queue_;
+  if (queue->empty()) {
+    return false;
+  }
+  *frame_id = queue->begin()->second;
+  queue->erase(queue->begin());
+  frames_[*frame_id].evictable_ = false;
+  frames_[*frame_id].history_.clear();
+  return true;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+
+  FrameInfo *frame_info = &frames_[frame_id];
+  if (frame_info->evictable_) {
+    QueueOf(*frame_info)->erase({frame_info->history_.front(), frame_id});
+    frame_info->evictable_ = false;
+  }
+  RecordAccess(frame_info);
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+
+  FrameInfo *frame_info = &frames_[frame_id];
+  if (frame_info->evictable_) {
+    return;
+  }
+  // A frame that was never pinned still needs a position in the queues.
+  if (frame_info->history_.empty()) {
+    RecordAccess(frame_info);
+  }
+  frame_info->evictable_ = true;
+  QueueOf(*frame_info)->insert({frame_info->history_.front(), frame_id});
+}
+
+void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+
+  FrameInfo *frame_info = &frames_[frame_id];
+  // A racing Unpin may have made the frame evictable, and its queue position depends on its history.
+  if (frame_info->evictable_) {
+    QueueOf(*frame_info)->erase({frame_info->history_.front(), frame_id});
+  }
+  RecordAccess(frame_info);
+  if (frame_info->evictable_) {
+    QueueOf(*frame_info)->insert({frame_info->history_.front(), frame_id});
+  }
+}
+
+void LRUKReplacer::Remove(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+
+  FrameInfo *frame_info = &frames_[frame_id];
+  if (frame_info->evictable_) {
+    QueueOf(*frame_info)->erase({frame_info->history_.front(), frame_id});
+    frame_info->evictable_ = false;
+  }
+  frame_info->history_.clear();
+}
+
+size_t LRUKReplacer::Size() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return history_queue_.size() + cache_queue_.size();
+}
+
+std::vector<frame_id_t> LRUKReplacer::PeekVictims(size_t max_frames) {
+  std::lock_guard<std::mutex> guard(latch_);
+
+  std::vector<frame_id_t> frames;
+  for (auto *queue : {&history_queue_, &cache_queue_}) {
+    for (auto iter = queue->begin(); iter != queue->end() && frames.size() < max_frames; ++iter) {
+      frames.push_back(iter->second);
+    }
+  }
+  return frames;
+}
+
+void LRUKReplacer::RecordAccess(FrameInfo *frame_info) {
+  frame_info->history_.push_back(current_timestamp_++);
+  if (frame_info->history_.size() > k_) {
+    frame_info->history_.pop_front();
+  }
+}
+
+std::set<std::pair<uint64_t, frame_id_t>> *LRUKReplacer::QueueOf(const FrameInfo &frame_info) {
+  return frame_info.history_.size() < k_ ? &history_queue_ : &cache_queue_;
+}
+
+}  // namespace bustub
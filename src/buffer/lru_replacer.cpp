@@ -14,90 +14,75 @@
 
 namespace bustub {
 
-LRUReplacer::LRUReplacer(size_t num_pages) : num_pages_(num_pages) {
-  head_ = new FrameInfo(-1);
-  tail_ = new FrameInfo(-1);
-  head_->next_ = tail_;
-  tail_->prev_ = head_;
+LRUReplacer::LRUReplacer(size_t num_pages)
+    : prev_(num_pages + 1, NOT_IN_LIST), next_(num_pages + 1, NOT_IN_LIST), num_pages_(num_pages) {
+  auto sentinel = static_cast<frame_id_t>(num_pages_);
+  prev_[sentinel] = sentinel;
+  next_[sentinel] = sentinel;
 }
 
-LRUReplacer::~LRUReplacer() {
-  FrameInfo *frame_info = head_;
-  FrameInfo *dummy;
-  while (frame_info != nullptr) {
-    dummy = frame_info;
-    frame_info = frame_info->next_;
-    delete dummy;
-  }
-}
+LRUReplacer::~LRUReplacer() = default;
 
 bool LRUReplacer::Victim(frame_id_t *frame_id) {
   std::lock_guard<std::mutex> guard(latch_);
 
-  if (frame_holders_.empty()) {
+  if (size_ == 0) {
     return false;
   }
-  FrameInfo *frame_info = head_->next_;
-  *frame_id = frame_info->frame_id_;
   // delete the lru page;
-  frame_holders_.erase(frame_info->frame_id_);
-  head_->next_ = head_->next_->next_;
-  head_->next_->prev_ = head_;
-  delete frame_info;
+  *frame_id = next_[num_pages_];
+  Unlink(*frame_id);
   return true;
 }
 
 void LRUReplacer::Pin(frame_id_t frame_id) {
   std::lock_guard<std::mutex> guard(latch_);
 
-  if (frame_holders_.find(frame_id) == frame_holders_.end()) {
+  if (prev_[frame_id] == NOT_IN_LIST) {
     return;
   }
-
-  FrameInfo *frame_info = frame_holders_[frame_id];
-  frame_holders_.erase(frame_id);
-  frame_info->prev_->next_ = frame_info->next_;
-  frame_info->next_->prev_ = frame_info->prev_;
-  // release the frame_info;
-  delete frame_info;
+  Unlink(frame_id);
 }
 
 void LRUReplacer::Unpin(frame_id_t frame_id) {
   std::lock_guard<std::mutex> guard(latch_);
 
-  if (frame_holders_.find(frame_id) == frame_holders_.end()) {
-    FrameInfo *frame_info = new FrameInfo(frame_id);
-    frame_holders_.insert({frame_id, frame_info});
-    frame_info->prev_ = tail_->prev_;
-    frame_info->next_ = tail_;
-    tail_->prev_->next_ = frame_info;
-    tail_->prev_ = frame_info;
-
-    if (frame_holders_.size() > num_pages_) {
-      // delete the lru page;
-      frame_info = head_->next_;
-      frame_holders_.erase(frame_info->frame_id_);
-      head_->next_ = head_->next_->next_;
-      head_->next_->prev_ = head_;
-      delete frame_info;
-    }
+  if (prev_[frame_id] != NOT_IN_LIST) {
+    return;
   }
-  //  } else {
-  //    FrameInfo* frame_info = frame_holders_[frame_id];
-  //    Modify(frame_info);
-  //  }
+  // Append at the most recently used end.
+  auto sentinel = static_cast<frame_id_t>(num_pages_);
+  frame_id_t tail = prev_[sentinel];
+  prev_[frame_id] = tail;
+  next_[frame_id] = sentinel;
+  next_[tail] = frame_id;
+  prev_[sentinel] = frame_id;
+  ++size_;
+}
+
+size_t LRUReplacer::Size() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return size_;
 }
 
-size_t LRUReplacer::Size() { return frame_holders_.size(); }
+std::vector<frame_id_t> LRUReplacer::PeekVictims(size_t max_frames) {
+  std::lock_guard<std::mutex> guard(latch_);
 
-// void LRUReplacer::Modify(LRUReplacer::FrameInfo *frame_info) {
-//   frame_info->prev_->next_ = frame_info->next_;
-//   frame_info->next_->prev_ = frame_info->prev_;
-//
-//   frame_info->prev_ = tail_->prev_;
-//   frame_info->next_ = tail_;
-//   tail_->prev_->next_ = frame_info;
-//   tail_->prev_ = frame_info;
-// }
+  std::vector<frame_id_t> frames;
+  auto sentinel = static_cast<frame_id_t>(num_pages_);
+  for (frame_id_t frame_id = next_[sentinel]; frame_id != sentinel && frames.size() < max_frames;
+       frame_id = next_[frame_id]) {
+    frames.push_back(frame_id);
+  }
+  return frames;
+}
+
+void LRUReplacer::Unlink(frame_id_t frame_id) {
+  next_[prev_[frame_id]] = next_[frame_id];
+  prev_[next_[frame_id]] = prev_[frame_id];
+  prev_[frame_id] = NOT_IN_LIST;
+  next_[frame_id] = NOT_IN_LIST;
+  --size_;
+}
 
 }  // namespace bustub
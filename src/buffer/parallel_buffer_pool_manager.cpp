@@ -12,14 +12,30 @@
 
 #include "buffer/parallel_buffer_pool_manager.h"
 
+#include <atomic>
+
 namespace bustub {
 
+namespace {
+
+/** Hands every thread its own slot the first time it creates a page, which picks its home instance. */
+std::atomic<size_t> next_thread_slot = 0;
+
+size_t GetThreadSlot() {
+  thread_local size_t thread_slot = next_thread_slot.fetch_add(1, std::memory_order_relaxed);
+  return thread_slot;
+}
+
+}  // namespace
+
 ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
-                                                     LogManager *log_manager) {
+                                                     LogManager *log_manager, ReplacerType replacer_type) {
   // Allocate and create individual BufferPoolManagerInstances
+  size_t num_numa_nodes = FrameArena::GetNumNumaNodes();
   for (size_t i = 0; i < num_instances; ++i) {
-    buffer_pool_manager_instances_.push_back(
-        new BufferPoolManagerInstance(pool_size, num_instances, i, disk_manager, log_manager));
+    int numa_node = num_numa_nodes > 1 ? static_cast<int>(i % num_numa_nodes) : -1;
+    buffer_pool_manager_instances_.push_back(new BufferPoolManagerInstance(pool_size, num_instances, i, disk_manager,
+                                                                           log_manager, replacer_type, numa_node));
   }
 }
 
@@ -35,41 +51,91 @@ size_t ParallelBufferPoolManager::GetPoolSize() {
   return buffer_pool_manager_instances_[0]->GetPoolSize() * buffer_pool_manager_instances_.size();
 }
 
-BufferPoolManager *ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) {
+size_t ParallelBufferPoolManager::GetNumCleanEvictions() {
+  size_t num_clean_evictions = 0;
+  for (BufferPoolManagerInstance *bmi : buffer_pool_manager_instances_) {
+    num_clean_evictions += bmi->GetNumCleanEvictions();
+  }
+  return num_clean_evictions;
+}
+
+size_t ParallelBufferPoolManager::GetNumDirtyEvictions() {
+  size_t num_dirty_evictions = 0;
+  for (BufferPoolManagerInstance *bmi : buffer_pool_manager_instances_) {
+    num_dirty_evictions += bmi->GetNumDirtyEvictions();
+  }
+  return num_dirty_evictions;
+}
+
+std::vector<BufferPoolStats> ParallelBufferPoolManager::GetInstanceStats() {
+  std::vector<BufferPoolStats> stats;
+  stats.reserve(buffer_pool_manager_instances_.size());
+  for (BufferPoolManagerInstance *bmi : buffer_pool_manager_instances_) {
+    stats.push_back(bmi->GetStats());
+  }
+  return stats;
+}
+
+void ParallelBufferPoolManager::StartBackgroundWriter(size_t num_clean_frames) {
+  for (BufferPoolManagerInstance *bmi : buffer_pool_manager_instances_) {
+    bmi->StartBackgroundWriter(num_clean_frames);
+  }
+}
+
+void ParallelBufferPoolManager::StopBackgroundWriter() {
+  for (BufferPoolManagerInstance *bmi : buffer_pool_manager_instances_) {
+    bmi->StopBackgroundWriter();
+  }
+}
+
+void ParallelBufferPoolManager::PrefetchPages(const std::vector<page_id_t> &page_ids) {
+  std::vector<std::vector<page_id_t>> instance_page_ids(buffer_pool_manager_instances_.size());
+  for (page_id_t page_id : page_ids) {
+    instance_page_ids[page_id % buffer_pool_manager_instances_.size()].push_back(page_id);
+  }
+  for (size_t i = 0; i < buffer_pool_manager_instances_.size(); ++i) {
+    if (!instance_page_ids[i].empty()) {
+      buffer_pool_manager_instances_[i]->PrefetchPages(instance_page_ids[i]);
+    }
+  }
+}
+
+BufferPoolManagerInstance *ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) {
   // Get BufferPoolManager responsible for handling given page id. You can use this method in your other methods.
   return buffer_pool_manager_instances_[page_id % buffer_pool_manager_instances_.size()];
 }
 
 Page *ParallelBufferPoolManager::FetchPgImp(page_id_t page_id) {
   // Fetch page for page_id from responsible BufferPoolManagerInstance
-  BufferPoolManagerInstance *bmi = dynamic_cast<BufferPoolManagerInstance *>(GetBufferPoolManager(page_id));
+  BufferPoolManagerInstance *bmi = GetBufferPoolManager(page_id);
   return bmi->FetchPage(page_id);
 }
 
 bool ParallelBufferPoolManager::UnpinPgImp(page_id_t page_id, bool is_dirty) {
   // Unpin page_id from responsible BufferPoolManagerInstance
-  BufferPoolManagerInstance *bmi = dynamic_cast<BufferPoolManagerInstance *>(GetBufferPoolManager(page_id));
+  BufferPoolManagerInstance *bmi = GetBufferPoolManager(page_id);
   return bmi->UnpinPage(page_id, is_dirty);
 }
 
 bool ParallelBufferPoolManager::FlushPgImp(page_id_t page_id) {
   // Flush page_id from responsible BufferPoolManagerInstance
-  BufferPoolManagerInstance *bmi = dynamic_cast<BufferPoolManagerInstance *>(GetBufferPoolManager(page_id));
+  BufferPoolManagerInstance *bmi = GetBufferPoolManager(page_id);
   return bmi->FlushPage(page_id);
 }
 
 Page *ParallelBufferPoolManager::NewPgImp(page_id_t *page_id) {
-  // create new page. We will request page allocation in a round-robin manner from the underlying
-  // BufferPoolManagerInstances
-  // 1.   From a starting index of the BPMIs, call NewPageImpl until either 1) success and return 2) looped around to
-  // starting index and return nullptr
-  // 2.   Bump the starting index (mod number of instances) to start search at a different BPMI each time this function
-  // is called
-  size_t old_starting_index = starting_index_;
-  starting_index_ = (starting_index_ + 1) % buffer_pool_manager_instances_.size();
-  for (size_t i = old_starting_index;
-       i == old_starting_index || i % buffer_pool_manager_instances_.size() != old_starting_index; ++i) {
-    Page *page = buffer_pool_manager_instances_[i % buffer_pool_manager_instances_.size()]->NewPage(page_id);
+  // Take a free frame from the home instance of this thread, or else from the first other instance that has one. Only
+  // when no instance has a free frame left is a page evicted, again starting at the home instance.
+  size_t num_instances = buffer_pool_manager_instances_.size();
+  size_t home_index = GetThreadSlot() % num_instances;
+  for (size_t i = 0; i < num_instances; ++i) {
+    Page *page = buffer_pool_manager_instances_[(home_index + i) % num_instances]->NewPageWithoutEviction(page_id);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  for (size_t i = 0; i < num_instances; ++i) {
+    Page *page = buffer_pool_manager_instances_[(home_index + i) % num_instances]->NewPage(page_id);
     if (page != nullptr) {
       return page;
     }
@@ -79,7 +145,7 @@ Page *ParallelBufferPoolManager::NewPgImp(page_id_t *page_id) {
 
 bool ParallelBufferPoolManager::DeletePgImp(page_id_t page_id) {
   // Delete page_id from responsible BufferPoolManagerInstance
-  BufferPoolManagerInstance *bmi = dynamic_cast<BufferPoolManagerInstance *>(GetBufferPoolManager(page_id));
+  BufferPoolManagerInstance *bmi = GetBufferPoolManager(page_id);
   return bmi->DeletePage(page_id);
 }
 
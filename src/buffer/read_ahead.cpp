@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// read_ahead.cpp
+//
+// Identification: src/buffer/read_ahead.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/read_ahead.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace bustub {
+
+ReadAhead::ReadAhead(BufferPoolManager *buffer_pool_manager, FollowingPagesFn following_pages_fn, size_t window_size)
+    : buffer_pool_manager_(buffer_pool_manager), following_pages_fn_(following_pages_fn), window_size_(window_size) {}
+
+void ReadAhead::OnPage(page_id_t page_id) {
+  if (window_size_ == 0 || page_id == current_page_id_) {
+    return;
+  }
+  current_page_id_ = page_id;
+  if (num_ahead_ > 0) {
+    --num_ahead_;
+  }
+  if (num_ahead_ == 0) {
+    // The scan has just started, or caught up with the window: start a new one right behind the current page.
+    num_ahead_ = Extend(page_id, window_size_);
+  } else if (num_ahead_ <= window_size_ / 2 && last_page_id_ != INVALID_PAGE_ID) {
+    // The last page of the window was requested half a window ago, so looking at it should not have to wait for disk.
+    num_ahead_ += Extend(last_page_id_, window_size_ - num_ahead_);
+  }
+}
+
+size_t ReadAhead::Extend(page_id_t page_id, size_t max_pages) {
+  std::vector<page_id_t> page_ids(max_pages);
+  size_t num_pages = 0;
+  if (page_id != stop_page_id_) {
+    num_pages = following_pages_fn_(buffer_pool_manager_, page_id, page_ids.data(), max_pages);
+    auto stop = std::find(page_ids.begin(), page_ids.begin() + num_pages, stop_page_id_);
+    num_pages = std::min<size_t>(num_pages, stop - page_ids.begin() + 1);
+  }
+  if (num_pages == 0) {
+    last_page_id_ = INVALID_PAGE_ID;
+    return 0;
+  }
+  page_ids.resize(num_pages);
+  buffer_pool_manager_->PrefetchPages(page_ids);
+  last_page_id_ = page_ids.back();
+  return num_pages;
+}
+
+}  // namespace bustub
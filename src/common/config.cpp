@@ -20,4 +20,14 @@ std::chrono::duration<int64_t> log_timeout = std::chrono::seconds(1);
 
 std::chrono::milliseconds cycle_detection_interval = std::chrono::milliseconds(50);
 
+std::chrono::milliseconds background_writer_interval = std::chrono::milliseconds(10);
+
+std::chrono::milliseconds btree_compaction_interval = std::chrono::milliseconds(100);
+
+size_t scan_read_ahead_pages = 8;
+
+size_t table_scan_read_ahead_pages = 0;
+
+bool buffer_pool_huge_pages = true;
+
 }  // namespace bustub
@@ -11,9 +11,11 @@
 //===----------------------------------------------------------------------===//
 
 #include <sys/types.h>
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
 #include <string>
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 
@@ -35,6 +37,7 @@ HASH_TABLE_TYPE::ExtendibleHashTable(const std::string &name, BufferPoolManager
                                      const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
     : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
   //  implement me!
+  hash_fn_.SetKeyLength(comparator_.KeyLength());
   // allocate a directory page
   buffer_pool_manager_->NewPage(&directory_page_id_);
   assert(buffer_pool_manager_->UnpinPage(directory_page_id_, true));
@@ -67,7 +70,7 @@ HASH_TABLE_TYPE::~ExtendibleHashTable() = default;
  * HELPERS
  *****************************************************************************/
 /**
- * Hash - simple helper to downcast MurmurHash's 64-bit hash to 32-bit
+ * Hash - simple helper to downcast the hash function's 64-bit hash to 32-bit
  * for extendible hashing.
  *
  * @param key the key to hash
@@ -112,33 +115,63 @@ HASH_TABLE_BUCKET_TYPE *HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_i
   return bucket_page;
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+page_id_t HASH_TABLE_TYPE::ReadBucketPageId(Page *dir_raw_page, uint32_t hash) {
+  auto dir_page = reinterpret_cast<HashTableDirectoryPage *>(dir_raw_page->GetData());
+  while (true) {
+    uint64_t version = dir_raw_page->ReadVersion();
+    // the global depth mask keeps the index inside the directory even if the read overlaps a change
+    page_id_t page_id = dir_page->GetBucketPageId(hash & dir_page->GetGlobalDepthMask());
+    if (dir_raw_page->ValidateVersion(version)) {
+      return page_id;
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *HASH_TABLE_TYPE::LatchBucketPage(Page *dir_raw_page, uint32_t hash, bool exclusive) {
+  while (true) {
+    page_id_t page_id = ReadBucketPageId(dir_raw_page, hash);
+    Page *page = buffer_pool_manager_->FetchPage(page_id);
+    if (page == nullptr) {
+      // the bucket was merged away and deleted after its id was read
+      continue;
+    }
+    if (exclusive) {
+      page->WLatch();
+    } else {
+      page->RLatch();
+    }
+    if (ReadBucketPageId(dir_raw_page, hash) == page_id) {
+      return page;
+    }
+    // the bucket was split or merged before it was latched, so the key may live elsewhere now
+    if (exclusive) {
+      page->WUnlatch();
+    } else {
+      page->RUnlatch();
+    }
+    assert(buffer_pool_manager_->UnpinPage(page_id, false));
+  }
+}
+
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
-  table_latch_.RLock();
+  uint32_t hash = Hash(key);
   // get the directory page
-  auto dir_page = FetchDirectoryPage();
+  Page *dir_raw_page = buffer_pool_manager_->FetchPage(directory_page_id_);
   // get the bucket page
-  page_id_t page_id = KeyToPageId(key, dir_page);
-  auto bucket_page = FetchBucketPage(page_id);
-  auto page = reinterpret_cast<Page *>(bucket_page);
-  page->RLatch();
+  Page *page = LatchBucketPage(dir_raw_page, hash, false);
+  auto bucket_page = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
 
   bool res = bucket_page->GetValue(key, comparator_, result);
 
-  if (!res) {
-    // LOG_DEBUG("get value fail");
-    bucket_page->PrintBucket();
-    // dir_page->PrintDirectory();
-  }
   page->RUnlatch();
-
-  assert(buffer_pool_manager_->UnpinPage(page_id, false));
+  assert(buffer_pool_manager_->UnpinPage(page->GetPageId(), false));
   assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false));
-
-  table_latch_.RUnlock();
   return res;
 }
 
@@ -147,101 +180,77 @@ bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  table_latch_.RLock();
-
+  uint32_t hash = Hash(key);
   // get the directory page
-  auto dir_page = FetchDirectoryPage();
-  page_id_t page_id = KeyToPageId(key, dir_page);
-  // get the bucket page
-  auto bucket_page = FetchBucketPage(page_id);
-
-  auto page = reinterpret_cast<Page *>(bucket_page);
-
-  page->WLatch();
-  if (bucket_page->IsFull()) {
-    // The bucket is full,
-    // then we should try to split a bucket and insert again.
-    // we should release the rlock(it may be unsafe?(not sure))
-    page->WUnlatch();
-
-    assert(buffer_pool_manager_->UnpinPage(page_id, false));
-    assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false));
-    table_latch_.RUnlock();
-    return SplitInsert(transaction, key, value);
-  }
+  Page *dir_raw_page = buffer_pool_manager_->FetchPage(directory_page_id_);
+
+  bool res;
+  bool dir_dirty = false;
+  while (true) {
+    // get the bucket page
+    Page *page = LatchBucketPage(dir_raw_page, hash, true);
+    page_id_t page_id = page->GetPageId();
+    auto bucket_page = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+
+    if (!bucket_page->IsFull()) {
+      // false means duplicate kv
+      res = bucket_page->Insert(key, value, comparator_);
+      page->WUnlatch();
+      assert(buffer_pool_manager_->UnpinPage(page_id, res));
+      break;
+    }
 
-  if (!bucket_page->Insert(key, value, comparator_)) {
-    // if the bucket isn't full which means duplicate kv
-    // LOG_DEBUG("duplicate kv");
+    // The bucket is full, then we should split it and insert again.
+    // All the kvs may stay in the same half, so the bucket may have to split more than once.
+    bool split = SplitBucket(dir_raw_page, page, hash);
+    dir_dirty = dir_dirty || split;
     page->WUnlatch();
-
-    assert(buffer_pool_manager_->UnpinPage(page_id, false));
-    assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false));
-    LOG_DEBUG("insert fail, duplicate kv");
-    table_latch_.RUnlock();
-    return false;
+    assert(buffer_pool_manager_->UnpinPage(page_id, split));
+    if (!split) {
+      LOG_DEBUG("insert fail, bucket can't split");
+      res = false;
+      break;
+    }
   }
 
-  // LOG_DEBUG("insert a kv without spliting");
-  page->WUnlatch();
-  assert(buffer_pool_manager_->UnpinPage(page_id, true));
-  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false));
-  table_latch_.RUnlock();
-  return true;
+  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, dir_dirty));
+  return res;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-bool HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  table_latch_.WLock();
-  // get the directory page
-  auto dir_page = FetchDirectoryPage();
-  page_id_t bucket_page_id = KeyToPageId(key, dir_page);
-  // get the bucket page
-  auto bucket_page = FetchBucketPage(bucket_page_id);
-  // get the bucket index
-  uint32_t dir_index = KeyToDirectoryIndex(key, dir_page);
-  // LOG_DEBUG("split insert, dir_index: %u", dir_index);
-
-  // // get the unique index that identifies the bucket page
-  // uint32_t local_index = dir_index & dir_page->GetLocalDepthMask(dir_index);
-  // // get the local depth
-  // uint32_t local_depth = dir_page->GetLocalDepth(dir_index);
-
-  // maybe there is another thread that modified the bucket page,
-  // so we should check again
-  if (!bucket_page->IsFull()) {
-    // other thread has split the page, so just insert again
-    assert(buffer_pool_manager_->UnpinPage(directory_page_id_, true));
-    assert(buffer_pool_manager_->UnpinPage(bucket_page_id, false));
-
-    table_latch_.WUnlock();
+bool HASH_TABLE_TYPE::SplitBucket(Page *dir_raw_page, Page *bucket_raw_page, uint32_t hash) {
+  auto dir_page = reinterpret_cast<HashTableDirectoryPage *>(dir_raw_page->GetData());
+  page_id_t bucket_page_id = bucket_raw_page->GetPageId();
 
-    return Insert(transaction, key, value);
-  }
-
-  if (dir_page->GetLocalDepth(dir_index) == 32) {
+  dir_raw_page->WLatch();
+  // get the bucket index
+  uint32_t dir_index = hash & dir_page->GetGlobalDepthMask();
+  uint32_t local_depth = dir_page->GetLocalDepth(dir_index);
+  if (local_depth == 32 ||
+      (local_depth == dir_page->GetGlobalDepth() && dir_page->Size() * 2 > DIRECTORY_ARRAY_SIZE)) {
     // cannot increase local depth anymore
-    LOG_DEBUG("insert fail, max ld");
-    assert(buffer_pool_manager_->UnpinPage(bucket_page_id, false));
-    assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false));
-    table_latch_.WUnlock();
+    LOG_DEBUG("split fail, max ld");
+    dir_raw_page->WUnlatch();
     return false;
   }
 
   // allocate a new page for a new bucket
   page_id_t new_page_id;
-  buffer_pool_manager_->NewPage(&new_page_id);
-  assert(buffer_pool_manager_->UnpinPage(new_page_id, true));
-  auto new_bucket_page = FetchBucketPage(new_page_id);
+  Page *new_raw_page = buffer_pool_manager_->NewPage(&new_page_id);
+  if (new_raw_page == nullptr) {
+    dir_raw_page->WUnlatch();
+    return false;
+  }
+  // no other thread can reach the new bucket before the directory points to it, so this never waits
+  new_raw_page->WLatch();
 
-  if (dir_page->GetGlobalDepth() == dir_page->GetLocalDepth(dir_index)) {
+  if (dir_page->GetGlobalDepth() == local_depth) {
     // i == i_j
     for (size_t i = 0; i < dir_page->Size(); ++i) {
       // e.g. i = 01, GlobalDepth = 2, then new_index = 101(old_index = 001)
       uint32_t new_index = i | (1 << dir_page->GetGlobalDepth());
       // let the new index point to the same bucket
-      page_id_t page_id = dir_page->GetBucketPageId(i);
-      dir_page->SetBucketPageId(new_index, page_id);
+      dir_page->SetBucketPageId(new_index, dir_page->GetBucketPageId(i));
       // let the new index's local depth equal to i's
       dir_page->SetLocalDepth(new_index, dir_page->GetLocalDepth(i));
     }
@@ -252,7 +261,6 @@ bool HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key,
   // update all the pointers that refer to the old full page
   for (size_t i = 0; i < dir_page->Size(); ++i) {
     if (dir_page->GetBucketPageId(i) == bucket_page_id) {
-      // if (dir_page->GetLocalDepth(i) == local_depth && (i & dir_page->GetLocalDepthMask(i)) == local_index) {
       // this index points to the same old bucket
       dir_page->IncrLocalDepth(i);
       if (i & dir_page->GetLocalHighBit(i)) {
@@ -261,100 +269,185 @@ bool HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key,
       }
     }
   }
+  uint32_t local_high_bit = dir_page->GetLocalHighBit(hash & dir_page->GetGlobalDepthMask());
+  dir_raw_page->WUnlatch();
 
   // rehash all the kvs in the old page and decide whether they should
   // be put into the old or new bucket.
-  RehashKvs(bucket_page, dir_page, new_bucket_page);
-  // for (size_t i = 0; i < BUCKET_ARRAY_SIZE; ++i) {
-  //   KeyType key = bucket_page->KeyAt(i);
-  //   // if (comparator_(key, {}) == 0) {
-  //   //   // tombstone or just nothing
-  //   //   continue;
-  //   // }
-  //   uint32_t key_index = KeyToDirectoryIndex(key, dir_page);
-  //   if ((key_index & dir_page->GetLocalDepthMask(key_index)) != local_index) {
-  //     // this key's index is different from the old index
-  //     // should be put into the new page
-  //     auto value = bucket_page->ValueAt(i);
-  //     assert(new_bucket_page->Insert(key, value, comparator_));
-  //     assert(bucket_page->Remove(key, value, comparator_));
-  //   }
-  // }
-
-  assert(buffer_pool_manager_->UnpinPage(bucket_page_id, true));
+  RehashKvs(reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(bucket_raw_page->GetData()), local_high_bit,
+            reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(new_raw_page->GetData()));
+  new_raw_page->WUnlatch();
   assert(buffer_pool_manager_->UnpinPage(new_page_id, true));
-
-  // After we've done all the split things, we should try to insert this kv .
-  // buffer_pool_manager_->UnpinPage(page_id, false);
-  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, true));
-
-  // LOG_DEBUG("recursively insert");
-  table_latch_.WUnlock();
-
-  return Insert(transaction, key, value);
+  return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::RehashKvs(HASH_TABLE_BUCKET_TYPE *old_page, HashTableDirectoryPage *dir_page,
+void HASH_TABLE_TYPE::RehashKvs(HASH_TABLE_BUCKET_TYPE *old_page, uint32_t local_high_bit,
                                 HASH_TABLE_BUCKET_TYPE *new_page) {
-  // rehash all the kvs in the old page and decide whether they should
-  // be put into the old or new bucket.
   for (size_t i = 0; i < BUCKET_ARRAY_SIZE; ++i) {
+    if (!old_page->IsReadable(i)) {
+      continue;
+    }
     KeyType key = old_page->KeyAt(i);
-    uint32_t key_index = KeyToDirectoryIndex(key, dir_page);
-    if ((key_index & dir_page->GetLocalHighBit(key_index)) != 0) {
+    if ((Hash(key) & local_high_bit) != 0) {
       // this key's index's local high bit is 1
       // should be put into the new page
-      auto value = old_page->ValueAt(i);
-      assert(new_page->Insert(key, value, comparator_));
-      assert(old_page->Remove(key, value, comparator_));
+      new_page->Insert(key, old_page->ValueAt(i), comparator_);
+      old_page->RemoveAt(i);
     }
   }
 }
 
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+/*
+ * Build the table over the hash prefixes of the items: the items that share the
+ * low d bits of their hash get one bucket of local depth d if they fit into
+ * fill_factor of a bucket, or if the directory can't grow any more, and are
+ * split by bit d of their hash otherwise. The items are grouped by a counting
+ * sort on the low bits of their hash, so this is linear in their number. The global depth is the deepest
+ * bucket's. Every bucket is written once, with only one new page pinned at a
+ * time, and the directory is filled in once all buckets are written.
+ * @return: false if the table is not empty, otherwise true
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::BulkLoad(std::vector<MappingType> *items, double fill_factor) {
+  Page *dir_raw_page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  auto dir_page = reinterpret_cast<HashTableDirectoryPage *>(dir_raw_page->GetData());
+  // the bucket, then the directory, like Insert
+  Page *first_raw_page = LatchBucketPage(dir_raw_page, 0, true);
+  auto first_page = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(first_raw_page->GetData());
+  dir_raw_page->WLatch();
+  if (dir_page->GetGlobalDepth() != 0 || !first_page->IsEmpty()) {
+    dir_raw_page->WUnlatch();
+    first_raw_page->WUnlatch();
+    assert(buffer_pool_manager_->UnpinPage(first_raw_page->GetPageId(), false));
+    assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false));
+    return false;
+  }
+
+  // group the items by their directory index at the directory's largest size, ordered by that index with its bits
+  // reversed, so that the items of every hash prefix are a contiguous range of groups
+  uint32_t max_depth = 0;
+  while ((2U << max_depth) <= DIRECTORY_ARRAY_SIZE) {
+    ++max_depth;
+  }
+  std::vector<uint32_t> item_groups(items->size());
+  std::vector<size_t> group_begin((1U << max_depth) + 1);
+  for (size_t i = 0; i < items->size(); ++i) {
+    uint32_t hash = Hash((*items)[i].first);
+    uint32_t group = 0;
+    for (uint32_t bit = 0; bit < max_depth; ++bit, hash >>= 1) {
+      group = (group << 1) | (hash & 1);
+    }
+    item_groups[i] = group;
+    ++group_begin[group + 1];
+  }
+  for (size_t group = 1; group < group_begin.size(); ++group) {
+    group_begin[group] += group_begin[group - 1];
+  }
+  std::vector<size_t> order(items->size());
+  std::vector<size_t> group_end(group_begin.begin(), group_begin.end() - 1);
+  for (size_t i = 0; i < items->size(); ++i) {
+    order[group_end[item_groups[i]]++] = i;
+  }
+
+  // a bucket of local depth d holds 2^(max_depth - d) groups, and bit d of the hash splits them in half
+  struct BucketRange {
+    uint32_t first_group_;
+    uint32_t prefix_;
+    uint32_t depth_;
+  };
+  auto bucket_items = static_cast<size_t>(static_cast<double>(BUCKET_ARRAY_SIZE) * fill_factor);
+  bucket_items = std::max<size_t>(1, std::min<size_t>(BUCKET_ARRAY_SIZE, bucket_items));
+  std::vector<BucketRange> buckets;
+  std::vector<BucketRange> ranges = {{0, 0, 0}};
+  uint32_t global_depth = 0;
+  while (!ranges.empty()) {
+    BucketRange range = ranges.back();
+    ranges.pop_back();
+    uint32_t num_groups = 1U << (max_depth - range.depth_);
+    size_t num_items = group_begin[range.first_group_ + num_groups] - group_begin[range.first_group_];
+    if (num_items <= bucket_items || range.depth_ == max_depth) {
+      buckets.push_back(range);
+      global_depth = std::max(global_depth, range.depth_);
+      continue;
+    }
+    ranges.push_back({range.first_group_, range.prefix_, range.depth_ + 1});
+    ranges.push_back({range.first_group_ + num_groups / 2, range.prefix_ | (1U << range.depth_), range.depth_ + 1});
+  }
+
+  // write the buckets; the one of prefix 0 is the table's first bucket, the others are new pages no one can reach yet
+  std::vector<page_id_t> bucket_page_ids(buckets.size());
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    Page *raw_page = first_raw_page;
+    if (buckets[i].prefix_ != 0) {
+      raw_page = buffer_pool_manager_->NewPage(&bucket_page_ids[i]);
+      if (raw_page == nullptr) {
+        dir_raw_page->WUnlatch();
+        first_raw_page->WUnlatch();
+        assert(buffer_pool_manager_->UnpinPage(first_raw_page->GetPageId(), true));
+        assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false));
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "buffer pool out of memory");
+      }
+    } else {
+      bucket_page_ids[i] = first_raw_page->GetPageId();
+    }
+    auto bucket_page = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(raw_page->GetData());
+    uint32_t end_group = buckets[i].first_group_ + (1U << (max_depth - buckets[i].depth_));
+    for (size_t j = group_begin[buckets[i].first_group_]; j < group_begin[end_group]; ++j) {
+      const MappingType &item = (*items)[order[j]];
+      // a duplicate pair is dropped like Insert drops it; only a bucket at the directory's limit can fill up
+      if (!bucket_page->Insert(item.first, item.second, comparator_) && bucket_page->IsFull()) {
+        LOG_DEBUG("insert fail, bucket can't split");
+      }
+    }
+    if (raw_page != first_raw_page) {
+      assert(buffer_pool_manager_->UnpinPage(bucket_page_ids[i], true));
+    }
+  }
+
+  // point every directory slot with a bucket's prefix at it
+  for (uint32_t depth = 0; depth < global_depth; ++depth) {
+    dir_page->IncrGlobalDepth();
+  }
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    for (uint32_t dir_index = buckets[i].prefix_; dir_index < dir_page->Size(); dir_index += 1U << buckets[i].depth_) {
+      dir_page->SetBucketPageId(dir_index, bucket_page_ids[i]);
+      dir_page->SetLocalDepth(dir_index, buckets[i].depth_);
+    }
+  }
+  dir_raw_page->WUnlatch();
+  first_raw_page->WUnlatch();
+  assert(buffer_pool_manager_->UnpinPage(first_raw_page->GetPageId(), true));
+  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, true));
+  return true;
+}
+
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  table_latch_.RLock();
-
+  uint32_t hash = Hash(key);
   // get the directory page
-  auto dir_page = FetchDirectoryPage();
-  page_id_t page_id = KeyToPageId(key, dir_page);
+  Page *dir_raw_page = buffer_pool_manager_->FetchPage(directory_page_id_);
   // get the bucket page
-  auto bucket_page = FetchBucketPage(page_id);
-  auto page = reinterpret_cast<Page *>(bucket_page);
-  page->WLatch();
+  Page *page = LatchBucketPage(dir_raw_page, hash, true);
+  auto bucket_page = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
 
-  if (bucket_page->Remove(key, value, comparator_)) {
-    if (bucket_page->IsEmpty()) {
-      page->WUnlatch();
-      assert(buffer_pool_manager_->UnpinPage(page_id, true));
-      assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false));
-      table_latch_.RUnlock();
-      Merge(transaction, key, value);
-      return true;
-    }
-    page->WUnlatch();
-    assert(buffer_pool_manager_->UnpinPage(page_id, true));
-    assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false));
-    table_latch_.RUnlock();
-    return true;
-  }
-  // LOG_DEBUG("remove fail, hash: %x bucket page %u, dir_index %u", Hash(key), KeyToPageId(key, dir_page),
-  //           KeyToDirectoryIndex(key, dir_page));
+  bool res = bucket_page->Remove(key, value, comparator_);
+  bool empty = res && bucket_page->IsEmpty();
 
-  // buffer_pool_manager_->UnpinPage(page_id, true);
   page->WUnlatch();
-
-  assert(buffer_pool_manager_->UnpinPage(page_id, true));
+  assert(buffer_pool_manager_->UnpinPage(page->GetPageId(), res));
   assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false));
 
-  table_latch_.RUnlock();
-  // LOG_DEBUG("remove fail");
-
-  return false;
+  if (empty) {
+    Merge(transaction, key, value);
+  }
+  return res;
 }
 
 /*****************************************************************************
@@ -362,113 +455,92 @@ bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  table_latch_.WLock();
-
+  uint32_t hash = Hash(key);
   // get the directory page
-  auto dir_page = FetchDirectoryPage();
-  page_id_t page_id = KeyToPageId(key, dir_page);
-  // get the bucket page
-  auto bucket_page = FetchBucketPage(page_id);
-  // LOG_DEBUG("start merging page %u", KeyToPageId(key, dir_page));
-
-  // get the bucket index
-  uint32_t dir_index = KeyToDirectoryIndex(key, dir_page);
-  // case (1)(2)
-  if (!bucket_page->IsEmpty() || dir_page->GetLocalDepth(dir_index) == 0) {
-    // LOG_DEBUG("page not empty");
-    assert(buffer_pool_manager_->UnpinPage(page_id, false));
-    assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false));
-    table_latch_.WUnlock();
-    return;
-  }
-
-  // // case (2)
-  // if (dir_page->GetLocalDepth(dir_index) == 0) {
-  //   // LOG_DEBUG("local depth zero");
-  //   assert(buffer_pool_manager_->UnpinPage(page_id, false));
-  //   assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false));
-  //   table_latch_.WUnlock();
-  //   return;
-  // }
-
-  uint32_t split_index = dir_page->GetSplitImageIndex(dir_index);
-  // LOG_DEBUG("index: %u, split index: %u, local depth: %u",
-  // dir_index, split_index, dir_page->GetLocalDepth(split_index));
-
-  // case (3)
-  // uint32_t split_index;
-  bool no_equal_ld_split_page = true;
-  for (size_t i = 0; i < dir_page->Size(); ++i) {
-    if (dir_page->GetBucketPageId(i) != page_id) {
-      continue;
+  Page *dir_raw_page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  auto dir_page = reinterpret_cast<HashTableDirectoryPage *>(dir_raw_page->GetData());
+  bool dir_dirty = false;
+
+  while (true) {
+    // get the bucket page
+    Page *page = LatchBucketPage(dir_raw_page, hash, true);
+    page_id_t page_id = page->GetPageId();
+    auto bucket_page = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+
+    dir_raw_page->WLatch();
+    // get the bucket index
+    uint32_t dir_index = hash & dir_page->GetGlobalDepthMask();
+    // case (1)(2)
+    bool can_merge = bucket_page->IsEmpty() && dir_page->GetLocalDepth(dir_index) != 0;
+
+    // case (3)
+    uint32_t split_index = 0;
+    if (can_merge) {
+      can_merge = false;
+      for (size_t i = 0; i < dir_page->Size(); ++i) {
+        if (dir_page->GetBucketPageId(i) != page_id) {
+          continue;
+        }
+        // find all the dir indexes that point to this empty bucket
+        split_index = dir_page->GetSplitImageIndex(i);
+        if (dir_page->GetLocalDepth(i) == dir_page->GetLocalDepth(split_index)) {
+          can_merge = true;
+          break;
+        }
+      }
     }
-    // find all the dir indexes that point to this empty bucket
-    // LOG_DEBUG("find a index with same page, index %lu, page_id %u", i, page_id);
-    split_index = dir_page->GetSplitImageIndex(i);
-    if (dir_page->GetLocalDepth(i) == dir_page->GetLocalDepth(split_index)) {
-      no_equal_ld_split_page = false;
+
+    if (!can_merge) {
+      dir_raw_page->WUnlatch();
+      page->WUnlatch();
+      assert(buffer_pool_manager_->UnpinPage(page_id, false));
       break;
     }
-  }
-
-  if (no_equal_ld_split_page) {
-    // all the split index pages' local depth are unequal to their original index's
-    // LOG_DEBUG("no match split-image index, page_id %u, local depth %u",
-    //           page_id, dir_page->GetLocalDepth(dir_index));
-    buffer_pool_manager_->UnpinPage(page_id, false);
-    buffer_pool_manager_->UnpinPage(directory_page_id_, true);
-    table_latch_.WUnlock();
-    return;
-  }
-  // uint32_t split_index = dir_page->GetSplitImageIndex(dir_index);
-  // if (dir_page->GetLocalDepth(dir_index) != dir_page->GetLocalDepth(split_index)) {
-  //   // LOG_DEBUG("local depth not the same as split image");
-  //   buffer_pool_manager_->UnpinPage(page_id, false);
-  //   buffer_pool_manager_->UnpinPage(directory_page_id_, false);
-  //   table_latch_.WUnlock();
-  //   return;
-  // }
 
-  uint32_t local_depth = dir_page->GetLocalDepth(dir_index);
-  page_id_t split_page_id = dir_page->GetBucketPageId(split_index);
+    uint32_t local_depth = dir_page->GetLocalDepth(dir_index);
+    page_id_t split_page_id = dir_page->GetBucketPageId(split_index);
 
-  // let all the indexes that point to the empty page point to their split-image index's page
-  for (size_t i = 0; i < dir_page->Size(); ++i) {
-    if (dir_page->GetBucketPageId(i) != page_id) {
-      continue;
+    // let all the indexes that point to the empty page point to their split-image index's page
+    for (size_t i = 0; i < dir_page->Size(); ++i) {
+      if (dir_page->GetBucketPageId(i) != page_id) {
+        continue;
+      }
+      dir_page->SetBucketPageId(i, split_page_id);
+      // decrease the depth of both index and split index
+      split_index = dir_page->GetSplitImageIndex(i);
+      if (dir_page->GetLocalDepth(split_index) == local_depth) {
+        dir_page->DecrLocalDepth(split_index);
+      }
+      dir_page->DecrLocalDepth(i);
     }
-    dir_page->SetBucketPageId(i, split_page_id);
-    // decrease the depth of both index and split index
-    split_index = dir_page->GetSplitImageIndex(i);
-    if (dir_page->GetLocalDepth(split_index) == local_depth) {
-      dir_page->DecrLocalDepth(split_index);
+
+    // shrink the dir_page
+    if (dir_page->CanShrink()) {
+      dir_page->DecrGlobalDepth();
     }
-    dir_page->DecrLocalDepth(i);
-  }
+    dir_raw_page->WUnlatch();
+    dir_dirty = true;
 
-  // delete the empty page
-  assert(buffer_pool_manager_->UnpinPage(page_id, false));
-  assert(buffer_pool_manager_->DeletePage(page_id));
+    // delete the empty page; a thread that found it before the directory changed may still have it pinned, but lets
+    // go of it as soon as it sees the new mapping
+    page->WUnlatch();
+    assert(buffer_pool_manager_->UnpinPage(page_id, false));
+    while (!buffer_pool_manager_->DeletePage(page_id)) {
+      std::this_thread::yield();
+    }
 
-  // shrink the dir_page
-  if (dir_page->CanShrink()) {
-    dir_page->DecrGlobalDepth();
+    // after merging, check whether the split-image is also empty; if so, merge it as well
+    Page *split_page = buffer_pool_manager_->FetchPage(split_page_id);
+    split_page->RLatch();
+    bool split_empty = reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(split_page->GetData())->IsEmpty();
+    split_page->RUnlatch();
+    assert(buffer_pool_manager_->UnpinPage(split_page_id, false));
+    if (!split_empty) {
+      break;
+    }
   }
 
-  auto split_page = FetchBucketPage(split_page_id);
-  // after merging, check whether the split-image is also empty
-  if (split_page->IsEmpty()) {
-    // if split-image is also empty, we should merge recursively
-    buffer_pool_manager_->UnpinPage(split_page_id, false);
-    buffer_pool_manager_->UnpinPage(directory_page_id_, true);
-    table_latch_.WUnlock();
-    Merge(transaction, key, value);
-
-  } else {
-    buffer_pool_manager_->UnpinPage(split_page_id, false);
-    buffer_pool_manager_->UnpinPage(directory_page_id_, true);
-    table_latch_.WUnlock();
-  }
+  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, dir_dirty));
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
@@ -489,11 +561,12 @@ void HASH_TABLE_TYPE::PrintDirectoryAndBuckets() {
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 uint32_t HASH_TABLE_TYPE::GetGlobalDepth() {
-  table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  Page *dir_raw_page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  dir_raw_page->RLatch();
+  auto dir_page = reinterpret_cast<HashTableDirectoryPage *>(dir_raw_page->GetData());
   uint32_t global_depth = dir_page->GetGlobalDepth();
+  dir_raw_page->RUnlatch();
   assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false, nullptr));
-  table_latch_.RUnlock();
   return global_depth;
 }
 
@@ -502,11 +575,12 @@ uint32_t HASH_TABLE_TYPE::GetGlobalDepth() {
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_TYPE::VerifyIntegrity() {
-  table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
+  Page *dir_raw_page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  dir_raw_page->RLatch();
+  auto dir_page = reinterpret_cast<HashTableDirectoryPage *>(dir_raw_page->GetData());
   dir_page->VerifyIntegrity();
+  dir_raw_page->RUnlatch();
   assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false, nullptr));
-  table_latch_.RUnlock();
 }
 
 /*****************************************************************************
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -23,46 +24,357 @@
 namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                      const KeyComparator &comparator, size_t num_buckets,
-                                      HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+LINEAR_PROBE_HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                                   const KeyComparator &comparator, size_t num_buckets,
+                                                   HashFunction<KeyType> hash_fn)
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  hash_fn_.SetKeyLength(comparator_.KeyLength());
+  header_page_id_ = NewTable(num_buckets);
+  if (header_page_id_ == INVALID_PAGE_ID) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "buffer pool out of memory");
+  }
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+page_id_t LINEAR_PROBE_HASH_TABLE_TYPE::NewTable(size_t num_buckets) {
+  size_t num_blocks = std::min((std::max<size_t>(num_buckets, 1) - 1) / BLOCK_ARRAY_SIZE + 1, HEADER_BLOCK_ARRAY_SIZE);
+  page_id_t header_page_id;
+  Page *header_raw_page = buffer_pool_manager_->NewPage(&header_page_id);
+  if (header_raw_page == nullptr) {
+    return INVALID_PAGE_ID;
+  }
+  auto header_page = reinterpret_cast<HashTableHeaderPage *>(header_raw_page->GetData());
+  header_page->SetPageId(header_page_id);
+  header_page->SetSize(num_blocks * BLOCK_ARRAY_SIZE);
+  for (size_t i = 0; i < num_blocks; ++i) {
+    page_id_t block_page_id;
+    if (buffer_pool_manager_->NewPage(&block_page_id) == nullptr) {
+      // the header page stays resident, so DeleteTable can fetch it
+      assert(buffer_pool_manager_->UnpinPage(header_page_id, true));
+      DeleteTable(header_page_id);
+      return INVALID_PAGE_ID;
+    }
+    header_page->AddBlockPageId(block_page_id);
+    assert(buffer_pool_manager_->UnpinPage(block_page_id, true));
+  }
+  assert(buffer_pool_manager_->UnpinPage(header_page_id, true));
+  return header_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool LINEAR_PROBE_HASH_TABLE_TYPE::DeleteTable(page_id_t header_page_id) {
+  Page *header_raw_page = buffer_pool_manager_->FetchPage(header_page_id);
+  if (header_raw_page == nullptr) {
+    return false;
+  }
+  auto header_page = reinterpret_cast<HashTableHeaderPage *>(header_raw_page->GetData());
+  for (size_t i = 0; i < header_page->NumBlocks(); ++i) {
+    buffer_pool_manager_->DeletePage(header_page->GetBlockPageId(i));
+  }
+  assert(buffer_pool_manager_->UnpinPage(header_page_id, false));
+  buffer_pool_manager_->DeletePage(header_page_id);
+  return true;
+}
+
+/*
+ * The buckets of a table are the slots of its blocks, in the order of the
+ * blocks in the header page. Only one block page is pinned at a time.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visitor>
+bool LINEAR_PROBE_HASH_TABLE_TYPE::Probe(page_id_t header_page_id, const KeyType &key, Visitor visit,
+                                         bool *stopped) {
+  Page *header_raw_page = buffer_pool_manager_->FetchPage(header_page_id);
+  if (header_raw_page == nullptr) {
+    return false;
+  }
+  auto header_page = reinterpret_cast<HashTableHeaderPage *>(header_raw_page->GetData());
+  size_t size = header_page->GetSize();
+  size_t home = hash_fn_.GetHash(key) % size;
+  size_t block_index = home / BLOCK_ARRAY_SIZE;
+  slot_offset_t bucket_ind = home % BLOCK_ARRAY_SIZE;
+  ProbeAction action = ProbeAction::NEXT;
+  for (size_t num_visited = 0; num_visited < size && action == ProbeAction::NEXT;) {
+    page_id_t block_page_id = header_page->GetBlockPageId(block_index);
+    Page *block_raw_page = buffer_pool_manager_->FetchPage(block_page_id);
+    if (block_raw_page == nullptr) {
+      assert(buffer_pool_manager_->UnpinPage(header_page_id, false));
+      return false;
+    }
+    auto block_page = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(block_raw_page->GetData());
+    for (; bucket_ind < BLOCK_ARRAY_SIZE && num_visited < size; ++bucket_ind, ++num_visited) {
+      action = visit(block_page, bucket_ind);
+      if (action != ProbeAction::NEXT) {
+        break;
+      }
+    }
+    assert(buffer_pool_manager_->UnpinPage(block_page_id, action == ProbeAction::STOP_DIRTY));
+    // go on at the start of the next block, wrapping around after the last one
+    block_index = (block_index + 1) % header_page->NumBlocks();
+    bucket_ind = 0;
+  }
+  assert(buffer_pool_manager_->UnpinPage(header_page_id, false));
+  *stopped = action != ProbeAction::NEXT;
+  return true;
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
-  return false;
+bool LINEAR_PROBE_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key,
+                                            std::vector<ValueType> *result) {
+  table_latch_.RLock();
+  size_t num_values = result->size();
+  bool fetched = GetValueFrom(header_page_id_, key, result) &&
+                 (old_header_page_id_ == INVALID_PAGE_ID || GetValueFrom(old_header_page_id_, key, result));
+  table_latch_.RUnlock();
+  return fetched && result->size() > num_values;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool LINEAR_PROBE_HASH_TABLE_TYPE::GetValueFrom(page_id_t header_page_id, const KeyType &key,
+                                                std::vector<ValueType> *result) {
+  auto visit = [&](HASH_TABLE_BLOCK_TYPE *block_page, slot_offset_t bucket_ind) {
+    if (!block_page->IsOccupied(bucket_ind)) {
+      // the probe sequence ends at the first bucket that was never occupied
+      return ProbeAction::STOP;
+    }
+    if (block_page->IsReadable(bucket_ind) && comparator_(key, block_page->KeyAt(bucket_ind)) == 0) {
+      result->push_back(block_page->ValueAt(bucket_ind));
+    }
+    return ProbeAction::NEXT;
+  };
+  bool stopped;
+  return Probe(header_page_id, key, visit, &stopped);
 }
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+bool LINEAR_PROBE_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.WLock();
+  bool res = false;
+  if (!MaybeResize()) {
+    table_latch_.WUnlock();
+    return res;
+  }
+  // a block that can't be moved now is moved by a later insert or remove
+  MigrateBlock();
+
+  std::vector<ValueType> old_values;
+  if (old_header_page_id_ == INVALID_PAGE_ID ||
+      (GetValueFrom(old_header_page_id_, key, &old_values) &&
+       std::find(old_values.begin(), old_values.end(), value) == old_values.end())) {
+    bool full;
+    res = InsertInto(header_page_id_, key, value, &full);
+    if (res) {
+      ++num_occupied_;
+      ++num_readable_;
+    } else if (full) {
+      LOG_DEBUG("insert fail, table full");
+    }
+  }
+
+  table_latch_.WUnlock();
+  return res;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool LINEAR_PROBE_HASH_TABLE_TYPE::InsertInto(page_id_t header_page_id, const KeyType &key, const ValueType &value,
+                                              bool *full) {
+  bool inserted = false;
+  // tombstones can't be reused, since the block page only claims buckets that were never occupied
+  auto visit = [&](HASH_TABLE_BLOCK_TYPE *block_page, slot_offset_t bucket_ind) {
+    if (!block_page->IsOccupied(bucket_ind)) {
+      inserted = block_page->Insert(bucket_ind, key, value);
+      return ProbeAction::STOP_DIRTY;
+    }
+    if (block_page->IsReadable(bucket_ind) && comparator_(key, block_page->KeyAt(bucket_ind)) == 0 &&
+        block_page->ValueAt(bucket_ind) == value) {
+      // duplicate kv
+      return ProbeAction::STOP;
+    }
+    return ProbeAction::NEXT;
+  };
+  bool stopped;
+  *full = Probe(header_page_id, key, visit, &stopped) && !stopped;
+  return inserted;
 }
 
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+bool LINEAR_PROBE_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.WLock();
+  // a block that can't be moved now is moved by a later insert or remove
+  MigrateBlock();
+
+  bool res = RemoveFrom(header_page_id_, key, value) ||
+             (old_header_page_id_ != INVALID_PAGE_ID && RemoveFrom(old_header_page_id_, key, value));
+  if (res) {
+    --num_readable_;
+  }
+
+  table_latch_.WUnlock();
+  return res;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool LINEAR_PROBE_HASH_TABLE_TYPE::RemoveFrom(page_id_t header_page_id, const KeyType &key, const ValueType &value) {
+  bool removed = false;
+  auto visit = [&](HASH_TABLE_BLOCK_TYPE *block_page, slot_offset_t bucket_ind) {
+    if (!block_page->IsOccupied(bucket_ind)) {
+      return ProbeAction::STOP;
+    }
+    if (block_page->IsReadable(bucket_ind) && comparator_(key, block_page->KeyAt(bucket_ind)) == 0 &&
+        block_page->ValueAt(bucket_ind) == value) {
+      // leave a tombstone, so the probe sequences that go past this bucket stay intact
+      block_page->Remove(bucket_ind);
+      removed = true;
+      return ProbeAction::STOP_DIRTY;
+    }
+    return ProbeAction::NEXT;
+  };
+  bool stopped;
+  Probe(header_page_id, key, visit, &stopped);
+  return removed;
 }
 
 /*****************************************************************************
  * RESIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+void LINEAR_PROBE_HASH_TABLE_TYPE::Resize(size_t initial_size) {
+  table_latch_.WLock();
+  StartResize(2 * initial_size);
+  table_latch_.WUnlock();
+}
+
+/*
+ * The new table becomes the one inserts go to, and the old one is only read
+ * and removed from until MigrateBlock has moved all of its blocks.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool LINEAR_PROBE_HASH_TABLE_TYPE::StartResize(size_t num_buckets) {
+  while (old_header_page_id_ != INVALID_PAGE_ID) {
+    if (!MigrateBlock()) {
+      return false;
+    }
+  }
+  // every pair has to fit into the new table
+  page_id_t new_header_page_id = NewTable(std::max(num_buckets, 2 * num_readable_));
+  if (new_header_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  old_header_page_id_ = header_page_id_;
+  header_page_id_ = new_header_page_id;
+  next_block_index_ = 0;
+  num_occupied_ = 0;
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool LINEAR_PROBE_HASH_TABLE_TYPE::MaybeResize() {
+  Page *header_raw_page = buffer_pool_manager_->FetchPage(header_page_id_);
+  if (header_raw_page == nullptr) {
+    return false;
+  }
+  size_t size = reinterpret_cast<HashTableHeaderPage *>(header_raw_page->GetData())->GetSize();
+  assert(buffer_pool_manager_->UnpinPage(header_page_id_, false));
+  if ((num_occupied_ + 1) * 4 <= size * 3) {
+    return true;
+  }
+  if (num_readable_ * 2 < size) {
+    // mostly tombstones, so rebuilding the table at the same size frees enough buckets
+    StartResize(size);
+  } else if (size < HEADER_BLOCK_ARRAY_SIZE * BLOCK_ARRAY_SIZE) {
+    StartResize(2 * size);
+  }
+  return true;
+}
+
+/*
+ * A moved pair leaves a tombstone in the old table rather than an empty
+ * bucket, so the pairs of the old table that probed past it are still found.
+ * A pair the new table can't take stays where it is, and the block is moved
+ * again, from that pair on, by the next call.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool LINEAR_PROBE_HASH_TABLE_TYPE::MigrateBlock() {
+  if (old_header_page_id_ == INVALID_PAGE_ID) {
+    return true;
+  }
+  Page *old_header_raw_page = buffer_pool_manager_->FetchPage(old_header_page_id_);
+  if (old_header_raw_page == nullptr) {
+    return false;
+  }
+  auto old_header_page = reinterpret_cast<HashTableHeaderPage *>(old_header_raw_page->GetData());
+  size_t num_blocks = old_header_page->NumBlocks();
+  bool moved = true;
+  if (next_block_index_ < num_blocks) {
+    page_id_t block_page_id = old_header_page->GetBlockPageId(next_block_index_);
+    Page *block_raw_page = buffer_pool_manager_->FetchPage(block_page_id);
+    if (block_raw_page == nullptr) {
+      assert(buffer_pool_manager_->UnpinPage(old_header_page_id_, false));
+      return false;
+    }
+    auto block_page = reinterpret_cast<HASH_TABLE_BLOCK_TYPE *>(block_raw_page->GetData());
+    for (slot_offset_t i = 0; i < BLOCK_ARRAY_SIZE && moved; ++i) {
+      if (block_page->IsReadable(i)) {
+        bool full;
+        moved = InsertInto(header_page_id_, block_page->KeyAt(i), block_page->ValueAt(i), &full);
+        if (moved) {
+          ++num_occupied_;
+          block_page->Remove(i);
+        } else if (full) {
+          LOG_DEBUG("migrate fail, table full");
+        }
+      }
+    }
+    assert(buffer_pool_manager_->UnpinPage(block_page_id, true));
+    if (moved) {
+      ++next_block_index_;
+    }
+  }
+  assert(buffer_pool_manager_->UnpinPage(old_header_page_id_, false));
+
+  if (moved && next_block_index_ == num_blocks) {
+    if (!DeleteTable(old_header_page_id_)) {
+      return false;
+    }
+    old_header_page_id_ = INVALID_PAGE_ID;
+  }
+  return moved;
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-size_t HASH_TABLE_TYPE::GetSize() {
-  return 0;
+size_t LINEAR_PROBE_HASH_TABLE_TYPE::GetSize() {
+  table_latch_.RLock();
+  size_t size = 0;
+  Page *header_raw_page = buffer_pool_manager_->FetchPage(header_page_id_);
+  if (header_raw_page != nullptr) {
+    size = reinterpret_cast<HashTableHeaderPage *>(header_raw_page->GetData())->GetSize();
+    assert(buffer_pool_manager_->UnpinPage(header_page_id_, false));
+  }
+  table_latch_.RUnlock();
+  return size;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool LINEAR_PROBE_HASH_TABLE_TYPE::IsResizing() {
+  table_latch_.RLock();
+  bool resizing = old_header_page_id_ != INVALID_PAGE_ID;
+  table_latch_.RUnlock();
+  return resizing;
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
@@ -11,12 +11,327 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
 
+#include <algorithm>
+#include <numeric>
+
+#include "common/exception.h"
+#include "concurrency/transaction.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "storage/page/table_page.h"
+#include "type/type.h"
+
 namespace bustub {
+
+/**
+ * Holds the record ids of an index scan, in the order the scan returns them. They are all read from the index up
+ * front by the subclass: a B+ tree iterator kept between batches would hold its leaf pinned, and a delete or update
+ * above the scan could then never merge it.
+ */
+class IndexRidReader {
+ public:
+  virtual ~IndexRidReader() = default;
+
+  /**
+   * Append up to max_rids record ids to rids.
+   * @return nothing; fewer than max_rids record ids means the scan is done
+   */
+  void Read(std::vector<RID> *rids, size_t max_rids) {
+    for (; rids->size() < max_rids && next_ < rids_.size(); ++next_) {
+      rids->push_back(rids_[next_]);
+    }
+  }
+
+ protected:
+  std::vector<RID> rids_;
+
+ private:
+  size_t next_{0};
+};
+
+namespace {
+
+/** The keys a predicate restricts an index scan to; both bounds are set, or none. */
+struct KeyRange {
+  bool bounded_{false};
+  /** True if the predicate asks for a single key, i.e. low_ == high_. */
+  bool point_{false};
+  Tuple low_;
+  Tuple high_;
+  bool low_inclusive_{true};
+  bool high_inclusive_{true};
+};
+
+/** @return true for the column types whose keys order like their values and have a minimum and maximum value */
+bool IsOrderedType(TypeId type_id) {
+  switch (type_id) {
+    case TypeId::TINYINT:
+    case TypeId::SMALLINT:
+    case TypeId::INTEGER:
+    case TypeId::BIGINT:
+    case TypeId::DECIMAL:
+    case TypeId::TIMESTAMP:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/** @return true for the integer types, which convert into each other exactly when the value fits */
+bool IsIntegerType(TypeId type_id) {
+  return type_id == TypeId::TINYINT || type_id == TypeId::SMALLINT || type_id == TypeId::INTEGER ||
+         type_id == TypeId::BIGINT;
+}
+
+/** @return the comparison with its operands swapped, e.g. a < b becomes b > a */
+ComparisonType Flip(ComparisonType comp_type) {
+  switch (comp_type) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return comp_type;
+  }
+}
+
+/**
+ * Turn a predicate that compares the key column of a single-column index with a constant into the range of keys it
+ * can match. The open side of a range ends at the smallest or largest value of the column type. Any other predicate,
+ * or a constant that does not convert exactly to the column type, leaves the range unbounded.
+ */
+KeyRange PushDownPredicate(const AbstractExpression *predicate, const IndexInfo &index_info,
+                           const Schema &table_schema) {
+  KeyRange range;
+  const auto &key_attrs = index_info.index_->GetKeyAttrs();
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(predicate);
+  if (comparison == nullptr || key_attrs.size() != 1) {
+    return range;
+  }
+  ComparisonType comp_type = comparison->GetComparisonType();
+  const auto *column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0));
+  const auto *constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1));
+  if (column == nullptr) {
+    column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1));
+    constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0));
+    comp_type = Flip(comp_type);
+  }
+  if (column == nullptr || constant == nullptr || column->GetTupleIdx() != 0 || column->GetColIdx() != key_attrs[0] ||
+      comp_type == ComparisonType::NotEqual) {
+    return range;
+  }
+
+  TypeId column_type = table_schema.GetColumn(key_attrs[0]).GetType();
+  Value value = constant->Evaluate(nullptr, nullptr);
+  if (!IsOrderedType(column_type) || value.IsNull()) {
+    return range;
+  }
+  if (value.GetTypeId() != column_type) {
+    if (!IsIntegerType(value.GetTypeId()) || !IsIntegerType(column_type)) {
+      return range;
+    }
+    try {
+      value = value.CastAs(column_type);
+    } catch (Exception &e) {
+      return range;
+    }
+  }
+
+  // keys are built like Tuple::KeyFromTuple() builds them for the index
+  const Schema *key_schema = &index_info.key_schema_;
+  range.bounded_ = true;
+  range.low_ = Tuple({Type::GetMinValue(column_type)}, key_schema);
+  range.high_ = Tuple({Type::GetMaxValue(column_type)}, key_schema);
+  Tuple key({value}, key_schema);
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      range.point_ = true;
+      range.low_ = key;
+      range.high_ = key;
+      break;
+    case ComparisonType::LessThan:
+      range.high_inclusive_ = false;
+      range.high_ = key;
+      break;
+    case ComparisonType::LessThanOrEqual:
+      range.high_ = key;
+      break;
+    case ComparisonType::GreaterThan:
+      range.low_inclusive_ = false;
+      range.low_ = key;
+      break;
+    case ComparisonType::GreaterThanOrEqual:
+      range.low_ = key;
+      break;
+    default:
+      break;
+  }
+  return range;
+}
+
+/** Walks the key range of a B+ tree index on GenericKey<KeySize> keys. */
+template <size_t KeySize>
+class BPlusTreeRidReader : public IndexRidReader {
+  using TreeIndex = BPlusTreeIndex<GenericKey<KeySize>, RID, GenericComparator<KeySize>>;
+  using TreeIterator = IndexIterator<GenericKey<KeySize>, RID, GenericComparator<KeySize>>;
+
+ public:
+  BPlusTreeRidReader(Index *index, const KeyRange &range, bool descending) {
+    for (TreeIterator iterator = MakeIterator(dynamic_cast<TreeIndex *>(index), range, descending); !iterator.IsEnd();
+         ++iterator) {
+      rids_.push_back((*iterator).second);
+    }
+  }
+
+ private:
+  static TreeIterator MakeIterator(TreeIndex *index, const KeyRange &range, bool descending) {
+    BUSTUB_ASSERT(index != nullptr, "B+ tree index of the wrong key size");
+    if (!range.bounded_) {
+      return descending ? index->GetReverseBeginIterator() : index->GetBeginIterator();
+    }
+    GenericKey<KeySize> low_key;
+    GenericKey<KeySize> high_key;
+    low_key.SetFromKey(range.low_);
+    high_key.SetFromKey(range.high_);
+    return index->GetRangeIterator(low_key, high_key, range.low_inclusive_, range.high_inclusive_, descending);
+  }
+};
+
+/** Returns the record ids of a single key, looked up in any kind of index. */
+class ScanKeyRidReader : public IndexRidReader {
+ public:
+  ScanKeyRidReader(Index *index, const Tuple &key, Transaction *txn) { index->ScanKey(key, &rids_, txn); }
+};
+
+std::unique_ptr<IndexRidReader> MakeRidReader(IndexInfo *index_info, const KeyRange &range, bool descending,
+                                              Transaction *txn) {
+  Index *index = index_info->index_.get();
+  if (index_info->index_type_ == IndexType::BPlusTree) {
+    switch (index_info->key_size_) {
+      case 4:
+        return std::make_unique<BPlusTreeRidReader<4>>(index, range, descending);
+      case 8:
+        return std::make_unique<BPlusTreeRidReader<8>>(index, range, descending);
+      case 16:
+        return std::make_unique<BPlusTreeRidReader<16>>(index, range, descending);
+      case 32:
+        return std::make_unique<BPlusTreeRidReader<32>>(index, range, descending);
+      case 64:
+        return std::make_unique<BPlusTreeRidReader<64>>(index, range, descending);
+      default:
+        throw NotImplementedException("B+ tree index key size " + std::to_string(index_info->key_size_));
+    }
+  }
+  // other indexes are not ordered, so they can only serve a lookup of one key
+  if (range.point_) {
+    return std::make_unique<ScanKeyRidReader>(index, range.low_, txn);
+  }
+  throw NotImplementedException("index scan needs a B+ tree index or an equality predicate on the index key");
+}
+
+}  // namespace
+
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+IndexScanExecutor::~IndexScanExecutor() = default;
+
+void IndexScanExecutor::Init() {
+  Catalog *catalog = exec_ctx_->GetCatalog();
+  index_info_ = catalog->GetIndex(plan_->GetIndexOid());
+  table_info_ = catalog->GetTable(index_info_->table_name_);
+  KeyRange range = PushDownPredicate(plan_->GetPredicate(), *index_info_, table_info_->schema_);
+  reader_.reset();
+  reader_ = MakeRidReader(index_info_, range, plan_->IsDescending(), exec_ctx_->GetTransaction());
+  batch_.clear();
+  batch_index_ = 0;
+}
+
+bool IndexScanExecutor::Next(Tuple *tuple, RID *rid) {
+  const AbstractExpression *predicate = plan_->GetPredicate();
+  while (true) {
+    while (batch_index_ == batch_.size()) {
+      if (!FetchBatch()) {
+        return false;
+      }
+    }
+    const Tuple &table_tuple = batch_[batch_index_++];
+    if (predicate != nullptr && !predicate->Evaluate(&table_tuple, &table_info_->schema_).GetAs<bool>()) {
+      continue;
+    }
+
+    std::vector<Value> values;
+    for (auto &col : plan_->OutputSchema()->GetColumns()) {
+      values.push_back(col.GetExpr()->Evaluate(&table_tuple, &table_info_->schema_));
+    }
+    *tuple = Tuple(values, plan_->OutputSchema());
+    *rid = table_tuple.GetRid();
+    return true;
+  }
+}
+
+bool IndexScanExecutor::FetchBatch() {
+  std::vector<RID> rids;
+  reader_->Read(&rids, BATCH_SIZE);
+  if (rids.empty()) {
+    return false;
+  }
+
+  Transaction *txn = exec_ctx_->GetTransaction();
+  LockManager *lock_mgr = exec_ctx_->GetLockManager();
+  if (txn->GetIsolationLevel() != IsolationLevel::READ_UNCOMMITTED) {
+    for (const auto &rid : rids) {
+      // when repeatable read, we may have already fetched the lock before
+      if (!txn->IsSharedLocked(rid) && !txn->IsExclusiveLocked(rid)) {
+        lock_mgr->LockShared(txn, rid);
+      }
+    }
+  }
+
+  // visit the table pages in page id order, each of them once; the tuples keep their key order in batch_
+  std::vector<size_t> order(rids.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&rids](size_t lhs, size_t rhs) { return rids[lhs].GetPageId() < rids[rhs].GetPageId(); });
+  std::vector<Tuple> tuples(rids.size());
+  std::vector<bool> found(rids.size(), false);
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  for (size_t i = 0; i < order.size();) {
+    page_id_t page_id = rids[order[i]].GetPageId();
+    auto *page = static_cast<TablePage *>(bpm->FetchPage(page_id));
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "buffer pool out of memory");
+    }
+    page->RLatch();
+    for (; i < order.size() && rids[order[i]].GetPageId() == page_id; ++i) {
+      found[order[i]] = page->GetTuple(rids[order[i]], &tuples[order[i]], txn, lock_mgr);
+    }
+    page->RUnlatch();
+    bpm->UnpinPage(page_id, false);
+  }
 
-void IndexScanExecutor::Init() {}
+  if (txn->GetIsolationLevel() == IsolationLevel::READ_COMMITTED) {
+    // when finishing reading, release the locks
+    for (const auto &rid : rids) {
+      lock_mgr->Unlock(txn, rid);
+    }
+  }
 
-bool IndexScanExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+  // tuples deleted since they were indexed are skipped
+  batch_.clear();
+  batch_index_ = 0;
+  for (size_t i = 0; i < rids.size(); ++i) {
+    if (found[i]) {
+      batch_.push_back(tuples[i]);
+    }
+  }
+  return true;
+}
 
 }  // namespace bustub
@@ -15,6 +15,7 @@
 #include <list>
 #include <mutex>  // NOLINT
 #include <unordered_map>
+#include <vector>
 
 #include "buffer/lru_replacer.h"
 #include "recovery/log_manager.h"
@@ -87,6 +88,14 @@ class BufferPoolManager {
   /** @return size of the buffer pool */
   virtual size_t GetPoolSize() = 0;
 
+  /**
+   * Start reading the given pages into the buffer pool in the background without pinning them, so that a scan finds
+   * them resident when it gets there. This is only a hint: pages may be skipped, and a FetchPage of a page whose read
+   * is still in flight waits for that read. The default implementation does nothing.
+   * @param page_ids ids of the pages that are about to be fetched
+   */
+  virtual void PrefetchPages(const std::vector<page_id_t> &page_ids) {}
+
  protected:
   /**
    * Grading function. Do not modify!
@@ -12,18 +12,44 @@
 
 #pragma once
 
+#include <array>
+#include <condition_variable>  // NOLINT
+#include <deque>
 #include <list>
-#include <mutex>  // NOLINT
+#include <mutex>         // NOLINT
+#include <shared_mutex>  // NOLINT
+#include <thread>        // NOLINT
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/frame_arena.h"
+#include "buffer/lru_k_replacer.h"
 #include "buffer/lru_replacer.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/page/free_list_page.h"
 #include "storage/page/page.h"
 
 namespace bustub {
 
+/** A snapshot of the activity of one BufferPoolManagerInstance, for spotting hot or undersized instances. */
+struct BufferPoolStats {
+  /** Number of frames of the instance. */
+  size_t pool_size_;
+  /** Number of fetches that found their page resident. */
+  size_t num_hits_;
+  /** Number of fetches that had to read their page from disk. */
+  size_t num_misses_;
+  /** Number of evictions that did not and that did have to write the victim back. */
+  size_t num_clean_evictions_;
+  size_t num_dirty_evictions_;
+  /** Number of frames pinned at the time of the snapshot. */
+  size_t num_pinned_frames_;
+};
+
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
  */
@@ -34,8 +60,10 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @param pool_size the size of the buffer pool
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy
    */
-  BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr);
+  BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::LRU);
   /**
    * Creates a new BufferPoolManagerInstance.
    * @param pool_size the size of the buffer pool
@@ -43,9 +71,12 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @param instance_index index of this BPI in the parallel BPM
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy
+   * @param numa_node the NUMA node to place the frame data on, -1 to leave placement to the OS
    */
   BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
-                            DiskManager *disk_manager, LogManager *log_manager = nullptr);
+                            DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::LRU, int numa_node = -1);
 
   /**
    * Destroys an existing BufferPoolManagerInstance.
@@ -58,6 +89,55 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** @return pointer to all the pages in the buffer pool */
   Page *GetPages() { return pages_; }
 
+  /** @return the arena that holds the data of all frames */
+  const FrameArena &GetFrameArena() const { return frame_arena_; }
+
+  /** @return the number of fetches that found their page in the page table */
+  size_t GetNumHits();
+
+  /** @return the number of fetches that missed the page table and had to read the page from disk */
+  size_t GetNumMisses() const { return num_misses_; }
+
+  /** @return the number of pages read into the buffer pool ahead of being fetched */
+  size_t GetNumPrefetches() const { return num_prefetches_; }
+
+  /** @return the number of evictions that did not need to write the victim back */
+  size_t GetNumCleanEvictions() const { return num_clean_evictions_; }
+
+  /** @return the number of evictions that had to write a dirty victim back before reusing its frame */
+  size_t GetNumDirtyEvictions() const { return num_dirty_evictions_; }
+
+  /** @return the number of frames that are currently pinned */
+  size_t GetNumPinnedFrames();
+
+  /** @return a snapshot of the counters of this instance */
+  BufferPoolStats GetStats();
+
+  /**
+   * Creates a new page like NewPage, but only in a frame from the free list; no page is evicted to make room for it.
+   * @param[out] page_id id of created page
+   * @return nullptr if the free list is empty, otherwise pointer to new page
+   */
+  Page *NewPageWithoutEviction(page_id_t *page_id);
+
+  /**
+   * Start a background thread that writes back dirty, unpinned frames before the replacer gets to them, so that most
+   * evictions find a clean victim. It wakes up every background_writer_interval, or as soon as a miss had to evict a
+   * dirty frame.
+   * @param num_clean_frames how many of the next victims the writer tries to keep clean
+   */
+  void StartBackgroundWriter(size_t num_clean_frames);
+
+  /** Stop and join the background writer thread. Does nothing if it is not running. */
+  void StopBackgroundWriter();
+
+  /**
+   * Queue the given pages for the prefetch thread, starting it on first use. Pages that are already resident or being
+   * read are skipped when the thread gets to them.
+   * @param page_ids ids of pages owned by this BPI
+   */
+  void PrefetchPages(const std::vector<page_id_t> &page_ids) override;
+
  protected:
   /**
    * Fetch the requested page from the buffer pool.
@@ -101,18 +181,19 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   void FlushAllPgsImp() override;
 
   /**
-   * Allocate a page on disk.∂
+   * Allocate a page on disk, reusing a deallocated page if there is one. The caller must hold latch_.
    * @return the id of the allocated page
    */
   page_id_t AllocatePage();
 
   /**
-   * Deallocate a page on disk.
+   * Deallocate a page on disk, so that AllocatePage hands its id out again. The caller must hold latch_.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
-  }
+  void DeallocatePage(page_id_t page_id);
+
+  /** Write the head page of the free page list to disk if it has changed. The caller must hold latch_. */
+  void FlushFreePageList();
 
   /**
    * Validate that the page_id being used is accessible to this BPI. This can be used in all of the functions to
@@ -121,6 +202,83 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   void ValidatePageId(page_id_t page_id) const;
 
+  /** Maximum number of pages the prefetch thread reads in one batch of disk requests. */
+  static constexpr size_t PREFETCH_BATCH_SIZE = 32;
+
+  /** Number of shards the page table is split into. */
+  static constexpr size_t PAGE_TABLE_SHARDS = 16;
+
+  /**
+   * One shard of the page table. Lookups that only pin a resident page take the shard latch in shared mode; inserting
+   * or erasing a mapping takes it in exclusive mode, and that only happens while holding latch_.
+   */
+  struct PageTableShard {
+    std::shared_mutex latch_;
+    std::unordered_map<page_id_t, frame_id_t> table_;
+    /** Number of fetches that found their page in this shard. Kept per shard so that hits do not share a counter. */
+    std::atomic<size_t> num_hits_ = 0;
+  };
+
+  /**
+   * @param page_id id of a page owned by this BPI
+   * @return the page table shard responsible for page_id
+   */
+  PageTableShard &GetShard(page_id_t page_id) {
+    // Page ids handed to this BPI are strided by num_instances_, so divide that out before spreading over shards.
+    return page_table_[(static_cast<size_t>(page_id) / num_instances_) % PAGE_TABLE_SHARDS];
+  }
+
+  /**
+   * Pin the page if it is already resident. This is the buffer pool hit path and never takes latch_.
+   * @param page_id id of page to be pinned
+   * @return the pinned page, or nullptr if the page is not in the buffer pool
+   */
+  Page *PinIfResident(page_id_t page_id);
+
+  /**
+   * Find a frame to hold a new page, from the free list first and otherwise by evicting a victim from the replacer.
+   * A dirty victim is written back and its page table entry removed. The caller must hold latch_.
+   * @param[out] frame_id id of the frame that is now free to use
+   * @param evict whether a victim may be evicted if the free list is empty
+   * @return false if no frame could be found, true otherwise
+   */
+  bool FindFreeFrame(frame_id_t *frame_id, bool evict = true);
+
+  /**
+   * @param page_id id of a page of this BPI's stripe
+   * @return true if the page is deallocated and on the free page list. The caller must hold latch_.
+   */
+  bool IsFreePage(page_id_t page_id) const;
+
+  /** NewPgImp and NewPageWithoutEviction */
+  Page *NewPageInFreeFrame(page_id_t *page_id, bool evict);
+
+  /** Body of the prefetch thread. */
+  void RunPrefetcher();
+
+  /**
+   * Read the given pages into free frames with one batch of disk requests. Frames are reserved under latch_, the pages
+   * are read without holding it, and then they are published in the page table as unpinned replacement candidates.
+   * @param page_ids ids of the pages to read
+   */
+  void PrefetchBatch(const std::vector<page_id_t> &page_ids);
+
+  /** Body of the background writer thread. */
+  void RunBackgroundWriter();
+
+  /**
+   * Write back the dirty frames among the next num_clean_frames_ victims. Each page is copied out under latch_ and
+   * written without holding it.
+   */
+  void CleanFrames();
+
+  /**
+   * Block until the background writer is no longer writing the given page, so that a newer image of the page is never
+   * overtaken by an older one and a read never sees the page before its write-back lands.
+   * @param page_id id of the page about to be read from or written to disk
+   */
+  void WaitForWriteBack(page_id_t page_id);
+
   /** Number of pages in the buffer pool. */
   const size_t pool_size_;
   /** How many instances are in the parallel BPM (if present, otherwise just 1 BPI) */
@@ -130,19 +288,79 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** Each BPI maintains its own counter for page_ids to hand out, must ensure they mod back to its instance_index_ */
   std::atomic<page_id_t> next_page_id_ = static_cast<page_id_t>(instance_index_);
 
-  /** Array of buffer pool pages. */
+  /**
+   * Head page of the list of deallocated pages. The rest of the list is on disk, in the pages it chains through, and
+   * only ids of this BPI's own stripe ever go on it. GetPageId() is INVALID_PAGE_ID while the list is empty. Like
+   * next_page_id_, the head itself is not persisted across restarts. Protected by latch_.
+   */
+  FreeListPage free_page_list_;
+  /** True if free_page_list_ has changed since it was last written to disk. */
+  bool free_page_list_dirty_ = false;
+  /**
+   * Whether each page of this BPI's stripe, indexed by page_id / num_instances_, is on the free page list, so that a
+   * page deleted twice is only listed once. Protected by latch_.
+   */
+  std::vector<bool> is_free_page_;
+
+  /** Data of all frames, page-aligned and backed by huge pages if possible. */
+  FrameArena frame_arena_;
+  /** Array of buffer pool pages, holding the metadata of each frame and pointing into frame_arena_ for its data. */
   Page *pages_;
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
+  /** Page table for keeping track of buffer pool pages, sharded by page id. */
+  std::array<PageTableShard, PAGE_TABLE_SHARDS> page_table_;
   /** Replacer to find unpinned pages for replacement. */
   Replacer *replacer_;
   /** List of free pages. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /** Number of fetches that had to go to disk. Only incremented while holding latch_. */
+  std::atomic<size_t> num_misses_ = 0;
+  /** Number of pages read by the prefetch thread. Only incremented while holding latch_. */
+  std::atomic<size_t> num_prefetches_ = 0;
+  /** Number of evictions of clean and of dirty frames. Only incremented while holding latch_. */
+  std::atomic<size_t> num_clean_evictions_ = 0;
+  std::atomic<size_t> num_dirty_evictions_ = 0;
+
+  /** Background writer thread, nullptr if it is not running. */
+  std::thread *writer_thread_ = nullptr;
+  /** How many of the next victims the background writer keeps clean. */
+  size_t num_clean_frames_ = 0;
+  /** Protects writer_running_ and write_back_page_id_. Acquired after latch_ when both are needed. */
+  std::mutex writer_latch_;
+  /** Wakes the background writer up early, either to stop or because a dirty frame was evicted. */
+  std::condition_variable writer_cv_;
+  /** Signaled whenever the background writer finishes writing a page. */
+  std::condition_variable write_back_cv_;
+  /** True while the background writer should keep running. */
+  bool writer_running_ = false;
+  /** The page the background writer is currently writing to disk, INVALID_PAGE_ID if none. */
+  page_id_t write_back_page_id_ = INVALID_PAGE_ID;
+  /** Prefetch thread, nullptr if it has not been started. */
+  std::thread *prefetch_thread_ = nullptr;
+  /** Protects prefetch_queue_ and prefetch_running_. Acquired after latch_ when both are needed. */
+  std::mutex prefetch_latch_;
+  /** Wakes the prefetch thread up when pages are queued or it should stop. */
+  std::condition_variable prefetch_cv_;
+  /** Pages waiting to be read by the prefetch thread. */
+  std::deque<page_id_t> prefetch_queue_;
+  /** True while the prefetch thread should keep running. */
+  bool prefetch_running_ = false;
+  /**
+   * Pages the prefetch thread is reading into reserved frames that are not in the page table yet. Protected by latch_.
+   * Deleting one of these pages removes it from the set, and the prefetch thread then drops its frame.
+   */
+  std::unordered_set<page_id_t> prefetch_in_flight_;
+  /** Signaled, together with latch_, whenever the prefetch thread has published a batch. */
+  std::condition_variable prefetch_done_cv_;
+
+  /**
+   * This latch serializes everything that changes which page lives in which frame: misses, new pages, deletes and
+   * eviction, together with the free list. Hits and unpins of resident pages only take their page table shard latch
+   * in shared mode and adjust the atomic pin count.
+   */
   std::mutex latch_;
 };
 }  // namespace bustub
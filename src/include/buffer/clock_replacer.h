@@ -12,7 +12,7 @@
 
 #pragma once
 
-#include <list>
+#include <atomic>
 #include <mutex>  // NOLINT
 #include <vector>
 
@@ -23,6 +23,10 @@ namespace bustub {
 
 /**
  * ClockReplacer implements the clock replacement policy, which approximates the Least Recently Used policy.
+ *
+ * Each frame has an atomic state that combines "is in the replacer" with its reference bit. Pin and Unpin are a single
+ * relaxed store and take no latch; only Victim, which moves the clock hand, is serialized. Victim claims a frame with a
+ * compare-and-swap, so a concurrent Pin or Unpin of that frame either happens before the claim or wins over it.
  */
 class ClockReplacer : public Replacer {
  public:
@@ -43,10 +47,21 @@ class ClockReplacer : public Replacer {
 
   void Unpin(frame_id_t frame_id) override;
 
+  /** @return the number of frames in the replacer. Counts the frames, so it is O(num_pages). */
   size_t Size() override;
 
+  std::vector<frame_id_t> PeekVictims(size_t max_frames) override;
+
  private:
-  // TODO(student): implement me!
+  /** Frame states. */
+  static constexpr uint8_t ABSENT = 0;
+  static constexpr uint8_t UNREFERENCED = 1;
+  static constexpr uint8_t REFERENCED = 2;
+
+  std::vector<std::atomic<uint8_t>> frames_;
+  /** The clock hand, i.e. the next frame Victim looks at. Protected by latch_. */
+  size_t hand_{0};
+  std::mutex latch_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.h
+//
+// Identification: src/include/buffer/frame_arena.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * FrameArena holds the data of all frames of a buffer pool in one page-aligned region, apart from the Page objects that
+ * hold the frame metadata and latches. The region is backed by 2 MB huge pages when the system has them reserved, and
+ * otherwise asks for transparent huge pages, so that a pool of a few GB needs thousands rather than millions of TLB
+ * entries. The region can be placed on a chosen NUMA node.
+ */
+class FrameArena {
+ public:
+  /** How the arena memory is backed. */
+  enum class HugePageMode { NONE, TRANSPARENT, HUGETLB };
+
+  /**
+   * Map the data region of a buffer pool. The memory is zeroed.
+   * @param num_frames number of frames in the buffer pool
+   * @param huge_pages true to back the region with huge pages if possible
+   * @param numa_node the NUMA node to place the region on, -1 to leave placement to the OS
+   */
+  FrameArena(size_t num_frames, bool huge_pages, int numa_node = -1);
+
+  /** Unmap the data region. */
+  ~FrameArena();
+
+  FrameArena(const FrameArena &) = delete;
+  FrameArena &operator=(const FrameArena &) = delete;
+
+  /**
+   * @param frame_id id of a frame
+   * @return the PAGE_SIZE bytes of data of the frame, aligned to PAGE_SIZE
+   */
+  char *GetFrameData(frame_id_t frame_id) { return data_ + static_cast<size_t>(frame_id) * PAGE_SIZE; }
+
+  /** @return how the data region is backed */
+  HugePageMode GetHugePageMode() const { return huge_page_mode_; }
+
+  /** @return the NUMA node the data region was placed on, -1 if placement was left to the OS */
+  int GetNumaNode() const { return numa_node_; }
+
+  /** @return the number of NUMA nodes of the system, at least 1 */
+  static size_t GetNumNumaNodes();
+
+  /** Size of the huge pages the data region is backed with. */
+  static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+ private:
+  /** Start of the data region. */
+  char *data_ = nullptr;
+  /** Size of the mapping in bytes. */
+  size_t size_ = 0;
+  HugePageMode huge_page_mode_ = HugePageMode::NONE;
+  int numa_node_ = -1;
+};
+
+}  // namespace bustub
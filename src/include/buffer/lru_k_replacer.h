@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.h
+//
+// Identification: src/include/buffer/lru_k_replacer.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <mutex>  // NOLINT
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy.
+ *
+ * Every Pin counts as an access to the frame, and so does every RecordAccess of a frame that is already pinned. The
+ * victim is the evictable frame whose K-th most recent access is the oldest. Frames with fewer than K accesses have an
+ * infinite backward K-distance and are always victimized first, in order of their first access. A page that is touched once, e.g. by a sequential scan, therefore never pushes out a
+ * page that is accessed repeatedly. A frame's access history is forgotten when it is victimized.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k the number of accesses remembered per frame
+   */
+  explicit LRUKReplacer(size_t num_pages, size_t k = LRUK_REPLACER_K);
+
+  /**
+   * Destroys the LRUKReplacer.
+   */
+  ~LRUKReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void RecordAccess(frame_id_t frame_id) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+  std::vector<frame_id_t> PeekVictims(size_t max_frames) override;
+
+ private:
+  struct FrameInfo {
+    /** Timestamps of the last (up to) k accesses, oldest first. */
+    std::deque<uint64_t> history_;
+    bool evictable_{false};
+  };
+
+  /** Record an access to the frame. The frame must not be in a queue. */
+  void RecordAccess(FrameInfo *frame_info);
+
+  /** @return the queue an evictable frame belongs in, depending on how many accesses it has */
+  std::set<std::pair<uint64_t, frame_id_t>> *QueueOf(const FrameInfo &frame_info);
+
+  size_t k_;
+  uint64_t current_timestamp_{0};
+  std::vector<FrameInfo> frames_;
+  /** Evictable frames with fewer than k accesses, ordered by their first access. */
+  std::set<std::pair<uint64_t, frame_id_t>> history_queue_;
+  /** Evictable frames with k accesses, ordered by their k-th most recent access. */
+  std::set<std::pair<uint64_t, frame_id_t>> cache_queue_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
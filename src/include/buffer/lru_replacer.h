@@ -12,9 +12,7 @@
 
 #pragma once
 
-#include <list>
 #include <mutex>  // NOLINT
-#include <unordered_map>
 #include <vector>
 
 #include "buffer/replacer.h"
@@ -23,7 +21,7 @@
 namespace bustub {
 
 /**
- * LRUReplacer implements the Least Recently Used replacement policy.
+ * LRUReplacer implements the Least Recently Used replacement policy. Frame ids must be in [0, num_pages).
  */
 class LRUReplacer : public Replacer {
  public:
@@ -46,26 +44,24 @@ class LRUReplacer : public Replacer {
 
   size_t Size() override;
 
- private:
-  // TODO(student): implement me!
-  struct FrameInfo {
-    explicit FrameInfo(frame_id_t frame_id) : frame_id_(frame_id), prev_(nullptr), next_(nullptr) {}
+  std::vector<frame_id_t> PeekVictims(size_t max_frames) override;
 
-    frame_id_t frame_id_;
-    //    uint64_t last_access_time_;
-    FrameInfo *prev_;
-    FrameInfo *next_;
-  };
-  //  /**
-  //   * Change the location of the frame to tail.
-  //   * @param frame_info a frame info pointer
-  //   */
-  //  void Modify(FrameInfo *frame_info);
+ private:
+  /** Unlink a frame that is in the list. The caller must hold latch_. */
+  void Unlink(frame_id_t frame_id);
 
-  FrameInfo *head_;
-  FrameInfo *tail_;
+  /** Marks a frame that is not in the list. */
+  static constexpr frame_id_t NOT_IN_LIST = -1;
 
-  std::unordered_map<frame_id_t, FrameInfo *> frame_holders_ = {};
+  /**
+   * Links of an intrusive, circular doubly linked list indexed by frame id, so that Pin, Unpin and Victim never
+   * allocate. Index num_pages_ is the sentinel: its next is the least recently unpinned frame, its prev the most
+   * recently unpinned one. prev_ is NOT_IN_LIST for frames that are not in the replacer.
+   */
+  std::vector<frame_id_t> prev_;
+  std::vector<frame_id_t> next_;
+  /** Number of frames in the list. */
+  size_t size_{0};
   size_t num_pages_;
   std::mutex latch_;
 };
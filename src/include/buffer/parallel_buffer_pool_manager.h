@@ -25,14 +25,16 @@ namespace bustub {
 class ParallelBufferPoolManager : public BufferPoolManager {
  public:
   /**
-   * Creates a new ParallelBufferPoolManager.
+   * Creates a new ParallelBufferPoolManager. On a NUMA system the instances are spread round-robin over the nodes, and
+   * each instance keeps its frame data on its node.
    * @param num_instances the number of individual BufferPoolManagerInstances to store
    * @param pool_size the pool size of each BufferPoolManagerInstance
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy of every BufferPoolManagerInstance
    */
   ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
-                            LogManager *log_manager = nullptr);
+                            LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::LRU);
 
   /**
    * Destroys an existing ParallelBufferPoolManager.
@@ -42,12 +44,36 @@ class ParallelBufferPoolManager : public BufferPoolManager {
   /** @return size of the buffer pool */
   size_t GetPoolSize() override;
 
+  /** @return the number of clean evictions summed over all BufferPoolManagerInstances */
+  size_t GetNumCleanEvictions();
+
+  /** @return the number of dirty evictions summed over all BufferPoolManagerInstances */
+  size_t GetNumDirtyEvictions();
+
+  /** @return a snapshot of the counters of every BufferPoolManagerInstance, indexed by instance */
+  std::vector<BufferPoolStats> GetInstanceStats();
+
+  /**
+   * Start a background writer in every BufferPoolManagerInstance.
+   * @param num_clean_frames how many of the next victims each instance's writer tries to keep clean
+   */
+  void StartBackgroundWriter(size_t num_clean_frames);
+
+  /** Stop the background writers of all BufferPoolManagerInstances. */
+  void StopBackgroundWriter();
+
+  /**
+   * Hand each page to the BufferPoolManagerInstance responsible for it to be read ahead.
+   * @param page_ids ids of the pages that are about to be fetched
+   */
+  void PrefetchPages(const std::vector<page_id_t> &page_ids) override;
+
  protected:
   /**
    * @param page_id id of page
    * @return pointer to the BufferPoolManager responsible for handling given page id
    */
-  BufferPoolManager *GetBufferPoolManager(page_id_t page_id);
+  BufferPoolManagerInstance *GetBufferPoolManager(page_id_t page_id);
 
   /**
    * Fetch the requested page from the buffer pool.
@@ -72,7 +98,10 @@ class ParallelBufferPoolManager : public BufferPoolManager {
   bool FlushPgImp(page_id_t page_id) override;
 
   /**
-   * Creates a new page in the buffer pool.
+   * Creates a new page in the buffer pool. Each thread has a home instance it allocates from, so that concurrent
+   * inserters spread over the instances without coordinating. If the home instance has no free frame, the free frames
+   * of the other instances are used, starting with the next one, before any page is evicted. So a single thread fills
+   * the whole pool rather than just evicting within its home instance.
    * @param[out] page_id id of created page
    * @return nullptr if no new pages could be created, otherwise pointer to new page
    */
@@ -93,8 +122,6 @@ class ParallelBufferPoolManager : public BufferPoolManager {
  private:
   // all the bmis it manages
   std::vector<BufferPoolManagerInstance *> buffer_pool_manager_instances_;
-  // Maintain the starting index of bmi when newing a page.
-  size_t starting_index_ = 0;
 };
 
 }  // namespace bustub
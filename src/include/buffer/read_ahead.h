@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// read_ahead.h
+//
+// Identification: src/include/buffer/read_ahead.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * ReadAhead keeps the pages a scan is about to visit prefetched in the buffer pool. The scan walks a sequence of pages,
+ * e.g. the pages of a TableHeap or the leaves of a B+ tree, and reports every page it moves onto.
+ *
+ * The window is filled in batches: once it is half empty, the pages following its last page are looked up and
+ * prefetched together. How many can be found at once depends on the structure. A B+ tree leaf's parent lists a whole
+ * run of following leaves, while a table page only knows its direct successor, so a heap scan reads one page ahead.
+ */
+class ReadAhead {
+ public:
+  /**
+   * Looks up the pages that follow a page in scan order.
+   * @param buffer_pool_manager the buffer pool to fetch the page and its neighbours from
+   * @param page_id the page to start after
+   * @param[out] page_ids the following pages, in scan order
+   * @param max_pages the maximum number of pages to return
+   * @return the number of pages written to page_ids, 0 at the end of the sequence
+   */
+  using FollowingPagesFn = size_t (*)(BufferPoolManager *buffer_pool_manager, page_id_t page_id, page_id_t *page_ids,
+                                      size_t max_pages);
+
+  /**
+   * @param buffer_pool_manager the buffer pool the scan fetches its pages from
+   * @param following_pages_fn how to find the pages that follow a page
+   * @param window_size how many pages to keep prefetched ahead of the scan, 0 disables read-ahead
+   */
+  ReadAhead(BufferPoolManager *buffer_pool_manager, FollowingPagesFn following_pages_fn,
+            size_t window_size = scan_read_ahead_pages);
+
+  /**
+   * Tell the read-ahead that the scan has moved onto the given page. Calling it again for the same page does nothing.
+   * @param page_id the page the scan is on
+   */
+  void OnPage(page_id_t page_id);
+
+  /**
+   * Tell the read-ahead that the scan will stop on the given page, so that no page after it is prefetched. The scan may
+   * still move past it, it is just not read ahead of time.
+   * @param page_id the last page the scan needs
+   */
+  void SetLastPage(page_id_t page_id) { stop_page_id_ = page_id; }
+
+ private:
+  /**
+   * Prefetch up to max_pages pages following the given one and make the last of them the end of the window.
+   * @return the number of pages prefetched
+   */
+  size_t Extend(page_id_t page_id, size_t max_pages);
+
+  BufferPoolManager *buffer_pool_manager_;
+  FollowingPagesFn following_pages_fn_;
+  size_t window_size_;
+  /** The page the scan is on. */
+  page_id_t current_page_id_ = INVALID_PAGE_ID;
+  /** The last page that was prefetched, INVALID_PAGE_ID once the end of the sequence has been reached. */
+  page_id_t last_page_id_ = INVALID_PAGE_ID;
+  /** Number of pages after the current one up to and including last_page_id_. */
+  size_t num_ahead_ = 0;
+  /** The last page the scan needs, INVALID_PAGE_ID if it runs to the end of the sequence. */
+  page_id_t stop_page_id_ = INVALID_PAGE_ID;
+};
+
+}  // namespace bustub
@@ -12,10 +12,15 @@
 
 #pragma once
 
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
 
+/** The replacement policies a buffer pool can be configured with. */
+enum class ReplacerType { LRU, LRU_K, CLOCK };
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -43,8 +48,28 @@ class Replacer {
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Counts an access to a frame that is already pinned. Only replacers that keep an access history need it.
+   * @param frame_id the id of the frame that was accessed
+   */
+  virtual void RecordAccess(frame_id_t frame_id) {}
+
+  /**
+   * Takes a frame whose page is being freed out of the replacer, forgetting what the replacer knows about it, without
+   * counting as an access.
+   * @param frame_id the id of the frame to remove
+   */
+  virtual void Remove(frame_id_t frame_id) { Pin(frame_id); }
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
+
+  /**
+   * Look at the frames that would be victimized next without removing them from the replacer.
+   * @param max_frames the maximum number of frames to return
+   * @return up to max_frames frame ids, the next victim first
+   */
+  virtual std::vector<frame_id_t> PeekVictims(size_t max_frames) { return {}; }
 };
 
 }  // namespace bustub
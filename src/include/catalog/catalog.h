@@ -20,9 +20,12 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
+#include "common/exception.h"
 #include "container/hash/hash_function.h"
+#include "storage/index/b_plus_tree_index.h"
 #include "storage/index/extendible_hash_table_index.h"
 #include "storage/index/index.h"
+#include "storage/page/header_page.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -34,6 +37,9 @@ using table_oid_t = uint32_t;
 using column_oid_t = uint32_t;
 using index_oid_t = uint32_t;
 
+/** The kinds of index the catalog can build. */
+enum class IndexType { HashTable, BPlusTree };
+
 /**
  * The TableInfo class maintains metadata about a table.
  */
@@ -69,15 +75,17 @@ struct IndexInfo {
    * @param index_oid The unique OID for the index
    * @param table_name The name of the table on which the index is created
    * @param key_size The size of the index key, in bytes
+   * @param index_type The kind of index
    */
   IndexInfo(Schema key_schema, std::string name, std::unique_ptr<Index> &&index, index_oid_t index_oid,
-            std::string table_name, size_t key_size)
+            std::string table_name, size_t key_size, IndexType index_type = IndexType::HashTable)
       : key_schema_{std::move(key_schema)},
         name_{std::move(name)},
         index_{std::move(index)},
         index_oid_{index_oid},
         table_name_{std::move(table_name)},
-        key_size_{key_size} {}
+        key_size_{key_size},
+        index_type_{index_type} {}
   /** The schema for the index key */
   Schema key_schema_;
   /** The name of the index */
@@ -90,6 +98,8 @@ struct IndexInfo {
   std::string table_name_;
   /** The size of the index key, in bytes */
   const size_t key_size_;
+  /** The kind of index; a B+ tree index is a BPlusTreeIndex on GenericKey<key_size_> */
+  const IndexType index_type_;
 };
 
 /**
@@ -185,13 +195,15 @@ class Catalog {
    * @param key_schema The schema of the key
    * @param key_attrs Key attributes
    * @param keysize Size of the key
-   * @param hash_function The hash function for the index
+   * @param hash_function The hash function for the index, unused by a B+ tree index
+   * @param index_type The kind of index to build
    * @return A (non-owning) pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   IndexInfo *CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
                          const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
-                         std::size_t keysize, HashFunction<KeyType> hash_function) {
+                         std::size_t keysize, HashFunction<KeyType> hash_function,
+                         IndexType index_type = IndexType::HashTable) {
     // Reject the creation request for nonexistent table
     if (table_names_.find(table_name) == table_names_.end()) {
       return NULL_INDEX_INFO;
@@ -211,25 +223,30 @@ class Catalog {
     auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs);
 
     // Construct the index, take ownership of metadata
-    // TODO(Kyle): We should update the API for CreateIndex
-    // to allow specification of the index type itself, not
-    // just the key, value, and comparator types
-    auto index = std::make_unique<ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
-                                                                                               hash_function);
+    std::unique_ptr<Index> index;
+    if (index_type == IndexType::BPlusTree) {
+      index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
+                                                                                  GetIndexHeaderPage());
+    } else {
+      index = std::make_unique<ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
+                                                                                             hash_function);
+    }
 
-    // Populate the index with all tuples in table heap
+    // Populate the index with all tuples in table heap, in one go so the index can build itself bottom-up
     auto *table_meta = GetTable(table_name);
     auto *heap = table_meta->table_.get();
+    std::vector<std::pair<Tuple, RID>> entries;
     for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
-      index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+      entries.emplace_back(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid());
     }
+    index->BulkLoad(entries, txn);
 
     // Get the next OID for the new index
     const auto index_oid = next_index_oid_.fetch_add(1);
 
     // Construct index information; IndexInfo takes ownership of the Index itself
-    auto index_info =
-        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
+    auto index_info = std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name,
+                                                  keysize, index_type);
     auto *tmp = index_info.get();
 
     // Update internal tracking
@@ -323,6 +340,25 @@ class Catalog {
   }
 
  private:
+  /**
+   * The header page in which the B+ tree indexes record their root page ids. Page 0 may already belong to a table, so
+   * the catalog allocates its own the first time it is needed.
+   * @return The page id of the header page
+   */
+  page_id_t GetIndexHeaderPage() {
+    if (index_header_page_id_ == INVALID_PAGE_ID) {
+      page_id_t page_id;
+      auto *header_page = static_cast<HeaderPage *>(bpm_->NewPage(&page_id));
+      if (header_page == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "buffer pool out of memory");
+      }
+      header_page->Init();
+      bpm_->UnpinPage(page_id, true);
+      index_header_page_id_ = page_id;
+    }
+    return index_header_page_id_;
+  }
+
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] LockManager *lock_manager_;
   [[maybe_unused]] LogManager *log_manager_;
@@ -352,6 +388,9 @@ class Catalog {
 
   /** The next index identifier to be used. */
   std::atomic<index_oid_t> next_index_oid_{0};
+
+  /** The header page of the B+ tree indexes, INVALID_PAGE_ID until the first one is created. */
+  page_id_t index_header_page_id_{INVALID_PAGE_ID};
 };
 
 }  // namespace bustub
@@ -14,6 +14,7 @@
 
 #include <atomic>
 #include <chrono>  // NOLINT
+#include <cstddef>
 #include <cstdint>
 
 namespace bustub {
@@ -27,6 +28,30 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** A running buffer pool background writer looks for dirty frames to clean every BACKGROUND_WRITER_INTERVAL. */
+extern std::chrono::milliseconds background_writer_interval;
+
+/**
+ * A running B+ tree background compaction merges leaves that are less than half full every
+ * BTREE_COMPACTION_INTERVAL.
+ */
+extern std::chrono::milliseconds btree_compaction_interval;
+
+/** Index scans keep up to SCAN_READ_AHEAD_PAGES leaves ahead of them prefetched, 0 disables read-ahead. */
+extern size_t scan_read_ahead_pages;
+
+/**
+ * Table scans keep up to TABLE_SCAN_READ_AHEAD_PAGES pages ahead of them prefetched. It is 0, i.e. off, by default: a
+ * table page only knows its successor, so the heap is read ahead one page at a time, which costs more than it saves.
+ */
+extern size_t table_scan_read_ahead_pages;
+
+/**
+ * If BUFFER_POOL_HUGE_PAGES is true, buffer pools back their frame data with 2 MB huge pages when the system has
+ * them.
+ */
+extern bool buffer_pool_huge_pages;
+
 static constexpr int INVALID_PAGE_ID = -1;                                    // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                     // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                        // invalid log sequence number
@@ -35,6 +60,7 @@ static constexpr int PAGE_SIZE = 4096;                                        //
 static constexpr int BUFFER_POOL_SIZE = 10;                                   // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr size_t LRUK_REPLACER_K = 2;                                  // lookback window for lru-k replacer
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -16,6 +16,7 @@
 #include <cstdint>
 #include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
@@ -79,6 +80,22 @@ class ExtendibleHashTable {
    */
   bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result);
 
+  /**
+   * Builds this empty hash table from key-value pairs in any order. The input is partitioned by hash prefix, the
+   * directory is sized for it up front and every bucket is written once, filled to at most fill_factor of its
+   * capacity, instead of growing the table one split at a time.
+   *
+   * @param first the first key-value pair
+   * @param last past the last key-value pair
+   * @param fill_factor the share of a bucket's capacity a bucket is filled to, unless the directory is full
+   * @return false, leaving the table alone, if the table is not empty
+   */
+  template <typename Iterator>
+  bool BulkLoad(Iterator first, Iterator last, double fill_factor = 0.9) {
+    std::vector<MappingType> items(first, last);
+    return BulkLoad(&items, fill_factor);
+  }
+
   /**
    * Returns the global depth.  Do not touch.
    */
@@ -93,7 +110,7 @@ class ExtendibleHashTable {
 
  private:
   /**
-   * Hash - simple helper to downcast MurmurHash's 64-bit hash to 32-bit
+   * Hash - simple helper to downcast the hash function's 64-bit hash to 32-bit
    * for extendible hashing.
    *
    * @param key the key to hash
@@ -151,20 +168,48 @@ class ExtendibleHashTable {
   HASH_TABLE_BUCKET_TYPE *FetchBucketPage(page_id_t bucket_page_id);
 
   /**
-   * Performs insertion with an optional bucket splitting.
+   * Reads the bucket page_id of a hash from the directory page without latching it, retrying until no directory
+   * change overlapped the read.
    *
-   * @param transaction a pointer to the current transaction
-   * @param key the key to insert
-   * @param value the value to insert
-   * @return whether or not the insertion was successful
+   * @param dir_raw_page the pinned directory page
+   * @param hash the hash of the key
+   * @return the bucket page_id the directory maps the hash to
+   */
+  page_id_t ReadBucketPageId(Page *dir_raw_page, uint32_t hash);
+
+  /**
+   * Fetches and latches the bucket page of a hash. The directory slots of a bucket only change while the bucket is
+   * write latched, so once the directory still maps the hash to the latched bucket, it keeps doing so until the
+   * bucket is unlatched.
+   *
+   * @param dir_raw_page the pinned directory page
+   * @param hash the hash of the key
+   * @param exclusive true to write latch the bucket page, false to read latch it
+   * @return the pinned and latched bucket page
+   */
+  Page *LatchBucketPage(Page *dir_raw_page, uint32_t hash, bool exclusive);
+
+  /**
+   * Splits a full bucket, doubling the directory first if the bucket's local depth is the global depth. Only the
+   * bucket, the new bucket and, while its slots are updated, the directory page are latched.
+   *
+   * @param dir_raw_page the pinned directory page
+   * @param bucket_raw_page the full bucket page, write latched by the caller, which stays latched
+   * @param hash the hash of the key that did not fit
+   * @return false if the bucket can't be split
+   */
+  bool SplitBucket(Page *dir_raw_page, Page *bucket_raw_page, uint32_t hash);
+
+  /**
+   * When spliting a bucket, move the kvs in the old bucket whose hash has the new local high bit set into the new
+   * bucket.
    */
-  bool SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value);
+  void RehashKvs(HASH_TABLE_BUCKET_TYPE *old_page, uint32_t local_high_bit, HASH_TABLE_BUCKET_TYPE *new_page);
 
   /**
-   * When spliting a bucket, rehash the kvs in the old bucket and decide whether to put them
-   * into the old or new bucket.
+   * Builds the table from the items if it is empty, see the public BulkLoad.
    */
-  void RehashKvs(HASH_TABLE_BUCKET_TYPE *old_page, HashTableDirectoryPage *dir_page, HASH_TABLE_BUCKET_TYPE *new_page);
+  bool BulkLoad(std::vector<MappingType> *items, double fill_factor);
 
   /**
    * Optionally merges an empty bucket into it's pair.  This is called by Remove,
@@ -186,8 +231,6 @@ class ExtendibleHashTable {
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writers are splits and merges
-  ReaderWriterLatch table_latch_;
   HashFunction<KeyType> hash_fn_;
 };
 
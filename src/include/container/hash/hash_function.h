@@ -12,9 +12,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <type_traits>
 
-#include "murmur3/MurmurHash3.h"
+#include "common/util/hash_util.h"
 
 namespace bustub {
 
@@ -26,11 +28,21 @@ class HashFunction {
    * @return the hashed value
    */
   virtual uint64_t GetHash(KeyType key) {
-    uint64_t hash[2];
-    murmur3::MurmurHash3_x64_128(reinterpret_cast<const void *>(&key), static_cast<int>(sizeof(KeyType)), 0,
-                                 reinterpret_cast<void *>(&hash));
-    return hash[0];
+    if constexpr (std::is_integral_v<KeyType>) {
+      return HashUtil::Hash(&key);
+    } else {
+      return HashUtil::HashBytes(reinterpret_cast<const char *>(&key), key_length_);
+    }
   }
+
+  /**
+   * Hash only the first key_length bytes of a key, e.g. the ones its comparator looks at, so that the padding of a
+   * GenericKey neither costs time nor tells equal keys apart.
+   */
+  void SetKeyLength(size_t key_length) { key_length_ = std::min(key_length, sizeof(KeyType)); }
+
+ private:
+  size_t key_length_{sizeof(KeyType)};
 };
 
 }  // namespace bustub
@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "common/rwlatch.h"
 #include "concurrency/transaction.h"
 #include "container/hash/hash_function.h"
 #include "container/hash/hash_table.h"
@@ -26,12 +27,17 @@
 
 namespace bustub {
 
-#define HASH_TABLE_TYPE LinearProbeHashTable<KeyType, ValueType, KeyComparator>
+#define LINEAR_PROBE_HASH_TABLE_TYPE LinearProbeHashTable<KeyType, ValueType, KeyComparator>
 
 /**
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
- * table dynamically grows once full.
+ * table dynamically grows once three quarters of its buckets are occupied.
+ *
+ * A resize is incremental: it allocates the new table and then every insert or
+ * remove moves one block of the old table into it, so no single operation
+ * rehashes the whole table. Until the last block has moved, lookups consult both
+ * tables, and every key/value pair lives in exactly one of them.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
@@ -75,24 +81,94 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
   bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
 
   /**
-   * Resizes the table to at least twice the initial size provided.
+   * Resizes the table to at least twice the initial size provided. The pairs
+   * move to the new table over the following inserts and removes; a resize
+   * that is still moving them is finished first, and if it can't be, the
+   * table is not resized.
    * @param initial_size the initial size of the hash table
    */
   void Resize(size_t initial_size);
 
   /**
    * Gets the size of the hash table
-   * @return current size of the hash table
+   * @return current size of the hash table, 0 if its header page can't be fetched
    */
   size_t GetSize();
 
+  /**
+   * @return whether a resize is still moving pairs out of the old table
+   */
+  bool IsResizing();
+
  private:
+  /** What a probe does after visiting a bucket */
+  enum class ProbeAction { NEXT, STOP, STOP_DIRTY };
+
+  /**
+   * Allocates a table of num_buckets buckets, rounded up to whole blocks and
+   * capped at the blocks a header page can hold.
+   * @return the page id of its header page
+   */
+  page_id_t NewTable(size_t num_buckets);
+
+  /**
+   * Deletes the header and block pages of a table
+   * @return false if its header page could not be fetched
+   */
+  bool DeleteTable(page_id_t header_page_id);
+
+  /**
+   * Visits the buckets of a table in the probe order of key, starting at its
+   * home bucket, until visit stops the probe or it has been all the way round.
+   * @param[out] stopped whether visit stopped the probe
+   * @return false if a page of the table could not be fetched
+   */
+  template <typename Visitor>
+  bool Probe(page_id_t header_page_id, const KeyType &key, Visitor visit, bool *stopped);
+
+  /**
+   * Appends the values of key in one table to result
+   * @return false if a page of the table could not be fetched
+   */
+  bool GetValueFrom(page_id_t header_page_id, const KeyType &key, std::vector<ValueType> *result);
+
+  /** Insert on one table; sets *full if every bucket of the table is occupied */
+  bool InsertInto(page_id_t header_page_id, const KeyType &key, const ValueType &value, bool *full);
+
+  /** Remove on one table */
+  bool RemoveFrom(page_id_t header_page_id, const KeyType &key, const ValueType &value);
+
+  /**
+   * Moves the next block of the old table into the new one, and drops the old table after its last block
+   * @return false if the block could not be moved, because a page could not be fetched or the new table is full
+   */
+  bool MigrateBlock();
+
+  /**
+   * Starts a resize to a table of at least num_buckets buckets, after finishing the one in progress
+   * @return false if the one in progress could not be finished
+   */
+  bool StartResize(size_t num_buckets);
+
+  /**
+   * Starts a resize if three quarters of the buckets of the table are occupied
+   * @return false if the header page could not be fetched
+   */
+  bool MaybeResize();
+
   // member variable
   page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writer is only resize
+  // The table being resized away from, INVALID_PAGE_ID if there is no resize, and its next block to move
+  page_id_t old_header_page_id_{INVALID_PAGE_ID};
+  size_t next_block_index_{0};
+  // Occupied buckets (pairs and tombstones) of the current table, and pairs in both tables
+  size_t num_occupied_{0};
+  size_t num_readable_{0};
+
+  // Readers are lookups, writers are inserts, removes and resizes
   ReaderWriterLatch table_latch_;
 
   // Hash function
@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
+#include "catalog/catalog.h"
 #include "common/rid.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
@@ -22,12 +24,24 @@
 
 namespace bustub {
 
+/** Reads the record ids of an index scan out of the index, see index_scan_executor.cpp. */
+class IndexRidReader;
+
 /**
  * IndexScanExecutor executes an index scan over a table.
+ *
+ * A predicate that compares the key column of a single-column B+ tree index with a constant becomes the key range the
+ * scan walks; other predicates walk the whole index. Either way the predicate is checked on every tuple.
+ *
+ * The record ids of the range are read from the index when the scan starts, so no index page stays pinned while a
+ * parent executor changes the index. Their tuples are fetched BATCH_SIZE at a time and page by page, so a table page
+ * is pinned once per batch rather than once per tuple. Tuples still come out in key order.
  */
-
 class IndexScanExecutor : public AbstractExecutor {
  public:
+  /** The number of tuples fetched from the table at a time. */
+  static constexpr size_t BATCH_SIZE = 64;
+
   /**
    * Creates a new index scan executor.
    * @param exec_ctx the executor context
@@ -35,6 +49,8 @@ class IndexScanExecutor : public AbstractExecutor {
    */
   IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan);
 
+  ~IndexScanExecutor() override;
+
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
 
   void Init() override;
@@ -42,7 +58,22 @@ class IndexScanExecutor : public AbstractExecutor {
   bool Next(Tuple *tuple, RID *rid) override;
 
  private:
+  /**
+   * Take the next batch of record ids from reader_ and fetch their tuples into batch_.
+   * @return false if the scan has no more record ids
+   */
+  bool FetchBatch();
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
+  /** The index being scanned. */
+  IndexInfo *index_info_{nullptr};
+  /** The table the index is on. */
+  TableInfo *table_info_{nullptr};
+  /** Where the record ids come from. */
+  std::unique_ptr<IndexRidReader> reader_;
+  /** The tuples of the current batch in key order, and the next one to return. */
+  std::vector<Tuple> batch_;
+  size_t batch_index_{0};
 };
 }  // namespace bustub
@@ -53,6 +53,9 @@ class ComparisonExpression : public AbstractExpression {
     return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
   }
 
+  /** @return the type of comparison this expression performs */
+  ComparisonType GetComparisonType() const { return comp_type_; }
+
  private:
   CmpBool PerformComparison(const Value &lhs, const Value &rhs) const {
     switch (comp_type_) {
@@ -27,24 +27,31 @@ class IndexScanPlanNode : public AbstractPlanNode {
    * @param output the output format of this scan plan node
    * @param predicate the predicate to scan with, tuples are returned if predicate(tuple) == true or predicate ==
    * nullptr
-   * @param table_oid the identifier of table to be scanned
+   * @param index_oid the identifier of the index to be scanned
+   * @param descending true to return tuples in descending key order
    */
-  IndexScanPlanNode(const Schema *output, const AbstractExpression *predicate, index_oid_t index_oid)
-      : AbstractPlanNode(output, {}), predicate_{predicate}, index_oid_(index_oid) {}
+  IndexScanPlanNode(const Schema *output, const AbstractExpression *predicate, index_oid_t index_oid,
+                    bool descending = false)
+      : AbstractPlanNode(output, {}), predicate_{predicate}, index_oid_(index_oid), descending_(descending) {}
 
   PlanType GetType() const override { return PlanType::IndexScan; }
 
   /** @return the predicate to test tuples against; tuples should only be returned if they evaluate to true */
   const AbstractExpression *GetPredicate() const { return predicate_; }
 
-  /** @return the identifier of the table that should be scanned */
+  /** @return the identifier of the index that should be scanned */
   index_oid_t GetIndexOid() const { return index_oid_; }
 
+  /** @return true if tuples are returned in descending key order */
+  bool IsDescending() const { return descending_; }
+
  private:
   /** The predicate that all returned tuples must satisfy. */
   const AbstractExpression *predicate_;
-  /** The table whose tuples should be scanned. */
+  /** The index whose tuples should be scanned. */
   index_oid_t index_oid_;
+  /** True if the index is scanned from its last key down. */
+  bool descending_;
 };
 
 }  // namespace bustub
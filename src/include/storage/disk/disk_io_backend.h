@@ -0,0 +1,199 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_io_backend.h
+//
+// Identification: src/include/storage/disk/disk_io_backend.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <linux/io_uring.h>
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * A single page read or write against the database file.
+ */
+struct DiskRequest {
+  /** True for a write, false for a read. */
+  bool is_write_;
+  /** The page to read or write. */
+  page_id_t page_id_;
+  /** The page contents for a write, or the output buffer of PAGE_SIZE bytes for a read. */
+  char *data_;
+};
+
+/**
+ * DiskIOBackend performs page I/O on an open file descriptor. Implementations may keep several requests in flight at
+ * once, and several threads may call Execute concurrently.
+ */
+class DiskIOBackend {
+ public:
+  explicit DiskIOBackend(int fd) : fd_(fd) {}
+  virtual ~DiskIOBackend() = default;
+
+  /**
+   * Perform the given requests and return once all of them have completed. Reads past the end of the file fill the
+   * rest of the buffer with zeros.
+   * @param requests the requests to perform
+   * @param num_requests the number of requests
+   */
+  virtual void Execute(DiskRequest *requests, size_t num_requests) = 0;
+
+ protected:
+  /** Perform one request synchronously with pread/pwrite. */
+  void ExecuteOne(const DiskRequest &request);
+
+  /**
+   * Account for the result of one request.
+   * @param request the request that completed
+   * @param result the number of bytes transferred, or a negative errno
+   */
+  static void Complete(const DiskRequest &request, ssize_t result);
+
+  /** The database file. */
+  int fd_;
+};
+
+/**
+ * ThreadPoolDiskIOBackend hands the requests of a batch to a pool of threads that each issue blocking pread/pwrite
+ * calls, so that a batch of n requests has up to min(n, num_threads) of them in flight. A single request is executed
+ * on the calling thread.
+ */
+class ThreadPoolDiskIOBackend : public DiskIOBackend {
+ public:
+  /**
+   * @param fd the database file
+   * @param num_threads the number of I/O threads
+   */
+  ThreadPoolDiskIOBackend(int fd, size_t num_threads);
+  ~ThreadPoolDiskIOBackend() override;
+
+  void Execute(DiskRequest *requests, size_t num_requests) override;
+
+ private:
+  /** The requests of one Execute call that are not done yet. */
+  struct Batch {
+    size_t remaining_;
+    std::condition_variable done_;
+  };
+
+  /** Body of the I/O threads. */
+  void RunWorker();
+
+  std::vector<std::thread> workers_;
+  /** Protects queue_, shutdown_ and the remaining_ count of every batch. */
+  std::mutex latch_;
+  std::condition_variable queue_cv_;
+  std::deque<std::pair<DiskRequest *, Batch *>> queue_;
+  bool shutdown_ = false;
+};
+
+/**
+ * IOUringDiskIOBackend submits each batch to an io_uring, so all of its requests are in flight together without any
+ * helper threads. The ring is set up with raw system calls. A single request is executed on the calling thread with
+ * pread or pwrite, which lets concurrent single-page callers proceed in parallel.
+ *
+ * The submission and completion queues are shared by all callers and protected by one latch. Each caller queues and
+ * submits its requests under the latch. One caller at a time then waits in the kernel for completions without holding
+ * the latch and reaps them for every caller. The others sleep until their requests are done, and the first of them
+ * takes over waiting when the waiter leaves. So concurrent batches keep each other's requests in flight rather than
+ * queueing up behind one blocking call.
+ *
+ * If io_uring_enter fails with anything but a transient error, the ring is abandoned: the requests still in it fail
+ * with that error, and this and all later batches are executed one request at a time with pread and pwrite.
+ */
+class IOUringDiskIOBackend : public DiskIOBackend {
+ public:
+  /**
+   * Set up an io_uring for the given file.
+   * @param fd the database file
+   * @param queue_depth the number of submission queue entries
+   * @return the backend, or nullptr if io_uring is not available on this system
+   */
+  static std::unique_ptr<IOUringDiskIOBackend> Create(int fd, unsigned queue_depth);
+
+  ~IOUringDiskIOBackend() override;
+
+  void Execute(DiskRequest *requests, size_t num_requests) override;
+
+ private:
+  IOUringDiskIOBackend(int fd, int ring_fd, const io_uring_params &params);
+
+  /**
+   * Submit every queued submission queue entry, including those an earlier call could not submit. The caller must
+   * hold latch_.
+   * @return false if the ring broke, in which case the entries were taken back off the queue
+   */
+  bool Submit();
+
+  /** Abandon the ring after io_uring_enter failed with the given errno, and wake every caller. Must hold latch_. */
+  void BreakRing(int error);
+
+  /** Drain the completion queue and wake the callers whose requests are done. The caller must hold latch_. */
+  void Reap();
+
+  /** The requests of one Execute call that are not done yet. */
+  struct Batch {
+    size_t remaining_;
+    /** Signaled when the last request is reaped, or when the caller has to take over waiting in the kernel. */
+    std::condition_variable done_;
+  };
+
+  /** The in-flight request behind a submission queue entry. */
+  struct Inflight {
+    DiskRequest *request_;
+    Batch *batch_;
+    bool done_ = false;
+    /** True if the ring broke before the kernel took the entry, so the request still has to be executed. */
+    bool taken_back_ = false;
+  };
+
+  int ring_fd_;
+  unsigned sq_entries_;
+  unsigned cq_entries_;
+  /** The mapping that holds both the submission and the completion ring. */
+  void *ring_;
+  size_t ring_size_;
+  /** The mapped submission queue entries. */
+  io_uring_sqe *sqes_;
+  /** Pointers into the mapped rings. */
+  unsigned *sq_head_;
+  unsigned *sq_tail_;
+  unsigned *sq_mask_;
+  unsigned *sq_array_;
+  unsigned *cq_head_;
+  unsigned *cq_tail_;
+  unsigned *cq_mask_;
+  io_uring_cqe *cqes_;
+
+  /** Number of queued or submitted requests whose completion has not been reaped yet. */
+  unsigned in_flight_ = 0;
+  /** The errno of the io_uring_enter call that broke the ring, 0 while the ring works. */
+  int ring_error_ = 0;
+  /** True while a caller waits in the kernel for completions. Only that caller reaps until it is done waiting. */
+  bool waiting_ = false;
+  /** Protects both rings, in_flight_, ring_error_, waiting_, blocked_ and the remaining_ count of every batch. */
+  std::mutex latch_;
+  /** Signaled when completions are reaped, for the callers waiting for room to queue the rest of their requests. */
+  std::condition_variable reaped_cv_;
+  /** Batches of the callers that have queued all their requests and wait for the waiter to reap them. */
+  std::list<Batch *> blocked_;
+};
+
+}  // namespace bustub
@@ -15,13 +15,18 @@
 #include <atomic>
 #include <fstream>
 #include <future>  // NOLINT
-#include <mutex>   // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 
 #include "common/config.h"
+#include "storage/disk/disk_io_backend.h"
 
 namespace bustub {
 
+/** How DiskManager performs page I/O. IO_URING falls back to THREAD_POOL when io_uring is not available. */
+enum class DiskIOBackendType { IO_URING, THREAD_POOL };
+
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
@@ -31,10 +36,13 @@ class DiskManager {
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param backend_type how pages are read and written
+   * @param direct_io true to bypass the OS page cache with O_DIRECT where the file system supports it
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, DiskIOBackendType backend_type = DiskIOBackendType::IO_URING,
+                       bool direct_io = true);
 
-  ~DiskManager() = default;
+  ~DiskManager();
 
   /**
    * Shut down the disk manager and close all the file resources.
@@ -55,6 +63,20 @@ class DiskManager {
    */
   void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Perform a batch of page reads and writes. The requests are in flight concurrently, so their order is unspecified;
+   * the call returns once all of them are done.
+   * @param requests the requests to perform
+   * @param num_requests the number of requests
+   */
+  void ExecuteRequests(DiskRequest *requests, size_t num_requests);
+
+  /** @return the backend actually in use, which may differ from the requested one */
+  DiskIOBackendType GetBackendType() const { return backend_type_; }
+
+  /** @return true if the database file was opened with O_DIRECT */
+  bool IsDirectIO() const { return direct_io_; }
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
@@ -94,15 +116,23 @@ class DiskManager {
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
-  // stream to write db file
-  std::fstream db_io_;
+  // file descriptor of the db file; pread/pwrite on it need no latch
+  int db_fd_;
   std::string file_name_;
   int num_flushes_;
-  int num_writes_;
+  std::atomic<int> num_writes_;
   bool flush_log_;
   std::future<void> *flush_log_f_;
-  // With multiple buffer pool instances, need to protect file access
-  std::mutex db_io_latch_;
+  DiskIOBackendType backend_type_;
+  bool direct_io_;
+  std::unique_ptr<DiskIOBackend> io_backend_;
+
+  /** io_uring submission queue depth */
+  static constexpr unsigned IO_URING_QUEUE_DEPTH = 64;
+  /** number of I/O threads of the thread pool backend */
+  static constexpr size_t IO_THREAD_POOL_SIZE = 16;
+  /** buffer and file offset alignment required by O_DIRECT */
+  static constexpr size_t DIRECT_IO_ALIGNMENT = 4096;
 };
 
 }  // namespace bustub
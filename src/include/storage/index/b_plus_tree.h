@@ -10,15 +10,19 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
+#include <condition_variable>  // NOLINT
 #include <mutex>
 #include <queue>
 #include <string>
+#include <thread>  // NOLINT
 #include <vector>
 
 #include "concurrency/transaction.h"
 #include "storage/index/index_iterator.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_posting_page.h"
 
 namespace bustub {
 
@@ -29,7 +33,8 @@ namespace bustub {
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) Keys are unique, unless the tree is built with unique_keys = false; then
+ *     the values of a key that occurs more than once are kept in posting pages
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
@@ -41,25 +46,63 @@ class BPlusTree {
 
  public:
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE,
+                     bool compress_keys = false, bool unique_keys = true, page_id_t header_page_id = HEADER_PAGE_ID);
+
+  ~BPlusTree();
 
   // Returns true if this B+ tree has no keys and values.
   bool IsEmpty() const;
 
-  // Insert a key-value pair into this B+ tree.
+  // Insert a key-value pair into this B+ tree. Returns false if the key is already there and keys are unique.
   bool Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
 
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
-  // return the value associated with a given key
+  // Remove one value of a key from this B+ tree, and the key once it has no value left.
+  void Remove(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  // Let a leaf that loses keys shrink to min_fill of its max size (but never to empty) before Remove() merges or
+  // redistributes it; internal pages still merge below half full. min_fill is at most 0.5, which is the default.
+  // Must be set before the tree is shared.
+  void SetLeafMergeThreshold(double min_fill);
+
+  // Merge or redistribute every leaf under half full, taking back the space a lower merge threshold leaves behind.
+  void Compact(Transaction *transaction = nullptr);
+
+  // Run Compact() every btree_compaction_interval in a background thread until StopBackgroundCompaction().
+  void StartBackgroundCompaction();
+
+  // Stop and join the background compaction thread. Does nothing if it is not running.
+  void StopBackgroundCompaction();
+
+  // return the values associated with a given key
   bool GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
 
+  // Build this empty B+ tree bottom-up from key-value pairs in any order, filling each page to fill_factor of its
+  // capacity. Returns false and leaves the tree alone if it is not empty.
+  template <typename Iterator>
+  bool BulkLoad(Iterator first, Iterator last, double fill_factor = 0.9) {
+    std::vector<MappingType> items(first, last);
+    return BulkLoad(&items, fill_factor);
+  }
+
   // index iterator
   INDEXITERATOR_TYPE Begin();
   INDEXITERATOR_TYPE Begin(const KeyType &key);
   INDEXITERATOR_TYPE End();
 
+  // reverse index iterator, from the last key (or the last key <= key) down to REnd()
+  INDEXITERATOR_TYPE RBegin();
+  INDEXITERATOR_TYPE RBegin(const KeyType &key);
+  INDEXITERATOR_TYPE REnd();
+
+  // iterator over the keys between low_key and high_key, in descending order if reverse, which reaches End() at the
+  // first key out of range without moving on to the next leaf
+  INDEXITERATOR_TYPE Range(const KeyType &low_key, const KeyType &high_key, bool low_inclusive = true,
+                           bool high_inclusive = true, bool reverse = false);
+
   void Print(BufferPoolManager *bpm) {
     ToString(reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(root_page_id_)->GetData()), bpm);
   }
@@ -78,7 +121,7 @@ class BPlusTree {
   // read data from file and remove one by one
   void RemoveFromFile(const std::string &file_name, Transaction *transaction = nullptr);
   // expose for test purpose
-  Page *FindLeafPage(const KeyType &key, bool leftMost = false);
+  Page *FindLeafPage(const KeyType &key, bool leftMost = false, bool rightMost = false);
 
  private:
 
@@ -86,6 +129,8 @@ class BPlusTree {
     SearchKey,
     InsertKey,
     DeleteKey, 
+    // latch a leaf to merge it like DeleteKey, but keep all its ancestors latched
+    CompactKey,
   };
 
 
@@ -93,10 +138,47 @@ class BPlusTree {
 
   void UnLockAndUnpinPages(Transaction *transaction, OperationType type);
 
-  bool GetLeafPageOfKey(const KeyType &key, Page **page, bool leftMost, OperationType type, Transaction *transaction);
+  bool GetLeafPageOfKey(const KeyType &key, Page **page, bool leftMost, OperationType type, Transaction *transaction,
+                        bool rightMost = false);
+
+  Page *GetLeafPageOptimistic(const KeyType &key, bool *holds_root_mutex);
+
+  void UnLockAndUnpinLeafPage(Page *page, bool holds_root_mutex, bool is_dirty);
+
+  bool TryOptimisticInsert(const KeyType &key, const ValueType &value, bool *inserted);
+
+  void RemoveEntry(const KeyType &key, const ValueType *value, Transaction *transaction);
+
+  bool TryOptimisticRemove(const KeyType &key, const ValueType *value);
+
+  bool RemoveValue(LeafPage *leaf_page, const KeyType &key, const ValueType *value);
+
+  bool TryOptimisticGetValue(const KeyType &key, ValueType *value, bool *found);
+
+  void CompactLeaf(const KeyType &key, Transaction *transaction);
+
+  void RunBackgroundCompaction();
 
   void StartNewTree(const KeyType &key, const ValueType &value);
 
+  bool BulkLoad(std::vector<MappingType> *items, double fill_factor);
+
+  static int BulkLoadPageCount(int num_items, int max_items, int min_items, double fill_factor);
+
+  bool IsPostingList(const ValueType &value) const;
+
+  bool AddToPostingList(LeafPage *leaf_page, const KeyType &key, const ValueType &old_value, const ValueType &value);
+
+  void RemoveFromPostingList(LeafPage *leaf_page, const KeyType &key, const ValueType &list, const ValueType &value);
+
+  ValueType NewPostingList(const MappingType *first, const MappingType *last);
+
+  void CollectPostingList(const ValueType &list, std::vector<ValueType> *result);
+
+  void DeletePostingList(const ValueType &list);
+
+  void DeletePostingPage(page_id_t page_id);
+
   bool InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
 
   void InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
@@ -105,8 +187,12 @@ class BPlusTree {
   template <typename N>
   N *Split(N *node);
 
+  void SetPrevPageIdOf(page_id_t page_id, page_id_t prev_page_id, Transaction *transaction);
+
+  int StartIndex(LeafPage *leaf_page, const KeyType &key, bool inclusive, bool reverse) const;
+
   template <typename N>
-  bool CoalesceOrRedistribute(N *node, Transaction *transaction = nullptr);
+  bool CoalesceOrRedistribute(N *node, int min_size, Transaction *transaction = nullptr);
 
   template <typename N>
   bool Coalesce(N **neighbor_node, N **node, BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> **parent,
@@ -127,12 +213,29 @@ class BPlusTree {
  private:
   // member variable
   std::string index_name_;
-  page_id_t root_page_id_;
+  // the header page that records the root page id under index_name_
+  page_id_t header_page_id_;
+  // atomic because optimistic readers load it without holding root_page_mutex_
+  std::atomic<page_id_t> root_page_id_;
   std::mutex root_page_mutex_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  // number of leading key bytes stored in each page entry
+  int key_size_;
+  // false if a key may have several values, see BPlusTreePostingPage
+  bool unique_keys_;
+  // Remove() merges or redistributes a leaf once it has fewer entries, see SetLeafMergeThreshold()
+  int leaf_merge_size_;
+  // background compaction thread, nullptr if it is not running
+  std::thread *compaction_thread_ = nullptr;
+  // protects compaction_running_
+  std::mutex compaction_latch_;
+  // wakes the compaction thread up early to stop
+  std::condition_variable compaction_cv_;
+  // true while the compaction thread should keep running
+  bool compaction_running_ = false;
 };
 
 }  // namespace bustub
@@ -26,7 +26,8 @@ namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeIndex : public Index {
  public:
-  BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager);
+  BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
+                 page_id_t header_page_id = HEADER_PAGE_ID);
 
   void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
 
@@ -34,12 +35,21 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  void BulkLoad(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) override;
+
   INDEXITERATOR_TYPE GetBeginIterator();
 
   INDEXITERATOR_TYPE GetBeginIterator(const KeyType &key);
 
   INDEXITERATOR_TYPE GetEndIterator();
 
+  INDEXITERATOR_TYPE GetReverseBeginIterator();
+
+  INDEXITERATOR_TYPE GetReverseBeginIterator(const KeyType &key);
+
+  INDEXITERATOR_TYPE GetRangeIterator(const KeyType &low_key, const KeyType &high_key, bool low_inclusive = true,
+                                      bool high_inclusive = true, bool reverse = false);
+
  protected:
   // comparator for key
   KeyComparator comparator_;
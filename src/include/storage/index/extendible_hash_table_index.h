@@ -15,6 +15,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "container/hash/extendible_hash_table.h"
@@ -39,6 +40,8 @@ class ExtendibleHashTableIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  void BulkLoad(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) override;
+
  protected:
   // comparator for key
   KeyComparator comparator_;
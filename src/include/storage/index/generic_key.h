@@ -13,9 +13,11 @@
 #pragma once
 
 #include <cstring>
+#include <vector>
 
 #include "common/logger.h"
 #include "storage/table/tuple.h"
+#include "type/limits.h"
 #include "type/value.h"
 
 namespace bustub {
@@ -75,35 +77,150 @@ class GenericKey {
 
 /**
  * Function object returns true if lhs < rhs, used for trees
+ *
+ * The key schema is inspected once at construction. A key made of a single
+ * integer column is compared as one native integer, a key made only of other
+ * fixed-width columns is compared column by column straight from the key
+ * bytes, and only keys with VARCHAR columns go through Value. NULL columns
+ * compare equal to anything, the same as the Value comparison.
  */
 template <size_t KeySize>
 class GenericComparator {
  public:
   inline int operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const {
-    uint32_t column_count = key_schema_->GetColumnCount();
+    switch (kind_) {
+      case KeyKind::INTEGER:
+        return CompareColumn<int32_t>(lhs.data_, rhs.data_, BUSTUB_INT32_NULL);
+      case KeyKind::BIGINT:
+        return CompareColumn<int64_t>(lhs.data_, rhs.data_, BUSTUB_INT64_NULL);
+      case KeyKind::FIXED:
+        return CompareFixed(lhs, rhs);
+      default:
+        return CompareValues(lhs, rhs);
+    }
+  }
+
+  // true if comparing never follows an offset stored inside the keys, so comparing a torn key can't read out of it
+  inline bool IsFixedWidth() const { return kind_ != KeyKind::GENERIC; }
 
+  // number of leading key bytes a key built by SetFromKey can have set; the rest are always zero
+  inline size_t KeyLength() const { return key_length_; }
+
+  GenericComparator(const GenericComparator &other)
+      : key_schema_{other.key_schema_}, kind_{other.kind_}, key_length_{other.key_length_}, columns_{other.columns_} {}
+
+  // constructor
+  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {
+    uint32_t column_count = key_schema_->GetColumnCount();
     for (uint32_t i = 0; i < column_count; i++) {
-      Value lhs_value = (lhs.ToValue(key_schema_, i));
-      Value rhs_value = (rhs.ToValue(key_schema_, i));
+      const auto &col = key_schema_->GetColumn(i);
+      if (!col.IsInlined() || col.GetOffset() + col.GetFixedLength() > KeySize) {
+        kind_ = KeyKind::GENERIC;
+        columns_.clear();
+        return;
+      }
+      columns_.push_back({col.GetType(), col.GetOffset()});
+    }
+    kind_ = KeyKind::FIXED;
+    key_length_ = key_schema_->GetLength();
+    if (column_count == 1 && columns_[0].offset_ == 0) {
+      if (columns_[0].type_ == TypeId::INTEGER) {
+        kind_ = KeyKind::INTEGER;
+      } else if (columns_[0].type_ == TypeId::BIGINT) {
+        kind_ = KeyKind::BIGINT;
+      }
+    }
+  }
 
-      if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
-        return -1;
+ private:
+  enum class KeyKind { GENERIC, FIXED, INTEGER, BIGINT };
+
+  struct KeyColumn {
+    TypeId type_;
+    uint32_t offset_;
+  };
+
+  template <typename T>
+  static inline int CompareColumn(const char *lhs, const char *rhs, T null_value) {
+    T lhs_value;
+    T rhs_value;
+    memcpy(&lhs_value, lhs, sizeof(T));
+    memcpy(&rhs_value, rhs, sizeof(T));
+    if (lhs_value == null_value || rhs_value == null_value) {
+      return 0;
+    }
+    return static_cast<int>(lhs_value > rhs_value) - static_cast<int>(lhs_value < rhs_value);
+  }
+
+  inline int CompareFixed(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const {
+    for (const auto &col : columns_) {
+      const char *lhs_ptr = lhs.data_ + col.offset_;
+      const char *rhs_ptr = rhs.data_ + col.offset_;
+      int cmp;
+      switch (col.type_) {
+        case TypeId::BOOLEAN:
+          cmp = CompareColumn<int8_t>(lhs_ptr, rhs_ptr, BUSTUB_BOOLEAN_NULL);
+          break;
+        case TypeId::TINYINT:
+          cmp = CompareColumn<int8_t>(lhs_ptr, rhs_ptr, BUSTUB_INT8_NULL);
+          break;
+        case TypeId::SMALLINT:
+          cmp = CompareColumn<int16_t>(lhs_ptr, rhs_ptr, BUSTUB_INT16_NULL);
+          break;
+        case TypeId::INTEGER:
+          cmp = CompareColumn<int32_t>(lhs_ptr, rhs_ptr, BUSTUB_INT32_NULL);
+          break;
+        case TypeId::BIGINT:
+          cmp = CompareColumn<int64_t>(lhs_ptr, rhs_ptr, BUSTUB_INT64_NULL);
+          break;
+        case TypeId::DECIMAL:
+          cmp = CompareColumn<double>(lhs_ptr, rhs_ptr, BUSTUB_DECIMAL_NULL);
+          break;
+        case TypeId::TIMESTAMP:
+          cmp = CompareColumn<uint64_t>(lhs_ptr, rhs_ptr, BUSTUB_TIMESTAMP_NULL);
+          break;
+        default:
+          cmp = CompareValue(lhs, rhs, static_cast<uint32_t>(&col - columns_.data()));
+          break;
       }
-      if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
-        return 1;
+      if (cmp != 0) {
+        return cmp;
       }
     }
     // equals
     return 0;
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  inline int CompareValue(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs, uint32_t column_idx) const {
+    Value lhs_value = (lhs.ToValue(key_schema_, column_idx));
+    Value rhs_value = (rhs.ToValue(key_schema_, column_idx));
 
-  // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+    if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
+      return 1;
+    }
+    return 0;
+  }
+
+  inline int CompareValues(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const {
+    uint32_t column_count = key_schema_->GetColumnCount();
+
+    for (uint32_t i = 0; i < column_count; i++) {
+      int cmp = CompareValue(lhs, rhs, i);
+      if (cmp != 0) {
+        return cmp;
+      }
+    }
+    // equals
+    return 0;
+  }
 
- private:
   Schema *key_schema_;
+  KeyKind kind_{KeyKind::GENERIC};
+  size_t key_length_{KeySize};
+  std::vector<KeyColumn> columns_;
 };
 
 }  // namespace bustub
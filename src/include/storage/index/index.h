@@ -162,7 +162,7 @@ class Index {
   /**
    * Delete an index entry by key.
    * @param key The index key
-   * @param rid The RID associated with the key (unused)
+   * @param rid The RID associated with the key
    * @param transaction The transaction context
    */
   virtual void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) = 0;
@@ -175,6 +175,19 @@ class Index {
    */
   virtual void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) = 0;
 
+  /**
+   * Insert many entries at once, e.g. when the index is built over an existing table.
+   * Indexes that can build themselves faster from the whole input override this;
+   * by default the entries are inserted one by one.
+   * @param entries The index keys and their RIDs, in any order
+   * @param transaction The transaction context
+   */
+  virtual void BulkLoad(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) {
+    for (const auto &[key, rid] : entries) {
+      InsertEntry(key, rid, transaction);
+    }
+  }
+
  private:
   /** The Index structure owns its metadata */
   std::unique_ptr<IndexMetadata> metadata_;
@@ -13,7 +13,9 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include "buffer/read_ahead.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/b_plus_tree_posting_page.h"
 
 namespace bustub {
 
@@ -24,7 +26,13 @@ class IndexIterator {
  public:
   // you may define your own constructor based on your member variables
   IndexIterator();
-  IndexIterator(BufferPoolManager *buffer_pool_manager, B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_page, int index);
+  IndexIterator(BufferPoolManager *buffer_pool_manager, B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_page, int index,
+                bool unique_keys = true, bool reverse = false);
+  // an iterator that reaches the end at the first key beyond stop_key in its direction; stop_page_id is the leaf
+  // that held stop_key when the iterator was created, no leaf after it is read ahead
+  IndexIterator(BufferPoolManager *buffer_pool_manager, B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_page, int index,
+                bool unique_keys, bool reverse, const KeyComparator *comparator, const KeyType &stop_key,
+                bool stop_inclusive, page_id_t stop_page_id);
   ~IndexIterator();
 
   bool IsEnd();
@@ -34,7 +42,8 @@ class IndexIterator {
   IndexIterator &operator++();
 
   bool operator==(const IndexIterator &itr) const {
-    return leaf_page_ == itr.leaf_page_ && index_ == itr.index_;
+    return leaf_page_ == itr.leaf_page_ && index_ == itr.index_ && posting_index_ == itr.posting_index_ &&
+           posting_page_ == itr.posting_page_;
   }
 
   bool operator!=(const IndexIterator &itr) const {
@@ -42,10 +51,32 @@ class IndexIterator {
   }
 
  private:
+  void Settle();
+  void Finish();
+  int CompareToStopKey(const KeyType &key) const;
+  void LoadItem();
+  void LoadPostingPage(page_id_t page_id);
+
   // add your own private member variables here
   B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_page_;
   int index_;
+  // false if leaf values may refer to posting lists
+  bool unique_keys_;
+  // true if walking the keys in descending order, over the prev_page_id_ links
+  bool reverse_{false};
+  // the bound of a range iterator, or nullptr if it runs to the last leaf
+  const KeyComparator *comparator_{nullptr};
+  KeyType stop_key_;
+  bool stop_inclusive_{true};
+  // the entry under the iterator, copied out of the page since keys may be stored truncated
+  MappingType item_;
+  // the pinned posting page, and the position in it, while on a key with several values
+  BPlusTreePostingPage *posting_page_{nullptr};
+  page_id_t posting_page_id_{INVALID_PAGE_ID};
+  int posting_index_{0};
   BufferPoolManager *buffer_pool_manager_;
+  // keeps the next leaves prefetched
+  ReadAhead read_ahead_;
 };
 
 }  // namespace bustub
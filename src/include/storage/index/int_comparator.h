@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 namespace bustub {
 
 /**
@@ -29,5 +31,8 @@ class IntComparator {
     }
     return 0;
   }
+
+  // number of key bytes the comparison looks at
+  inline size_t KeyLength() const { return sizeof(int); }
 };
 }  // namespace bustub
@@ -17,7 +17,7 @@
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
-#define INTERNAL_PAGE_HEADER_SIZE 24
+#define INTERNAL_PAGE_HEADER_SIZE 28
 #define INTERNAL_PAGE_SIZE ((PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
@@ -31,12 +31,15 @@ namespace bustub {
  *  --------------------------------------------------------------------------
  * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
  *  --------------------------------------------------------------------------
+ *
+ * As in leaf pages, each KEY holds only the first KeySize bytes of the key.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
  public:
   // must call initialize method after "create" a new node
-  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INTERNAL_PAGE_SIZE);
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INTERNAL_PAGE_SIZE,
+            int key_size = sizeof(KeyType));
 
   KeyType KeyAt(int index) const;
   void SetKeyAt(int index, const KeyType &key);
@@ -57,10 +60,21 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   void MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
                          BufferPoolManager *buffer_pool_manager);
 
- private:
+  // Bulk load utility method
   void CopyNFrom(MappingType *items, int size, BufferPoolManager *buffer_pool_manager);
+
+ private:
   void CopyLastFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager);
   void CopyFirstFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager);
-  MappingType array_[0];
+  // entry accessors, entries are GetKeySize() key bytes followed by the child page id
+  const char *SlotAt(int index) const;
+  char *SlotAt(int index);
+  KeyType SlotKey(int index) const;
+  ValueType SlotValue(int index) const;
+  MappingType SlotItem(int index) const;
+  void SetSlotKey(int index, const KeyType &key);
+  void SetSlotValue(int index, const ValueType &value);
+  void MoveSlots(int to, int from, int count);
+  char array_[0];
 };
 }  // namespace bustub
@@ -18,7 +18,7 @@
 namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
-#define LEAF_PAGE_HEADER_SIZE 28
+#define LEAF_PAGE_HEADER_SIZE 36
 #define LEAF_PAGE_SIZE ((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
 
 /**
@@ -31,30 +31,37 @@ namespace bustub {
  * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
  *  ----------------------------------------------------------------------
  *
- *  Header format (size in byte, 28 bytes in total):
+ *  Header format (size in byte, 36 bytes in total):
  *  ---------------------------------------------------------------------
  * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
  *  ---------------------------------------------------------------------
- *  -----------------------------------------------
- * | ParentPageId (4) | PageId (4) | NextPageId (4)
- *  -----------------------------------------------
+ *  -----------------------------------------------------------------------------------
+ * | ParentPageId (4) | PageId (4) | KeySize (4) | NextPageId (4) | PrevPageId (4)
+ *  -----------------------------------------------------------------------------------
+ *
+ *  Each KEY holds only the first KeySize bytes of the key, so a page of a
+ *  compressed tree packs more entries than LEAF_PAGE_SIZE.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
  public:
   // After creating a new leaf page from buffer pool, must call initialize
   // method to set default values
-  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = LEAF_PAGE_SIZE);
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = LEAF_PAGE_SIZE,
+            int key_size = sizeof(KeyType));
   // helper methods
   page_id_t GetNextPageId() const;
   void SetNextPageId(page_id_t next_page_id);
+  page_id_t GetPrevPageId() const;
+  void SetPrevPageId(page_id_t prev_page_id);
   KeyType KeyAt(int index) const;
   int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
-  const MappingType &GetItem(int index);
+  MappingType GetItem(int index) const;
 
   // insert and delete methods
   int Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
   bool Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const;
+  bool SetValue(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
   int RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator);
 
   // Split and Merge utility methods
@@ -63,12 +70,22 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
   void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
 
+  // Bulk load utility method
+  void CopyNFrom(MappingType *items, int size);
 
  private:
-  void CopyNFrom(MappingType *items, int size);
+  int LowerBound(const KeyType &key, const KeyComparator &comparator) const;
   void CopyLastFrom(const MappingType &item);
   void CopyFirstFrom(const MappingType &item);
+  // entry accessors, entries are GetKeySize() key bytes followed by the value
+  const char *SlotAt(int index) const;
+  char *SlotAt(int index);
+  KeyType SlotKey(int index) const;
+  ValueType SlotValue(int index) const;
+  void SetSlot(int index, const KeyType &key, const ValueType &value);
+  void MoveSlots(int to, int from, int count);
   page_id_t next_page_id_;
-  MappingType array_[0];
+  page_id_t prev_page_id_;
+  char array_[0];
 };
 }  // namespace bustub
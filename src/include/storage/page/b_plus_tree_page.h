@@ -33,12 +33,16 @@ enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
  * It actually serves as a header part for each B+ tree page and
  * contains information shared by both leaf page and internal page.
  *
- * Header format (size in byte, 24 bytes in total):
+ * Header format (size in byte, 28 bytes in total):
  * ----------------------------------------------------------------------------
  * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
  * ----------------------------------------------------------------------------
- * | ParentPageId (4) | PageId(4) |
+ * | ParentPageId (4) | PageId(4) | KeySize (4) |
  * ----------------------------------------------------------------------------
+ *
+ * KeySize is the number of leading key bytes each entry stores. It is smaller
+ * than sizeof(KeyType) when the tree compresses its keys; the bytes that are
+ * left out are zero in every key of the tree.
  */
 class BPlusTreePage {
  public:
@@ -60,6 +64,9 @@ class BPlusTreePage {
   page_id_t GetPageId() const;
   void SetPageId(page_id_t page_id);
 
+  int GetKeySize() const;
+  void SetKeySize(int key_size);
+
   void SetLSN(lsn_t lsn = INVALID_LSN);
 
  private:
@@ -70,6 +77,7 @@ class BPlusTreePage {
   int max_size_ __attribute__((__unused__));
   page_id_t parent_page_id_ __attribute__((__unused__));
   page_id_t page_id_ __attribute__((__unused__));
+  int key_size_ __attribute__((__unused__));
 };
 
 }  // namespace bustub
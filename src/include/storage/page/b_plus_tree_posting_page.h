@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/include/page/b_plus_tree_posting_page.h
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <limits>
+
+#include "common/config.h"
+#include "common/rid.h"
+
+namespace bustub {
+
+#define POSTING_PAGE_HEADER_SIZE 8
+#define POSTING_PAGE_SIZE ((PAGE_SIZE - POSTING_PAGE_HEADER_SIZE) / sizeof(RID))
+
+/**
+ * Holds the record ids of a key that occurs more than once in a B+ tree that
+ * allows duplicate keys. The leaf page keeps the key once, and its value is
+ * either the only record id of the key, or a reference to the first page of a
+ * chain of posting pages which together hold all record ids of the key, in no
+ * particular order.
+ *
+ * A reference is a RID whose slot number is POSTING_LIST_SLOT, which no tuple
+ * ever has, and whose page id is the first posting page.
+ *
+ * Posting page format:
+ *  ----------------------------------------------------------
+ * | HEADER | RID(1) | RID(2) | ... | RID(n)
+ *  ----------------------------------------------------------
+ *
+ *  Header format (size in byte, 8 bytes in total):
+ *  ----------------------------------
+ * | NextPageId (4) | CurrentSize (4) |
+ *  ----------------------------------
+ */
+class BPlusTreePostingPage {
+ public:
+  static constexpr uint32_t POSTING_LIST_SLOT = std::numeric_limits<uint32_t>::max();
+
+  // true if the leaf value refers to a posting list instead of being a record id
+  static bool IsPostingList(const RID &value) { return value.GetSlotNum() == POSTING_LIST_SLOT; }
+  // the leaf value that refers to the posting list starting at page_id
+  static RID PostingListOf(page_id_t page_id) { return RID(page_id, POSTING_LIST_SLOT); }
+
+  // must call initialize method after "create" a new posting page
+  void Init(page_id_t next_page_id = INVALID_PAGE_ID);
+
+  page_id_t GetNextPageId() const;
+  void SetNextPageId(page_id_t next_page_id);
+  int GetSize() const;
+  bool IsFull() const;
+  RID RidAt(int index) const;
+
+  void Append(const RID &rid);
+  // remove the rid from this page, moving the last rid into its place; false if it is not here
+  bool Remove(const RID &rid);
+
+ private:
+  page_id_t next_page_id_;
+  int size_;
+  RID array_[0];
+};
+
+}  // namespace bustub
@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_list_page.h
+//
+// Identification: src/include/storage/page/free_list_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * A page of the list of deallocated pages kept by a BufferPoolManagerInstance. The list is a chain of these pages, and
+ * every page of the chain is itself a deallocated page, so tracking free pages never needs pages of its own. A list
+ * page is handed out again once all the ids it records have been reused.
+ *
+ * Format (size in byte, 16 bytes of header):
+ *  ------------------------------------------------------------------------------------------
+ * | PageId (4) | LSN (4) | NextPageId (4) | Count (4) | FreePageId_1 (4) | FreePageId_2 (4) | ...
+ *  ------------------------------------------------------------------------------------------
+ */
+class FreeListPage {
+ public:
+  /**
+   * Initialize an empty list page.
+   * @param page_id id of this page
+   * @param next_page_id the list page that comes after this one, INVALID_PAGE_ID if there is none
+   */
+  void Init(page_id_t page_id, page_id_t next_page_id);
+
+  /** @return the id of this page */
+  page_id_t GetPageId() const { return page_id_; }
+
+  /** @return the list page that comes after this one, INVALID_PAGE_ID if there is none */
+  page_id_t GetNextPageId() const { return next_page_id_; }
+
+  /** @return true if no more free page ids fit on this page */
+  bool IsFull() const { return count_ == CAPACITY; }
+
+  /** @return true if this page records no free page ids */
+  bool IsEmpty() const { return count_ == 0; }
+
+  /**
+   * Record a deallocated page. The page must not be full.
+   * @param page_id id of the deallocated page
+   */
+  void Push(page_id_t page_id);
+
+  /**
+   * Take the most recently recorded page off this page. The page must not be empty.
+   * @return id of a deallocated page
+   */
+  page_id_t Pop();
+
+  /** Number of free page ids one list page holds. */
+  static constexpr uint32_t CAPACITY = (PAGE_SIZE - 16) / sizeof(page_id_t);
+
+ private:
+  page_id_t page_id_;
+  lsn_t lsn_;
+  page_id_t next_page_id_;
+  uint32_t count_;
+  page_id_t free_page_ids_[CAPACITY];
+};
+
+static_assert(sizeof(FreeListPage) == PAGE_SIZE);
+
+}  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -33,6 +34,12 @@ namespace bustub {
  *  The above format omits the space required for the occupied_ and
  *  readable_ arrays. More information is in storage/page/hash_table_page_defs.h.
  *
+ *  Unless BUCKET_FINGERPRINT_SIZE is 0, every slot also keeps a one-byte
+ *  fingerprint of its key in fingerprints_, which needs a comparator with
+ *  IsFixedWidth() and KeyLength() like GenericComparator. Probes compare
+ *  BUCKET_PROBE_WIDTH fingerprints at once and only call the comparator on
+ *  the slots whose fingerprint matches.
+ *
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class HashTableBucketPage {
@@ -138,10 +145,25 @@ class HashTableBucketPage {
   void PrintBucket();
 
  private:
+  /** @return a one-byte hash of the key bytes the comparator looks at, independent of the bits the directory uses */
+  static uint8_t Fingerprint(const KeyType &key, const KeyComparator &cmp);
+
+  /** @return one bit per slot in [base, base + BUCKET_PROBE_WIDTH) of the given bitmap */
+  static uint32_t BitmapGroup(const char *bitmap, size_t base);
+
+  /**
+   * @return one bit per slot in [base, base + BUCKET_PROBE_WIDTH) whose fingerprint is the given one, or every bit
+   * without fingerprints
+   */
+  uint32_t MatchFingerprints(size_t base, uint8_t fingerprint) const;
+
   //  For more on BUCKET_ARRAY_SIZE see storage/page/hash_table_page_defs.h
   char occupied_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
   char readable_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  // padded to a whole probe group so that the last group can be loaded at once
+  uint8_t
+      fingerprints_[((BUCKET_ARRAY_SIZE - 1) / BUCKET_PROBE_WIDTH + 1) * BUCKET_PROBE_WIDTH * BUCKET_FINGERPRINT_SIZE];
   MappingType array_[0];
 };
 
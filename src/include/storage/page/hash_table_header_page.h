@@ -26,10 +26,10 @@ namespace bustub {
  *
  * Header Page for linear probing hash table.
  *
- * Header format (size in byte, 16 bytes in total):
- * -------------------------------------------------------------
- * | LSN (4) | Size (4) | PageId(4) | NextBlockIndex(4)
- * -------------------------------------------------------------
+ * Header format (size in byte, 32 bytes in total, followed by the block page ids):
+ * ---------------------------------------------------------------------------------------------
+ * | LSN (4) | Padding (4) | Size (8) | PageId(4) | Padding (4) | NextBlockIndex(8) | BlockPageIds
+ * ---------------------------------------------------------------------------------------------
  */
 class HashTableHeaderPage {
  public:
@@ -90,11 +90,11 @@ class HashTableHeaderPage {
   size_t NumBlocks();
 
  private:
-  __attribute__((unused)) lsn_t lsn_;
-  __attribute__((unused)) size_t size_;
-  __attribute__((unused)) page_id_t page_id_;
-  __attribute__((unused)) size_t next_ind_;
-  __attribute__((unused)) page_id_t block_page_ids_[0];
+  lsn_t lsn_;
+  size_t size_;
+  page_id_t page_id_;
+  size_t next_ind_;
+  page_id_t block_page_ids_[0];
 };
 
 }  // namespace bustub
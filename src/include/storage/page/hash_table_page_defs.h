@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <cstddef>
+
 #define MappingType std::pair<KeyType, ValueType>
 
 /**
@@ -28,17 +30,54 @@
  */
 #define BLOCK_ARRAY_SIZE (4 * PAGE_SIZE / (4 * sizeof(MappingType) + 1))
 
+/**
+ * HEADER_BLOCK_ARRAY_SIZE is the number of block page ids a linear probe hash header page can hold, after its 32 bytes
+ * of fields.
+ */
+#define HEADER_BLOCK_ARRAY_SIZE ((PAGE_SIZE - 32) / sizeof(page_id_t))
+
 /**
  * Extendible Hashing Definitions
  */
 #define HASH_TABLE_BUCKET_TYPE HashTableBucketPage<KeyType, ValueType, KeyComparator>
 #define DIRECTORY_ARRAY_SIZE 512
 
+namespace bustub {
+
+class IntComparator;
+
+/**
+ * BucketFingerprint::SIZE is the number of fingerprint bytes an extendible hashing bucket page keeps per slot. A
+ * fingerprint lets a probe skip the comparator on slots whose key can't match, which pays off for comparators that
+ * decode the keys, but an IntComparator is as cheap as the fingerprint check and keeps the space for more slots.
+ */
+template <typename KeyComparator>
+struct BucketFingerprint {
+  static constexpr size_t SIZE = 1;
+};
+
+template <>
+struct BucketFingerprint<IntComparator> {
+  static constexpr size_t SIZE = 0;
+};
+
+}  // namespace bustub
+
+#define BUCKET_FINGERPRINT_SIZE BucketFingerprint<KeyComparator>::SIZE
+
+/**
+ * BUCKET_PROBE_WIDTH is the number of fingerprints a bucket page compares at once.
+ */
+#define BUCKET_PROBE_WIDTH 16
+
 /**
  * BUCKET_ARRAY_SIZE is the number of (key, value) pairs that can be stored in an extendible hashing bucket page.
  * It is an approximate calculation based on the size of MappingType (which is a std::pair of KeyType and ValueType).
- * For each key/value pair, we need two additional bits for occupied_ and readable_. 4 * (PAGE_SIZE - 4) / (4 * sizeof
- * (MappingType) + 1) = (PAGE_SIZE - 4)/(sizeof (MappingType) + 0.25) because 0.25 bytes = 2 bits is the space required
- * to maintain the occupied and readable flags for a key value pair.
+ * For each key/value pair, we need two additional bits for occupied_ and readable_, and BUCKET_FINGERPRINT_SIZE bytes
+ * for its fingerprint. 4 * PAGE_SIZE / (4 * sizeof (MappingType) + 1) = PAGE_SIZE/(sizeof (MappingType) + 0.25)
+ * because 0.25 bytes = 2 bits is the space required to maintain the occupied and readable flags for a key value pair.
+ * With fingerprints, 32 bytes of the page are set aside for padding the fingerprints to a whole probe group.
  */
-#define BUCKET_ARRAY_SIZE static_cast<size_t>(4) * PAGE_SIZE / (4 * sizeof(MappingType) + 1)
+#define BUCKET_ARRAY_SIZE                                                \
+  (static_cast<size_t>(4) * (PAGE_SIZE - 32 * BUCKET_FINGERPRINT_SIZE) / \
+   (4 * sizeof(MappingType) + 1 + 4 * BUCKET_FINGERPRINT_SIZE))
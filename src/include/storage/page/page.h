@@ -12,8 +12,10 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
+#include <thread>  // NOLINT
 
 #include "common/config.h"
 #include "common/rwlatch.h"
@@ -30,8 +32,8 @@ class Page {
   friend class BufferPoolManagerInstance;
 
  public:
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
+  /** Constructor. The buffer pool manager attaches the page to its frame data before using it. */
+  Page() = default;
 
   /** Default destructor. */
   ~Page() = default;
@@ -48,11 +50,17 @@ class Page {
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
   inline bool IsDirty() { return is_dirty_; }
 
-  /** Acquire the page write latch. */
-  inline void WLatch() { rwlatch_.WLock(); }
+  /** Acquire the page write latch. The version stays odd until the latch is released. */
+  inline void WLatch() {
+    rwlatch_.WLock();
+    version_.fetch_add(1);
+  }
 
   /** Release the page write latch. */
-  inline void WUnlatch() { rwlatch_.WUnlock(); }
+  inline void WUnlatch() {
+    version_.fetch_add(1, std::memory_order_release);
+    rwlatch_.WUnlock();
+  }
 
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
@@ -60,6 +68,24 @@ class Page {
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
+  /**
+   * Wait until no writer holds the page latch and return the page version. An optimistic reader reads the pinned page
+   * without latching it and then calls ValidateVersion() to check that no writer latched it in between.
+   */
+  inline uint64_t ReadVersion() {
+    uint64_t version;
+    while (((version = version_.load(std::memory_order_acquire)) & 1) != 0) {
+      std::this_thread::yield();
+    }
+    return version;
+  }
+
+  /** @return true if the page was not write latched since ReadVersion() returned version */
+  inline bool ValidateVersion(uint64_t version) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version_.load(std::memory_order_relaxed) == version;
+  }
+
   /** @return the page LSN. */
   inline lsn_t GetLSN() { return *reinterpret_cast<lsn_t *>(GetData() + OFFSET_LSN); }
 
@@ -78,16 +104,18 @@ class Page {
   /** Zeroes out the data that is held within the page. */
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }
 
-  /** The actual data that is stored within a page. */
-  char data_[PAGE_SIZE]{};
+  /** The actual data that is stored within a page, PAGE_SIZE bytes in the frame arena of the buffer pool manager. */
+  char *data_ = nullptr;
   /** The ID of this page. */
   page_id_t page_id_ = INVALID_PAGE_ID;
-  /** The pin count of this page. */
-  int pin_count_ = 0;
+  /** The pin count of this page. Atomic so that buffer pool hits can pin the page without the instance latch. */
+  std::atomic<int> pin_count_ = 0;
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
-  bool is_dirty_ = false;
+  std::atomic<bool> is_dirty_ = false;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** Bumped on every write latch and unlatch, so it is odd while a writer holds the page. */
+  std::atomic<uint64_t> version_ = 0;
 };
 
 }  // namespace bustub
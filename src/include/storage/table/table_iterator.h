@@ -14,6 +14,7 @@
 
 #include <cassert>
 
+#include "buffer/read_ahead.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
 #include "storage/table/tuple.h"
@@ -32,7 +33,10 @@ class TableIterator {
   TableIterator(TableHeap *table_heap, RID rid, Transaction *txn);
 
   TableIterator(const TableIterator &other)
-      : table_heap_(other.table_heap_), tuple_(new Tuple(*other.tuple_)), txn_(other.txn_) {}
+      : table_heap_(other.table_heap_),
+        tuple_(new Tuple(*other.tuple_)),
+        txn_(other.txn_),
+        read_ahead_(other.read_ahead_) {}
 
   ~TableIterator() { delete tuple_; }
 
@@ -52,6 +56,7 @@ class TableIterator {
     table_heap_ = other.table_heap_;
     *tuple_ = *other.tuple_;
     txn_ = other.txn_;
+    read_ahead_ = other.read_ahead_;
     return *this;
   }
 
@@ -59,6 +64,8 @@ class TableIterator {
   TableHeap *table_heap_;
   Tuple *tuple_;
   Transaction *txn_;
+  /** Keeps the next pages of the heap prefetched. */
+  ReadAhead read_ahead_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,333 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_io_backend.cpp
+//
+// Identification: src/storage/disk/disk_io_backend.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_io_backend.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/logger.h"
+
+namespace bustub {
+
+void DiskIOBackend::ExecuteOne(const DiskRequest &request) {
+  off_t offset = static_cast<off_t>(request.page_id_) * PAGE_SIZE;
+  ssize_t result = request.is_write_ ? pwrite(fd_, request.data_, PAGE_SIZE, offset)
+                                     : pread(fd_, request.data_, PAGE_SIZE, offset);
+  Complete(request, result < 0 ? -errno : result);
+}
+
+void DiskIOBackend::Complete(const DiskRequest &request, ssize_t result) {
+  if (result < 0) {
+    LOG_DEBUG("I/O error while %s page %d: %s", request.is_write_ ? "writing" : "reading", request.page_id_,
+              strerror(static_cast<int>(-result)));
+    return;
+  }
+  if (result < PAGE_SIZE) {
+    if (request.is_write_) {
+      LOG_DEBUG("Wrote less than a page");
+      return;
+    }
+    // if file ends before reading PAGE_SIZE
+    memset(request.data_ + result, 0, PAGE_SIZE - result);
+  }
+}
+
+/*****************************************************************************
+ * THREAD POOL
+ *****************************************************************************/
+
+ThreadPoolDiskIOBackend::ThreadPoolDiskIOBackend(int fd, size_t num_threads) : DiskIOBackend(fd) {
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers_.emplace_back(&ThreadPoolDiskIOBackend::RunWorker, this);
+  }
+}
+
+ThreadPoolDiskIOBackend::~ThreadPoolDiskIOBackend() {
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    shutdown_ = true;
+  }
+  queue_cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPoolDiskIOBackend::Execute(DiskRequest *requests, size_t num_requests) {
+  if (num_requests == 1 || workers_.empty()) {
+    for (size_t i = 0; i < num_requests; ++i) {
+      ExecuteOne(requests[i]);
+    }
+    return;
+  }
+
+  Batch batch;
+  std::unique_lock<std::mutex> lock(latch_);
+  batch.remaining_ = num_requests;
+  for (size_t i = 0; i < num_requests; ++i) {
+    queue_.emplace_back(&requests[i], &batch);
+  }
+  queue_cv_.notify_all();
+  batch.done_.wait(lock, [&] { return batch.remaining_ == 0; });
+}
+
+void ThreadPoolDiskIOBackend::RunWorker() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    queue_cv_.wait(lock, [&] { return shutdown_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+    auto [request, batch] = queue_.front();
+    queue_.pop_front();
+    lock.unlock();
+    ExecuteOne(*request);
+    lock.lock();
+    if (--batch->remaining_ == 0) {
+      batch->done_.notify_one();
+    }
+  }
+}
+
+/*****************************************************************************
+ * IO_URING
+ *****************************************************************************/
+
+static int IOUringSetup(unsigned entries, io_uring_params *params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int IOUringEnter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+std::unique_ptr<IOUringDiskIOBackend> IOUringDiskIOBackend::Create(int fd, unsigned queue_depth) {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int ring_fd = IOUringSetup(queue_depth, &params);
+  if (ring_fd < 0) {
+    LOG_DEBUG("io_uring is not available: %s", strerror(errno));
+    return nullptr;
+  }
+  // IORING_OP_READ and IORING_OP_WRITE need the same kernels (5.6+) that report IORING_FEAT_NODROP or newer features.
+  if ((params.features & IORING_FEAT_NODROP) == 0 || (params.features & IORING_FEAT_SINGLE_MMAP) == 0) {
+    LOG_DEBUG("io_uring is too old");
+    close(ring_fd);
+    return nullptr;
+  }
+  auto backend = std::unique_ptr<IOUringDiskIOBackend>(new IOUringDiskIOBackend(fd, ring_fd, params));
+  if (backend->ring_ == MAP_FAILED || backend->sqes_ == MAP_FAILED) {
+    LOG_DEBUG("could not map the io_uring");
+    return nullptr;
+  }
+  return backend;
+}
+
+IOUringDiskIOBackend::IOUringDiskIOBackend(int fd, int ring_fd, const io_uring_params &params)
+    : DiskIOBackend(fd), ring_fd_(ring_fd), sq_entries_(params.sq_entries), cq_entries_(params.cq_entries) {
+  // With IORING_FEAT_SINGLE_MMAP both rings live in one mapping.
+  ring_size_ = std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+  ring_ = mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  sqes_ = static_cast<io_uring_sqe *>(mmap(nullptr, params.sq_entries * sizeof(io_uring_sqe), PROT_READ | PROT_WRITE,
+                                           MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES));
+  if (ring_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+    return;
+  }
+
+  auto *sq = static_cast<char *>(ring_);
+  sq_head_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  auto *cq = static_cast<char *>(ring_);
+  cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+}
+
+IOUringDiskIOBackend::~IOUringDiskIOBackend() {
+  if (sqes_ != MAP_FAILED) {
+    munmap(sqes_, sq_entries_ * sizeof(io_uring_sqe));
+  }
+  if (ring_ != MAP_FAILED) {
+    munmap(ring_, ring_size_);
+  }
+  close(ring_fd_);
+}
+
+void IOUringDiskIOBackend::Execute(DiskRequest *requests, size_t num_requests) {
+  if (num_requests == 1) {
+    // One request gains nothing from the ring, and pread and pwrite let concurrent callers run without the latch.
+    ExecuteOne(requests[0]);
+    return;
+  }
+
+  Batch batch;
+  batch.remaining_ = num_requests;
+  std::vector<Inflight> inflight(num_requests);
+  size_t next = 0;
+
+  std::unique_lock<std::mutex> lock(latch_);
+  while (batch.remaining_ > 0) {
+    if (ring_error_ != 0) {
+      // The ring is broken, so our requests still in it never complete; fail them. Their entries are never reaped,
+      // so nothing touches inflight after we return.
+      for (size_t i = 0; i < next; ++i) {
+        if (!inflight[i].done_ && !inflight[i].taken_back_) {
+          Complete(*inflight[i].request_, -ring_error_);
+          inflight[i].done_ = true;
+          --batch.remaining_;
+          --in_flight_;
+        }
+      }
+      lock.unlock();
+      // The requests that never made it into the kernel are executed one at a time instead.
+      for (size_t i = 0; i < num_requests; ++i) {
+        if (i >= next || inflight[i].taken_back_) {
+          ExecuteOne(requests[i]);
+        }
+      }
+      return;
+    }
+
+    // Queue as many of our requests as the submission queue and the completion queue have room for.
+    unsigned tail = *sq_tail_;
+    unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    while (next < num_requests && tail - head < sq_entries_ && in_flight_ < cq_entries_) {
+      const DiskRequest &request = requests[next];
+      inflight[next] = {&requests[next], &batch};
+      unsigned index = tail & *sq_mask_;
+      io_uring_sqe *sqe = &sqes_[index];
+      memset(sqe, 0, sizeof(*sqe));
+      sqe->opcode = request.is_write_ ? IORING_OP_WRITE : IORING_OP_READ;
+      sqe->fd = fd_;
+      sqe->off = static_cast<uint64_t>(request.page_id_) * PAGE_SIZE;
+      sqe->addr = reinterpret_cast<uint64_t>(request.data_);
+      sqe->len = PAGE_SIZE;
+      sqe->user_data = reinterpret_cast<uint64_t>(&inflight[next]);
+      sq_array_[index] = index;
+      ++tail;
+      ++in_flight_;
+      ++next;
+    }
+    __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+    if (!Submit()) {
+      continue;
+    }
+
+    if (waiting_) {
+      // Another caller is waiting in the kernel and reaps our completions too.
+      if (next < num_requests) {
+        reaped_cv_.wait(lock);
+      } else {
+        auto iter = blocked_.insert(blocked_.end(), &batch);
+        batch.done_.wait(lock);
+        blocked_.erase(iter);
+      }
+      continue;
+    }
+    Reap();
+    if (batch.remaining_ == 0) {
+      break;
+    }
+    if (in_flight_ == *sq_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE)) {
+      // The kernel took none of the queued entries for now, so there is nothing to wait for yet; submit them again.
+      lock.unlock();
+      std::this_thread::yield();
+      lock.lock();
+      continue;
+    }
+
+    // Wait for a completion without holding the latch, so that other callers can submit in the meantime. Only the
+    // waiter reaps while it waits, so the completions it waits for can't be taken from under it.
+    waiting_ = true;
+    lock.unlock();
+    int ret = IOUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS);
+    int error = ret < 0 ? errno : 0;
+    lock.lock();
+    waiting_ = false;
+    if (ret < 0 && error != EINTR && error != EAGAIN && error != EBUSY) {
+      BreakRing(error);
+    }
+    Reap();
+  }
+  if (!waiting_ && !blocked_.empty()) {
+    // Nobody is waiting in the kernel any more, so one of the blocked callers has to take over.
+    blocked_.front()->done_.notify_one();
+  }
+}
+
+bool IOUringDiskIOBackend::Submit() {
+  unsigned tail = *sq_tail_;
+  unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+  if (tail == head) {
+    return true;
+  }
+  int ret = IOUringEnter(ring_fd_, tail - head, 0, 0);
+  if (ret >= 0 || errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+    // Whatever the kernel did not take stays queued for the next call.
+    return true;
+  }
+  // The failed call consumed none of the queued entries, so take them back off the queue for their callers to
+  // execute some other way.
+  BreakRing(errno);
+  for (unsigned i = head; i != tail; ++i) {
+    auto *inflight = reinterpret_cast<Inflight *>(sqes_[sq_array_[i & *sq_mask_]].user_data);
+    inflight->taken_back_ = true;
+  }
+  __atomic_store_n(sq_tail_, head, __ATOMIC_RELEASE);
+  in_flight_ -= tail - head;
+  return false;
+}
+
+void IOUringDiskIOBackend::BreakRing(int error) {
+  ring_error_ = error;
+  LOG_DEBUG("io_uring_enter failed: %s", strerror(ring_error_));
+  reaped_cv_.notify_all();
+  for (Batch *batch : blocked_) {
+    batch->done_.notify_one();
+  }
+}
+
+void IOUringDiskIOBackend::Reap() {
+  if (ring_error_ != 0) {
+    // The entries of a broken ring may point at batches that already gave up on them.
+    return;
+  }
+  unsigned head = *cq_head_;
+  unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  if (head == tail) {
+    return;
+  }
+  while (head != tail) {
+    io_uring_cqe *cqe = &cqes_[head & *cq_mask_];
+    auto *inflight = reinterpret_cast<Inflight *>(cqe->user_data);
+    Complete(*inflight->request_, cqe->res);
+    inflight->done_ = true;
+    if (--inflight->batch_->remaining_ == 0) {
+      inflight->batch_->done_.notify_one();
+    }
+    --in_flight_;
+    ++head;
+  }
+  __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+  reaped_cv_.notify_all();
+}
+
+}  // namespace bustub
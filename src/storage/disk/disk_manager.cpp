@@ -10,13 +10,17 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <cassert>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <mutex>  // NOLINT
 #include <string>
 #include <thread>  // NOLINT
+#include <vector>
 
 #include "common/exception.h"
 #include "common/logger.h"
@@ -30,8 +34,15 @@ static char *buffer_used;
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file)
-    : file_name_(db_file), num_flushes_(0), num_writes_(0), flush_log_(false), flush_log_f_(nullptr) {
+DiskManager::DiskManager(const std::string &db_file, DiskIOBackendType backend_type, bool direct_io)
+    : db_fd_(-1),
+      file_name_(db_file),
+      num_flushes_(0),
+      num_writes_(0),
+      flush_log_(false),
+      flush_log_f_(nullptr),
+      backend_type_(backend_type),
+      direct_io_(direct_io) {
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
@@ -53,30 +64,47 @@ DiskManager::DiskManager(const std::string &db_file)
     }
   }
 
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
-    db_io_.close();
-    // reopen with original mode
-    db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-    if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
+  if (direct_io_) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT | O_DIRECT, 0644);
+    // Some file systems (e.g. tmpfs) reject O_DIRECT; go through the page cache there.
+    if (db_fd_ < 0 && errno == EINVAL) {
+      direct_io_ = false;
+    }
+  }
+  if (!direct_io_) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  }
+  if (db_fd_ < 0) {
+    throw Exception("can't open db file");
+  }
+
+  if (backend_type_ == DiskIOBackendType::IO_URING) {
+    io_backend_ = IOUringDiskIOBackend::Create(db_fd_, IO_URING_QUEUE_DEPTH);
+    if (io_backend_ == nullptr) {
+      backend_type_ = DiskIOBackendType::THREAD_POOL;
     }
   }
+  if (backend_type_ == DiskIOBackendType::THREAD_POOL) {
+    io_backend_ = std::make_unique<ThreadPoolDiskIOBackend>(db_fd_, IO_THREAD_POOL_SIZE);
+  }
   buffer_used = nullptr;
 }
 
+DiskManager::~DiskManager() {
+  io_backend_.reset();
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+  }
+}
+
 /**
  * Close all file streams
  */
 void DiskManager::ShutDown() {
-  {
-    std::scoped_lock scoped_db_io_latch(db_io_latch_);
-    db_io_.close();
+  io_backend_.reset();
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+    db_fd_ = -1;
   }
   log_io_.close();
 }
@@ -85,47 +113,51 @@ void DiskManager::ShutDown() {
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
-  // set write cursor to offset
-  num_writes_ += 1;
-  db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
-  // check for I/O error
-  if (db_io_.bad()) {
-    LOG_DEBUG("I/O error while writing");
-    return;
-  }
-  // needs to flush to keep disk file in sync
-  db_io_.flush();
+  DiskRequest request{true, page_id, const_cast<char *>(page_data)};
+  ExecuteRequests(&request, 1);
 }
 
 /**
  * Read the contents of the specified page into the given memory area
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  int offset = page_id * PAGE_SIZE;
-  // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
-    LOG_DEBUG("I/O error reading past end of file");
-    // std::cerr << "I/O error while reading" << std::endl;
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
-    if (db_io_.bad()) {
-      LOG_DEBUG("I/O error while reading");
-      return;
+  DiskRequest request{false, page_id, page_data};
+  ExecuteRequests(&request, 1);
+}
+
+/**
+ * Perform a batch of page reads and writes through the I/O backend
+ */
+void DiskManager::ExecuteRequests(DiskRequest *requests, size_t num_requests) {
+  if (io_backend_ == nullptr) {
+    LOG_DEBUG("I/O on a disk manager that is shut down");
+    return;
+  }
+
+  // O_DIRECT needs aligned buffers, so unaligned pages go through aligned bounce buffers.
+  std::vector<std::pair<DiskRequest *, char *>> bounced;
+  for (size_t i = 0; i < num_requests; ++i) {
+    if (requests[i].is_write_) {
+      num_writes_ += 1;
+    }
+    if (direct_io_ && reinterpret_cast<uintptr_t>(requests[i].data_) % DIRECT_IO_ALIGNMENT != 0) {
+      auto *buffer = static_cast<char *>(std::aligned_alloc(DIRECT_IO_ALIGNMENT, PAGE_SIZE));
+      if (requests[i].is_write_) {
+        memcpy(buffer, requests[i].data_, PAGE_SIZE);
+      }
+      bounced.emplace_back(&requests[i], requests[i].data_);
+      requests[i].data_ = buffer;
     }
-    // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < PAGE_SIZE) {
-      LOG_DEBUG("Read less than a page");
-      db_io_.clear();
-      // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+  }
+
+  io_backend_->Execute(requests, num_requests);
+
+  for (auto &[request, original] : bounced) {
+    if (!request->is_write_) {
+      memcpy(original, request->data_, PAGE_SIZE);
     }
+    std::free(request->data_);
+    request->data_ = original;
   }
 }
 
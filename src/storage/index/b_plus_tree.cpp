@@ -9,7 +9,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <string>
+#include <thread>  // NOLINT
 
 #include "common/config.h"
 #include "common/exception.h"
@@ -24,17 +26,37 @@
 namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                          int leaf_max_size, int internal_max_size)
+                          int leaf_max_size, int internal_max_size, bool compress_keys, bool unique_keys,
+                          page_id_t header_page_id)
     : index_name_(std::move(name)),
+      header_page_id_(header_page_id),
       root_page_id_(INVALID_PAGE_ID),
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
       leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {
-
-  std::cout << "[DEBUG] leaf max size " << leaf_max_size << " internal max size " << internal_max_size << std::endl;
+      internal_max_size_(internal_max_size),
+      key_size_(sizeof(KeyType)),
+      unique_keys_(unique_keys) {
+  if (compress_keys) {
+    // pages keep only the key bytes the key schema can set, so the same page space holds more entries
+    key_size_ = std::min<int>(sizeof(KeyType), comparator_.KeyLength());
+    leaf_max_size_ = leaf_max_size * sizeof(MappingType) / (key_size_ + sizeof(ValueType));
+    internal_max_size_ = internal_max_size * sizeof(std::pair<KeyType, page_id_t>) / (key_size_ + sizeof(page_id_t));
+  }
+  // never more entries than a page holds; an internal page briefly holds internal_max_size_ + 1 children before it
+  // splits
+  leaf_max_size_ = std::min<int>(leaf_max_size_, (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / (key_size_ + sizeof(ValueType)));
+  internal_max_size_ = std::min<int>(internal_max_size_,
+                                     (PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (key_size_ + sizeof(page_id_t)) - 1);
+  // leaves merge below half full, like internal pages, until told otherwise
+  leaf_merge_size_ = std::max(leaf_max_size_ / 2, 1);
+
+  std::cout << "[DEBUG] leaf max size " << leaf_max_size_ << " internal max size " << internal_max_size_ << std::endl;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::~BPlusTree() { StopBackgroundCompaction(); }
+
 /*
  * Helper function to decide whether current b+tree is empty
  */
@@ -92,7 +114,10 @@ void BPLUSTREE_TYPE::UnLockAndUnpinPages(Transaction *transaction, OperationType
   }
   // delete some pages if any
   for (page_id_t page_id: *transaction->GetDeletedPageSet()) {
-    assert(buffer_pool_manager_->DeletePage(page_id));
+    // the page is no longer reachable from the tree, but a thread that just unlatched it may not have unpinned it yet
+    while (!buffer_pool_manager_->DeletePage(page_id)) {
+      std::this_thread::yield();
+    }
     // LOG_DEBUG("delete page id %u", page_id);
   }
   transaction->GetDeletedPageSet()->clear();
@@ -108,9 +133,9 @@ void BPLUSTREE_TYPE::UnLockAndUnpinPages(Transaction *transaction, OperationType
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::GetLeafPageOfKey(const KeyType &key, Page **page, bool leftMost, 
-  OperationType type, Transaction *transaction) {
+  OperationType type, Transaction *transaction, bool rightMost) {
   
-  if (transaction == nullptr) {
+  if (transaction == nullptr && type != OperationType::SearchKey) {
     root_page_mutex_.unlock();
   }
 
@@ -160,9 +185,12 @@ bool BPLUSTREE_TYPE::GetLeafPageOfKey(const KeyType &key, Page **page, bool left
           }
         }
 
-      } else if (type == OperationType::DeleteKey) {
-
-        if (b_plus_tree_page->GetSize() > b_plus_tree_page->GetMinSize()) {
+      } else if (type == OperationType::DeleteKey || type == OperationType::CompactKey) {
+        // a leaf has its own merge threshold, and a leaf being compacted is never safe
+        bool safe = b_plus_tree_page->IsLeafPage()
+                        ? type == OperationType::DeleteKey && b_plus_tree_page->GetSize() > leaf_merge_size_
+                        : b_plus_tree_page->GetSize() > b_plus_tree_page->GetMinSize();
+        if (safe) {
           // it is safe for deleting
           UnLockAndUnpinPages(transaction, OperationType::InsertKey);
         }
@@ -177,7 +205,7 @@ bool BPLUSTREE_TYPE::GetLeafPageOfKey(const KeyType &key, Page **page, bool left
     if (b_plus_tree_page->IsLeafPage()) {
       // we finally get the leaf page
       auto leaf_page = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE*>((*page)->GetData());
-      if (leftMost) {
+      if (leftMost || rightMost) {
         return true;
       }
       ValueType value;
@@ -193,6 +221,8 @@ bool BPLUSTREE_TYPE::GetLeafPageOfKey(const KeyType &key, Page **page, bool left
     auto intern_page = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>*>((*page)->GetData());
     if (leftMost) {
       next_page_id = intern_page->ValueAt(0);
+    } else if (rightMost) {
+      next_page_id = intern_page->ValueAt(intern_page->GetSize() - 1);
     } else {
       next_page_id = intern_page->Lookup(key, comparator_);
     }
@@ -201,17 +231,89 @@ bool BPLUSTREE_TYPE::GetLeafPageOfKey(const KeyType &key, Page **page, bool left
 }
 
 
+/*
+ * Helper function to get the leaf page of the given key for an optimistic
+ * insert or remove: descend with read latches and write latch only the leaf.
+ * Must hold the root page mutex and the tree must not be empty when calling
+ * this function. The mutex is released once the root page is passed, so it is
+ * still held on return only if the leaf is the root, which is what
+ * holds_root_mutex tells.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::GetLeafPageOptimistic(const KeyType &key, bool *holds_root_mutex) {
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  assert(page != nullptr);
+  *holds_root_mutex = reinterpret_cast<BPlusTreePage*>(page->GetData())->IsLeafPage();
+  if (*holds_root_mutex) {
+    page->WLatch();
+    return page;
+  }
+  page->RLatch();
+  bool is_root = true;
+
+  while (true) {
+    auto intern_page = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>*>(page->GetData());
+    Page *child = buffer_pool_manager_->FetchPage(intern_page->Lookup(key, comparator_));
+    assert(child != nullptr);
+    // the parent is read latched, so the child can't be split, merged or deleted under us
+    bool is_leaf = reinterpret_cast<BPlusTreePage*>(child->GetData())->IsLeafPage();
+    if (is_leaf) {
+      child->WLatch();
+    } else {
+      child->RLatch();
+    }
+    if (is_root) {
+      root_page_mutex_.unlock();
+      is_root = false;
+    }
+    page->RUnlatch();
+    assert(buffer_pool_manager_->UnpinPage(page->GetPageId(), false));
+    page = child;
+    if (is_leaf) {
+      return page;
+    }
+  }
+}
+
+/*
+ * Release a leaf page returned by GetLeafPageOptimistic(), and the root page
+ * mutex if it said the mutex is still held. Whether the leaf is the root is
+ * not asked again here, since a split or collapse of the root changes that.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::UnLockAndUnpinLeafPage(Page *page, bool holds_root_mutex, bool is_dirty) {
+  if (holds_root_mutex) {
+    root_page_mutex_.unlock();
+  }
+  page->WUnlatch();
+  assert(buffer_pool_manager_->UnpinPage(page->GetPageId(), is_dirty));
+}
+
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 /*
- * Return the only value that associated with input key
+ * Return the values that associated with input key
  * This method is used for point query
  * @return : true means key exists
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) {
 
+  if (comparator_.IsFixedWidth()) {
+    // search without latches, and start over whenever a writer got in the way
+    ValueType value;
+    bool found;
+    while (!TryOptimisticGetValue(key, &value, &found)) {
+    }
+    if (!found || !IsPostingList(value)) {
+      if (found) {
+        result->push_back(value);
+      }
+      return found;
+    }
+    // a posting list is only read with its leaf page latched, so search again below
+  }
 
   // ToString(reinterpret_cast<BPlusTreePage*>(buffer_pool_manager_->FetchPage(root_page_id_)->GetData()), buffer_pool_manager_);
 
@@ -234,7 +336,11 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
   auto leaf_page = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE*>(page->GetData());
   ValueType value;
   leaf_page->Lookup(key, &value, comparator_);
-  result->push_back(value);
+  if (IsPostingList(value)) {
+    CollectPostingList(value, result);
+  } else {
+    result->push_back(value);
+  }
   // std::cout << "[DEBUG] search key " << key << " in page " << page->GetPageId() << "\n";
 
   // we can safely release this node's lock
@@ -249,6 +355,69 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
   return true;
 }
 
+/*
+ * Search for the key without taking any latch or the root page mutex. Every
+ * page on the path is pinned, and its version is validated after it was read:
+ * a parent is validated again after the version of its child was read, so the
+ * child was still the right one at that point.
+ * Only used when comparing keys is safe on a page that a writer is changing.
+ * @return: false if a writer changed a page on the path and the search must
+ * start over, otherwise true with "found" telling whether the key exists
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::TryOptimisticGetValue(const KeyType &key, ValueType *value, bool *found) {
+  page_id_t page_id = root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    *found = false;
+    return true;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    // the root was merged away and deleted before we fetched it
+    return false;
+  }
+  uint64_t version = page->ReadVersion();
+  if (root_page_id_ != page_id) {
+    // the root changed before we got its version
+    assert(buffer_pool_manager_->UnpinPage(page_id, false));
+    return false;
+  }
+
+  while (true) {
+    if (reinterpret_cast<BPlusTreePage*>(page->GetData())->IsLeafPage()) {
+      auto leaf_page = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE*>(page->GetData());
+      *found = leaf_page->Lookup(key, value, comparator_);
+      bool valid = page->ValidateVersion(version);
+      assert(buffer_pool_manager_->UnpinPage(page_id, false));
+      return valid;
+    }
+
+    auto intern_page = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>*>(page->GetData());
+    page_id_t child_page_id = intern_page->Lookup(key, comparator_);
+    // don't follow a child pointer read from a page in the middle of a change
+    if (!page->ValidateVersion(version)) {
+      assert(buffer_pool_manager_->UnpinPage(page_id, false));
+      return false;
+    }
+    Page *child = buffer_pool_manager_->FetchPage(child_page_id);
+    if (child == nullptr) {
+      // the child was merged away and deleted after its pointer was read
+      assert(buffer_pool_manager_->UnpinPage(page_id, false));
+      return false;
+    }
+    uint64_t child_version = child->ReadVersion();
+    bool valid = page->ValidateVersion(version);
+    assert(buffer_pool_manager_->UnpinPage(page_id, false));
+    if (!valid) {
+      assert(buffer_pool_manager_->UnpinPage(child_page_id, false));
+      return false;
+    }
+    page = child;
+    page_id = child_page_id;
+    version = child_version;
+  }
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -256,12 +425,20 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  * Insert constant key & value pair into b+ tree
  * if current tree is empty, start new tree, update root page id and insert
  * entry, otherwise insert into leaf page.
- * @return: since we only support unique key, if user try to insert duplicate
- * keys return false, otherwise return true.
+ * @return: if keys are unique and user try to insert duplicate keys return
+ * false, otherwise return true.
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
   root_page_mutex_.lock();
+  if (root_page_id_ != INVALID_PAGE_ID) {
+    bool inserted;
+    if (TryOptimisticInsert(key, value, &inserted)) {
+      return inserted;
+    }
+    // the leaf may split, so restart and latch the whole path
+    root_page_mutex_.lock();
+  }
   if (root_page_id_ == INVALID_PAGE_ID) {
     StartNewTree(key, value);
     root_page_mutex_.unlock();
@@ -270,6 +447,35 @@ bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   }
   return true;
 }
+
+/*
+ * Insert into the leaf page with only the leaf write latched.
+ * Must hold the root page mutex and the tree must not be empty when calling
+ * this function; the mutex is always released on return.
+ * @return: false if the leaf is full enough to split and nothing was done,
+ * otherwise true with "inserted" telling whether the key was new.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::TryOptimisticInsert(const KeyType &key, const ValueType &value, bool *inserted) {
+  bool holds_root_mutex;
+  Page *page = GetLeafPageOptimistic(key, &holds_root_mutex);
+  auto leaf_page = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE*>(page->GetData());
+  ValueType old_value;
+  if (leaf_page->Lookup(key, &old_value, comparator_)) {
+    // the key has already existed
+    *inserted = !unique_keys_ && AddToPostingList(leaf_page, key, old_value, value);
+    UnLockAndUnpinLeafPage(page, holds_root_mutex, *inserted);
+    return true;
+  }
+  if (leaf_page->GetSize() >= leaf_page->GetMaxSize() - 1) {
+    UnLockAndUnpinLeafPage(page, holds_root_mutex, false);
+    return false;
+  }
+  leaf_page->Insert(key, value, comparator_);
+  UnLockAndUnpinLeafPage(page, holds_root_mutex, true);
+  *inserted = true;
+  return true;
+}
 /*
  * Insert constant key & value pair into an empty tree
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
@@ -283,24 +489,133 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
   if (page == nullptr) {
     throw Exception(ExceptionType::OUT_OF_MEMORY, "buffer pool out of memory");
   }
-  root_page_id_ = page_id;
-  UpdateRootPageId();
   // 1) we first construct a root page(leaf page)
   auto root_page = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE*>(page->GetData());
-  root_page->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+  root_page->Init(page_id, INVALID_PAGE_ID, leaf_max_size_, key_size_);
   // 2) just insert the kv into leaf page
   // std::cout << "[DEBUG] (start new tree) insert key " << key << " val " << value << std::endl;
   root_page->Insert(key, value, comparator_);
+  // 3) publish the root only now, optimistic readers may follow it at once
+  root_page_id_ = page_id;
+  UpdateRootPageId();
   assert(buffer_pool_manager_->UnpinPage(page_id, true));
 }
 
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+/*
+ * Build the tree bottom-up: sort the items, fill the leaves left to right, then
+ * build each internal level from the first keys of the level below until a
+ * single page is left, which becomes the root. Only one new page is pinned at a
+ * time. Of several items with the same key, only the first is kept, unless
+ * keys need not be unique: then their values make up the key's posting list.
+ * @return: false if the tree is not empty, otherwise true
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::BulkLoad(std::vector<MappingType> *items, double fill_factor) {
+  std::lock_guard<std::mutex> guard(root_page_mutex_);
+  if (root_page_id_ != INVALID_PAGE_ID) {
+    return false;
+  }
+  std::stable_sort(items->begin(), items->end(), [this](const MappingType &lhs, const MappingType &rhs) {
+    return comparator_(lhs.first, rhs.first) < 0;
+  });
+  auto out = items->begin();
+  for (auto first = items->begin(); first != items->end();) {
+    auto last = first + 1;
+    while (last != items->end() && comparator_(last->first, first->first) == 0) {
+      ++last;
+    }
+    ValueType value = first->second;
+    if (!unique_keys_ && last - first > 1) {
+      value = NewPostingList(&*first, &*first + (last - first));
+    }
+    *out++ = {first->first, value};
+    first = last;
+  }
+  items->erase(out, items->end());
+  if (items->empty()) {
+    return true;
+  }
+
+  // 1) the leaves, linked left to right; a leaf splits once it holds leaf_max_size_ items
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  int num_items = static_cast<int>(items->size());
+  int num_pages = BulkLoadPageCount(num_items, leaf_max_size_ - 1, leaf_max_size_ / 2, fill_factor);
+  B_PLUS_TREE_LEAF_PAGE_TYPE *prev_leaf = nullptr;
+  for (int i = 0, offset = 0; i < num_pages; ++i) {
+    int size = num_items / num_pages + (i < num_items % num_pages ? 1 : 0);
+    page_id_t page_id;
+    auto page = buffer_pool_manager_->NewPage(&page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "buffer pool out of memory");
+    }
+    auto leaf_page = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE*>(page->GetData());
+    leaf_page->Init(page_id, INVALID_PAGE_ID, leaf_max_size_, key_size_);
+    leaf_page->CopyNFrom(items->data() + offset, size);
+    level.emplace_back((*items)[offset].first, page_id);
+    offset += size;
+    if (prev_leaf != nullptr) {
+      leaf_page->SetPrevPageId(prev_leaf->GetPageId());
+      prev_leaf->SetNextPageId(page_id);
+      assert(buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true));
+    }
+    prev_leaf = leaf_page;
+  }
+  assert(buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true));
+
+  // 2) the internal levels; an internal page splits once it holds internal_max_size_ + 1 children
+  while (level.size() > 1) {
+    std::vector<std::pair<KeyType, page_id_t>> upper_level;
+    num_items = static_cast<int>(level.size());
+    num_pages = BulkLoadPageCount(num_items, internal_max_size_, internal_max_size_ / 2, fill_factor);
+    for (int i = 0, offset = 0; i < num_pages; ++i) {
+      int size = num_items / num_pages + (i < num_items % num_pages ? 1 : 0);
+      page_id_t page_id;
+      auto page = buffer_pool_manager_->NewPage(&page_id);
+      if (page == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "buffer pool out of memory");
+      }
+      auto intern_page = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>*>(page->GetData());
+      intern_page->Init(page_id, INVALID_PAGE_ID, internal_max_size_, key_size_);
+      // the first key of every child is its separator, the one of the first child is just never read
+      intern_page->CopyNFrom(level.data() + offset, size, buffer_pool_manager_);
+      upper_level.emplace_back(level[offset].first, page_id);
+      offset += size;
+      assert(buffer_pool_manager_->UnpinPage(page_id, true));
+    }
+    level = std::move(upper_level);
+  }
+
+  root_page_id_ = level[0].second;
+  UpdateRootPageId(1);
+  return true;
+}
+
+/*
+ * Helper for BulkLoad(): the number of pages that num_items items (or
+ * children) are spread over evenly, so that each page is filled to about
+ * fill_factor of max_items but holds no more than max_items and, unless there
+ * is a single page, no less than min_items.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int BPLUSTREE_TYPE::BulkLoadPageCount(int num_items, int max_items, int min_items, double fill_factor) {
+  int fill_items = std::max(1, std::min(max_items, static_cast<int>(max_items * fill_factor)));
+  int num_pages = (num_items + fill_items - 1) / fill_items;
+  int max_pages = std::max(1, num_items / std::max(1, min_items));
+  int min_pages = (num_items + max_items - 1) / max_items;
+  return std::max(min_pages, std::min(num_pages, max_pages));
+}
+
 /*
  * Insert constant key & value pair into leaf page
  * User needs to first find the right leaf page as insertion target, then look
  * through leaf page to see whether insert key exist or not. If exist, return
- * immdiately, otherwise insert entry. Remember to deal with split if necessary.
- * @return: since we only support unique key, if user try to insert duplicate
- * keys return false, otherwise return true.
+ * immdiately (or add the value to the key's posting list), otherwise insert
+ * entry. Remember to deal with split if necessary.
+ * @return: if keys are unique and user try to insert duplicate keys return
+ * false, otherwise return true.
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction) {
@@ -308,8 +623,15 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
   Page *page = nullptr;
   if (GetLeafPageOfKey(key, &page, false, OperationType::InsertKey, transaction)) {
     // the key has already existed
+    bool inserted = false;
+    if (!unique_keys_) {
+      auto leaf_page = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE*>(page->GetData());
+      ValueType old_value;
+      leaf_page->Lookup(key, &old_value, comparator_);
+      inserted = AddToPostingList(leaf_page, key, old_value, value);
+    }
     UnLockAndUnpinPages(transaction, OperationType::InsertKey);
-    return false;
+    return inserted;
   }
   // keep pin count consistant
   buffer_pool_manager_->FetchPage(page->GetPageId());
@@ -353,17 +675,21 @@ N *BPLUSTREE_TYPE::Split(N *node) {
   if (node->IsLeafPage()) {
     // leaf page
     auto new_page = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE*>(page->GetData());
-    new_page->Init(page_id, node->GetParentPageId(), leaf_max_size_);
+    new_page->Init(page_id, node->GetParentPageId(), leaf_max_size_, key_size_);
     auto old_node = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE*>(node);
     old_node->MoveHalfTo(new_page);
-    // modify the sibling pointer
+    // modify the sibling pointers
     new_page->SetNextPageId(old_node->GetNextPageId());
+    new_page->SetPrevPageId(old_node->GetPageId());
     old_node->SetNextPageId(page_id);
+    if (new_page->GetNextPageId() != INVALID_PAGE_ID) {
+      SetPrevPageIdOf(new_page->GetNextPageId(), page_id, nullptr);
+    }
 
   } else {
     // internal page
     auto new_page = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>*>(page->GetData());
-    new_page->Init(page_id, node->GetParentPageId(), internal_max_size_);
+    new_page->Init(page_id, node->GetParentPageId(), internal_max_size_, key_size_);
     auto old_node = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>*>(node);
     old_node->MoveHalfTo(new_page, buffer_pool_manager_);
   }
@@ -371,6 +697,32 @@ N *BPLUSTREE_TYPE::Split(N *node) {
   return reinterpret_cast<N*>(page->GetData());
 }
 
+/*
+ * Point the leaf page back at prev_page_id after the page before it changed.
+ * The caller holds the write latch of the page before, and latches always go
+ * from a leaf to the one after it, never back. The leaf page may already be
+ * write latched by the transaction, e.g. as a sibling looked at by
+ * CoalesceOrRedistribute().
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SetPrevPageIdOf(page_id_t page_id, page_id_t prev_page_id, Transaction *transaction) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  assert(page != nullptr);
+  bool latched = false;
+  if (transaction != nullptr) {
+    auto page_set = transaction->GetPageSet();
+    latched = std::find(page_set->begin(), page_set->end(), page) != page_set->end();
+  }
+  if (!latched) {
+    page->WLatch();
+  }
+  reinterpret_cast<LeafPage *>(page->GetData())->SetPrevPageId(prev_page_id);
+  if (!latched) {
+    page->WUnlatch();
+  }
+  assert(buffer_pool_manager_->UnpinPage(page_id, true));
+}
+
 /*
  * Insert key & value pair into internal page after split
  * @param   old_node      input page from split() method
@@ -396,7 +748,7 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
       throw Exception(ExceptionType::OUT_OF_MEMORY, "buffer pool out of memory");
     }
     auto new_page = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>*>(page->GetData());
-    new_page->Init(new_page_id, INVALID_PAGE_ID, internal_max_size_);
+    new_page->Init(new_page_id, INVALID_PAGE_ID, internal_max_size_, key_size_);
 
     new_page->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
 
@@ -459,12 +811,37 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  RemoveEntry(key, nullptr, transaction);
+}
+
+/*
+ * Delete the given value of input key. The key goes away with its last value.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Remove(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  RemoveEntry(key, &value, transaction);
+}
+
+/*
+ * Delete the given value of input key, or every value if value is nullptr
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveEntry(const KeyType &key, const ValueType *value, Transaction *transaction) {
   root_page_mutex_.lock();
   if (root_page_id_ == INVALID_PAGE_ID) {
     // empty tree
     root_page_mutex_.unlock();
     return;
   }
+  if (TryOptimisticRemove(key, value)) {
+    return;
+  }
+  // the leaf may underflow, so restart and latch the whole path
+  root_page_mutex_.lock();
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    root_page_mutex_.unlock();
+    return;
+  }
 
   // we need to traverse down to find the right leaf
   // root_page_mutex_.unlock();
@@ -481,15 +858,22 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
 
   auto leaf_page = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE*>(page->GetData());
 
+  if (!RemoveValue(leaf_page, key, value)) {
+    // the key keeps other values
+    assert(buffer_pool_manager_->UnpinPage(page->GetPageId(), true));
+    UnLockAndUnpinPages(transaction, OperationType::DeleteKey);
+    return;
+  }
+
   // delete the key from this leaf
   int leaf_size = leaf_page->RemoveAndDeleteRecord(key, comparator_);
   // std::cout << "[DEBUG] delete key " << key << " in page " << leaf_page->GetPageId() << std::endl;
 
-  if (leaf_size < leaf_page->GetMinSize()) {
+  if (leaf_size < leaf_merge_size_) {
     // we need to merge or redistribute the leaf  
     LOG_DEBUG("leaf page %u needs to merge or redistribute, leaf_size %d, min_size %d", 
-      leaf_page->GetPageId(), leaf_size, leaf_page->GetMinSize());
-    if (CoalesceOrRedistribute(leaf_page, transaction)) {
+      leaf_page->GetPageId(), leaf_size, leaf_merge_size_);
+    if (CoalesceOrRedistribute(leaf_page, leaf_merge_size_, transaction)) {
       // the leaf is merged with its sibling page
       // then we should check whether their parent should merge
       // TODO(greenhandzpx)
@@ -505,16 +889,70 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
 
 }
 
+/*
+ * Remove from the leaf page with only the leaf write latched.
+ * Must hold the root page mutex and the tree must not be empty when calling
+ * this function; the mutex is always released on return.
+ * @return: false if the leaf may need to merge or redistribute and nothing was
+ * done, otherwise true
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::TryOptimisticRemove(const KeyType &key, const ValueType *value) {
+  bool holds_root_mutex;
+  Page *page = GetLeafPageOptimistic(key, &holds_root_mutex);
+  auto leaf_page = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE*>(page->GetData());
+  ValueType old_value;
+  if (!leaf_page->Lookup(key, &old_value, comparator_)) {
+    // the key doesn't exist
+    UnLockAndUnpinLeafPage(page, holds_root_mutex, false);
+    return true;
+  }
+  bool remove_key = value == nullptr || (!IsPostingList(old_value) && old_value == *value);
+  if (remove_key && leaf_page->GetSize() <= leaf_merge_size_) {
+    UnLockAndUnpinLeafPage(page, holds_root_mutex, false);
+    return false;
+  }
+  if (RemoveValue(leaf_page, key, value)) {
+    leaf_page->RemoveAndDeleteRecord(key, comparator_);
+  }
+  UnLockAndUnpinLeafPage(page, holds_root_mutex, true);
+  return true;
+}
+
+/*
+ * Delete the given value (every value if value is nullptr) of a key in the
+ * leaf page, which the caller holds write latched. A value in a posting list
+ * is removed right away, the key itself is left to the caller.
+ * @return: true if the key has no value left and must be removed from the leaf
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::RemoveValue(LeafPage *leaf_page, const KeyType &key, const ValueType *value) {
+  ValueType old_value;
+  if (!leaf_page->Lookup(key, &old_value, comparator_)) {
+    return false;
+  }
+  if (!IsPostingList(old_value)) {
+    return value == nullptr || old_value == *value;
+  }
+  if (value == nullptr) {
+    DeletePostingList(old_value);
+    return true;
+  }
+  RemoveFromPostingList(leaf_page, key, old_value, *value);
+  return false;
+}
+
 /*
  * User needs to first find the sibling of input page. If sibling's size + input
  * page's size > page's max size, then redistribute. Otherwise, merge.
+ * A sibling gives an entry away only if it has more than min_size of them.
  * Using template N to represent either internal page or leaf page.
  * @return: true means target leaf page should be deleted, false means no
  * deletion happens
  */
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
-bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
+bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, int min_size, Transaction *transaction) {
 
   page_id_t parent_page_id = node->GetParentPageId();
   if (parent_page_id == INVALID_PAGE_ID) {
@@ -548,7 +986,7 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
     assert(left_page != nullptr);
 
     // LOG_DEBUG("left size %d index %d", left_page->GetSize(), index-1);  
-    if (left_page->GetSize() > left_page->GetMinSize()) {
+    if (left_page->GetSize() > min_size) {
       // the left sibling page can give a kv to the node
       auto left_n_page = reinterpret_cast<N*>(left_page);
       if (!node->IsLeafPage()) {
@@ -583,7 +1021,7 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
     right_page = reinterpret_cast<BPlusTreePage*>(right_raw_page->GetData());
     assert(right_page != nullptr);
     // LOG_DEBUG("right size %d index %d", right_page->GetSize(), index+1);  
-    if (right_page->GetSize() > right_page->GetMinSize()) {
+    if (right_page->GetSize() > min_size) {
       // the right sibling page can give a kv to the node
       auto right_n_page = reinterpret_cast<N*>(right_page);
       if (!node->IsLeafPage()) {
@@ -652,6 +1090,9 @@ bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
     auto neighbor_leaf_node = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE*>(*neighbor_node);
     auto leaf_node = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE*>(*node);
     leaf_node->MoveAllTo(neighbor_leaf_node);
+    if (neighbor_leaf_node->GetNextPageId() != INVALID_PAGE_ID) {
+      SetPrevPageIdOf(neighbor_leaf_node->GetNextPageId(), neighbor_leaf_node->GetPageId(), transaction);
+    }
 
   } else {
 
@@ -680,7 +1121,7 @@ bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
 
   if ((*parent)->GetSize() < (*parent)->GetMinSize()) {
     // parent also needs to adjust 
-    return CoalesceOrRedistribute(*parent, transaction);
+    return CoalesceOrRedistribute(*parent, (*parent)->GetMinSize(), transaction);
   }
   // else, unLock all pages above
   assert(buffer_pool_manager_->UnpinPage((*parent)->GetPageId(), true));
@@ -786,6 +1227,310 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node, Transaction *trans
   return false;
 }
 
+/*****************************************************************************
+ * COMPACTION
+ *****************************************************************************/
+/*
+ * Set the size under which Remove() merges or redistributes a leaf to min_fill
+ * of the leaf max size. A lower threshold leaves more half-empty leaves behind
+ * but latches siblings and parents far less often; Compact() cleans up after it.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SetLeafMergeThreshold(double min_fill) {
+  min_fill = std::min(std::max(min_fill, 0.0), 0.5);
+  // a leaf that runs empty always goes
+  leaf_merge_size_ = std::max(static_cast<int>(leaf_max_size_ * min_fill), 1);
+}
+
+/*
+ * Walk the leaves left to right and note the first key of each one under half
+ * full, then compact those leaves one at a time. Leaves that change while the
+ * pass runs are left to the next pass.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Compact(Transaction *transaction) {
+  Transaction local_transaction(INVALID_TXN_ID);
+  if (transaction == nullptr) {
+    transaction = &local_transaction;
+  }
+
+  root_page_mutex_.lock();
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    root_page_mutex_.unlock();
+    return;
+  }
+  Page *page;
+  GetLeafPageOfKey(KeyType(), &page, true, OperationType::SearchKey, nullptr);
+  if (reinterpret_cast<BPlusTreePage *>(page->GetData())->IsRootPage()) {
+    // a root leaf has no siblings to merge with
+    root_page_mutex_.unlock();
+    page->RUnlatch();
+    assert(buffer_pool_manager_->UnpinPage(page->GetPageId(), false));
+    return;
+  }
+
+  std::vector<KeyType> keys;
+  while (page != nullptr) {
+    auto leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+    if (leaf_page->GetSize() == 0) {
+      // the leaf was merged away since it was pinned, so its next page id is stale
+      page->RUnlatch();
+      assert(buffer_pool_manager_->UnpinPage(page->GetPageId(), false));
+      break;
+    }
+    if (leaf_page->GetSize() < leaf_page->GetMinSize()) {
+      keys.push_back(leaf_page->KeyAt(0));
+    }
+    // pin the next leaf before letting go of this one, so that it can't be deleted in between; it is latched only
+    // after this one is unlatched, as a merge latches a leaf before its left sibling
+    page_id_t next_page_id = leaf_page->GetNextPageId();
+    Page *next_page = next_page_id == INVALID_PAGE_ID ? nullptr : buffer_pool_manager_->FetchPage(next_page_id);
+    page->RUnlatch();
+    assert(buffer_pool_manager_->UnpinPage(page->GetPageId(), false));
+    page = next_page;
+    if (page != nullptr) {
+      page->RLatch();
+    }
+  }
+
+  for (const auto &key : keys) {
+    CompactLeaf(key, transaction);
+  }
+}
+
+/*
+ * Merge the leaf that key belongs in with a sibling if it is still under half
+ * full, or take an entry from the sibling if both don't fit in one leaf.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CompactLeaf(const KeyType &key, Transaction *transaction) {
+  root_page_mutex_.lock();
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    root_page_mutex_.unlock();
+    return;
+  }
+  Page *page;
+  GetLeafPageOfKey(key, &page, false, OperationType::CompactKey, transaction);
+  auto leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+  if (!leaf_page->IsRootPage() && leaf_page->GetSize() < leaf_page->GetMinSize()) {
+    // keep pin count consistant, CoalesceOrRedistribute() unpins the leaf once
+    buffer_pool_manager_->FetchPage(page->GetPageId());
+    CoalesceOrRedistribute(leaf_page, leaf_max_size_ - 1 - leaf_page->GetSize(), transaction);
+  }
+  UnLockAndUnpinPages(transaction, OperationType::CompactKey);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StartBackgroundCompaction() {
+  std::lock_guard<std::mutex> guard(compaction_latch_);
+  if (compaction_thread_ != nullptr) {
+    return;
+  }
+  compaction_running_ = true;
+  compaction_thread_ = new std::thread(&BPLUSTREE_TYPE::RunBackgroundCompaction, this);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StopBackgroundCompaction() {
+  {
+    std::lock_guard<std::mutex> guard(compaction_latch_);
+    if (compaction_thread_ == nullptr) {
+      return;
+    }
+    compaction_running_ = false;
+  }
+  compaction_cv_.notify_one();
+  compaction_thread_->join();
+  delete compaction_thread_;
+  compaction_thread_ = nullptr;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RunBackgroundCompaction() {
+  Transaction transaction(INVALID_TXN_ID);
+  std::unique_lock<std::mutex> lock(compaction_latch_);
+  while (compaction_running_) {
+    compaction_cv_.wait_for(lock, btree_compaction_interval);
+    if (!compaction_running_) {
+      break;
+    }
+    lock.unlock();
+    Compact(&transaction);
+    lock.lock();
+  }
+}
+
+/*****************************************************************************
+ * POSTING LIST
+ *****************************************************************************/
+/*
+ * Helper to tell whether a leaf value refers to a posting list. Only a tree
+ * without unique keys has posting lists; in any other tree every value is a
+ * record id of its own.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::IsPostingList(const ValueType &value) const {
+  return !unique_keys_ && BPlusTreePostingPage::IsPostingList(value);
+}
+
+/*
+ * Add value to a key that is already in the leaf page, which the caller holds
+ * write latched. The second value of a key moves both into a new posting page;
+ * after that, a new posting page goes in front of the list once the first one
+ * is full.
+ * @return: false if value is already the only value of the key
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::AddToPostingList(LeafPage *leaf_page, const KeyType &key, const ValueType &old_value,
+                                      const ValueType &value) {
+  page_id_t next_page_id = INVALID_PAGE_ID;
+  if (IsPostingList(old_value)) {
+    auto posting_page =
+        reinterpret_cast<BPlusTreePostingPage *>(buffer_pool_manager_->FetchPage(old_value.GetPageId())->GetData());
+    bool is_full = posting_page->IsFull();
+    if (!is_full) {
+      posting_page->Append(value);
+    }
+    assert(buffer_pool_manager_->UnpinPage(old_value.GetPageId(), !is_full));
+    if (!is_full) {
+      return true;
+    }
+    next_page_id = old_value.GetPageId();
+  } else if (old_value == value) {
+    return false;
+  }
+
+  page_id_t page_id;
+  auto page = buffer_pool_manager_->NewPage(&page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "buffer pool out of memory");
+  }
+  auto posting_page = reinterpret_cast<BPlusTreePostingPage *>(page->GetData());
+  posting_page->Init(next_page_id);
+  if (next_page_id == INVALID_PAGE_ID) {
+    posting_page->Append(old_value);
+  }
+  posting_page->Append(value);
+  assert(buffer_pool_manager_->UnpinPage(page_id, true));
+  leaf_page->SetValue(key, BPlusTreePostingPage::PostingListOf(page_id), comparator_);
+  return true;
+}
+
+/*
+ * Remove value from the posting list of a key in the leaf page, which the
+ * caller holds write latched. A posting page that runs empty is unlinked and
+ * deleted, and when a single value is left it moves back into the leaf page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveFromPostingList(LeafPage *leaf_page, const KeyType &key, const ValueType &list,
+                                           const ValueType &value) {
+  page_id_t first_page_id = list.GetPageId();
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  page_id_t page_id = first_page_id;
+  while (page_id != INVALID_PAGE_ID) {
+    auto posting_page = reinterpret_cast<BPlusTreePostingPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    page_id_t next_page_id = posting_page->GetNextPageId();
+    bool removed = posting_page->Remove(value);
+    bool is_empty = posting_page->GetSize() == 0;
+    assert(buffer_pool_manager_->UnpinPage(page_id, removed));
+    if (!removed) {
+      prev_page_id = page_id;
+      page_id = next_page_id;
+      continue;
+    }
+    if (is_empty) {
+      if (prev_page_id == INVALID_PAGE_ID) {
+        first_page_id = next_page_id;
+      } else {
+        auto prev_page =
+            reinterpret_cast<BPlusTreePostingPage *>(buffer_pool_manager_->FetchPage(prev_page_id)->GetData());
+        prev_page->SetNextPageId(next_page_id);
+        assert(buffer_pool_manager_->UnpinPage(prev_page_id, true));
+      }
+      DeletePostingPage(page_id);
+    }
+    break;
+  }
+
+  // a list always holds two values or more, so a removal never empties it
+  auto first_page = reinterpret_cast<BPlusTreePostingPage *>(buffer_pool_manager_->FetchPage(first_page_id)->GetData());
+  if (first_page->GetSize() == 1 && first_page->GetNextPageId() == INVALID_PAGE_ID) {
+    leaf_page->SetValue(key, first_page->RidAt(0), comparator_);
+    assert(buffer_pool_manager_->UnpinPage(first_page_id, false));
+    DeletePostingPage(first_page_id);
+  } else {
+    assert(buffer_pool_manager_->UnpinPage(first_page_id, false));
+    leaf_page->SetValue(key, BPlusTreePostingPage::PostingListOf(first_page_id), comparator_);
+  }
+}
+
+/*
+ * Write the values of items [first, last) into new posting pages, filled back
+ * to front so that each page knows the next one when it is written.
+ * @return: the leaf value that refers to the new posting list
+ */
+INDEX_TEMPLATE_ARGUMENTS
+ValueType BPLUSTREE_TYPE::NewPostingList(const MappingType *first, const MappingType *last) {
+  page_id_t next_page_id = INVALID_PAGE_ID;
+  while (last != first) {
+    const MappingType *page_first = last - std::min<ptrdiff_t>(last - first, POSTING_PAGE_SIZE);
+    page_id_t page_id;
+    auto page = buffer_pool_manager_->NewPage(&page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "buffer pool out of memory");
+    }
+    auto posting_page = reinterpret_cast<BPlusTreePostingPage *>(page->GetData());
+    posting_page->Init(next_page_id);
+    for (const MappingType *item = page_first; item != last; ++item) {
+      posting_page->Append(item->second);
+    }
+    assert(buffer_pool_manager_->UnpinPage(page_id, true));
+    next_page_id = page_id;
+    last = page_first;
+  }
+  return BPlusTreePostingPage::PostingListOf(next_page_id);
+}
+
+/*
+ * Append every value in the posting list to result
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::CollectPostingList(const ValueType &list, std::vector<ValueType> *result) {
+  page_id_t page_id = list.GetPageId();
+  while (page_id != INVALID_PAGE_ID) {
+    auto posting_page = reinterpret_cast<BPlusTreePostingPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    for (int i = 0; i < posting_page->GetSize(); ++i) {
+      result->push_back(posting_page->RidAt(i));
+    }
+    page_id_t next_page_id = posting_page->GetNextPageId();
+    assert(buffer_pool_manager_->UnpinPage(page_id, false));
+    page_id = next_page_id;
+  }
+}
+
+/*
+ * Delete every page of the posting list
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DeletePostingList(const ValueType &list) {
+  page_id_t page_id = list.GetPageId();
+  while (page_id != INVALID_PAGE_ID) {
+    auto posting_page = reinterpret_cast<BPlusTreePostingPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    page_id_t next_page_id = posting_page->GetNextPageId();
+    assert(buffer_pool_manager_->UnpinPage(page_id, false));
+    DeletePostingPage(page_id);
+    page_id = next_page_id;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::DeletePostingPage(page_id_t page_id) {
+  // an iterator that is just leaving the page may not have unpinned it yet
+  while (!buffer_pool_manager_->DeletePage(page_id)) {
+    std::this_thread::yield();
+  }
+}
+
 /*****************************************************************************
  * INDEX ITERATOR
  *****************************************************************************/
@@ -797,7 +1542,7 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node, Transaction *trans
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() {
   auto page = FindLeafPage({}, true);
-  return INDEXITERATOR_TYPE(buffer_pool_manager_, reinterpret_cast<LeafPage*>(page->GetData()), 0);
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, reinterpret_cast<LeafPage*>(page->GetData()), 0, unique_keys_);
 }
 
 /*
@@ -809,7 +1554,7 @@ INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
   auto page = FindLeafPage(key, false);
   auto leaf_page = reinterpret_cast<LeafPage*>(page->GetData());
-  return INDEXITERATOR_TYPE(buffer_pool_manager_, leaf_page, leaf_page->KeyIndex(key, comparator_));
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, leaf_page, leaf_page->KeyIndex(key, comparator_), unique_keys_);
 }
 
 /*
@@ -822,22 +1567,109 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::End() {
   return INDEXITERATOR_TYPE(buffer_pool_manager_, nullptr, -1);
 }
 
+/*
+ * Input parameter is void, find the rightmost leaf page first, then construct
+ * a reverse index iterator at its last key
+ * @return : reverse index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::RBegin() {
+  if (IsEmpty()) {
+    return End();
+  }
+  auto page = FindLeafPage({}, false, true);
+  auto leaf_page = reinterpret_cast<LeafPage*>(page->GetData());
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, leaf_page, leaf_page->GetSize() - 1, unique_keys_, true);
+}
+
+/*
+ * Input parameter is high key, find the leaf page that contains the input key
+ * first, then construct a reverse index iterator at the last key <= high key
+ * @return : reverse index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::RBegin(const KeyType &key) {
+  if (IsEmpty()) {
+    return End();
+  }
+  auto page = FindLeafPage(key, false);
+  auto leaf_page = reinterpret_cast<LeafPage*>(page->GetData());
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, leaf_page, StartIndex(leaf_page, key, true, true), unique_keys_,
+                            true);
+}
+
+/*
+ * The end of a reverse index iterator, which is the same as End()
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::REnd() {
+  return End();
+}
+
+/*
+ * Construct an index iterator over the keys between low key and high key,
+ * walking up from low key, or down from high key if reverse. It turns into
+ * End() at the first key out of range, and never fetches a leaf whose keys
+ * are all out of range. The leaf of the stop key bounds the read-ahead.
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Range(const KeyType &low_key, const KeyType &high_key, bool low_inclusive,
+                                         bool high_inclusive, bool reverse) {
+  if (IsEmpty()) {
+    return End();
+  }
+  const KeyType &start_key = reverse ? high_key : low_key;
+  const KeyType &stop_key = reverse ? low_key : high_key;
+  bool start_inclusive = reverse ? high_inclusive : low_inclusive;
+  bool stop_inclusive = reverse ? low_inclusive : high_inclusive;
+
+  page_id_t stop_page_id = INVALID_PAGE_ID;
+  if (scan_read_ahead_pages > 0) {
+    Page *stop_page = FindLeafPage(stop_key, false);
+    stop_page_id = stop_page->GetPageId();
+    assert(buffer_pool_manager_->UnpinPage(stop_page_id, false));
+  }
+  auto page = FindLeafPage(start_key, false);
+  auto leaf_page = reinterpret_cast<LeafPage*>(page->GetData());
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, leaf_page, StartIndex(leaf_page, start_key, start_inclusive, reverse),
+                            unique_keys_, reverse, &comparator_, stop_key, stop_inclusive, stop_page_id);
+}
+
+/*
+ * Helper for the iterators: the index of the first key in the leaf page that
+ * is >= key (> key if not inclusive), or of the last key that is <= key (< key)
+ * if reverse. It is off the end of the leaf page when the key is in the next
+ * (or previous) leaf page, and the iterator moves on by itself.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int BPLUSTREE_TYPE::StartIndex(LeafPage *leaf_page, const KeyType &key, bool inclusive, bool reverse) const {
+  int index = leaf_page->KeyIndex(key, comparator_);
+  if (index == -1) {
+    index = leaf_page->GetSize();
+  }
+  bool on_key = index < leaf_page->GetSize() && comparator_(leaf_page->KeyAt(index), key) == 0;
+  if (reverse && !(on_key && inclusive)) {
+    --index;
+  } else if (!reverse && on_key && !inclusive) {
+    ++index;
+  }
+  return index;
+}
+
 /*****************************************************************************
  * UTILITIES AND DEBUG
  *****************************************************************************/
 /*
  * Find leaf page containing particular key, if leftMost flag == true, find
- * the left most leaf page
+ * the left most leaf page, if rightMost flag == true, find the right most one
  */
 INDEX_TEMPLATE_ARGUMENTS
-Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
+Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost, bool rightMost) {
   Page *page;
   root_page_mutex_.lock();
-  if (leftMost) {
-    assert(GetLeafPageOfKey(key, &page, true, OperationType::SearchKey, nullptr));
-  } else {
-    assert(GetLeafPageOfKey(key, &page, false, OperationType::SearchKey, nullptr));
-  }
+  // the key itself does not have to be in the leaf page, e.g. for the start of a range
+  GetLeafPageOfKey(key, &page, leftMost, OperationType::SearchKey, nullptr, rightMost);
   auto b_plus_tree_page = reinterpret_cast<BPlusTreePage*>(page->GetData());
   if (b_plus_tree_page->IsRootPage()) {
     // root page has a mutex
@@ -848,8 +1680,9 @@ Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
 }
 
 /*
- * Update/Insert root page id in header page(where page_id = 0, header_page is
- * defined under include/page/header_page.h)
+ * Update/Insert root page id in header page(header_page_id_, page 0 unless the
+ * tree was given another one, header_page is defined under
+ * include/page/header_page.h)
  * Call this method everytime root page id is changed.
  * @parameter: insert_record      defualt value is false. When set to true,
  * insert a record <index_name, root_page_id> into header page instead of
@@ -857,15 +1690,21 @@ Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
-  HeaderPage *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
+  HeaderPage *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(header_page_id_));
   if (insert_record != 0) {
     // create a new record<index_name + root_page_id> in header_page
-    header_page->InsertRecord(index_name_, root_page_id_);
+    if (!header_page->InsertRecord(index_name_, root_page_id_)) {
+      // the index has a record already, e.g. the root split again
+      header_page->UpdateRecord(index_name_, root_page_id_);
+    }
   } else {
     // update root_page_id in header_page
-    header_page->UpdateRecord(index_name_, root_page_id_);
+    if (!header_page->UpdateRecord(index_name_, root_page_id_) && root_page_id_ != INVALID_PAGE_ID) {
+      // the index has no record yet, e.g. its first root
+      header_page->InsertRecord(index_name_, root_page_id_);
+    }
   }
-  assert(buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true));
+  assert(buffer_pool_manager_->UnpinPage(header_page_id_, true));
 }
 
 /*
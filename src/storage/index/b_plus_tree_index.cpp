@@ -14,12 +14,17 @@
 namespace bustub {
 /*
  * Constructor
+ * Index keys are always built from tuples of the key schema, so the tree can
+ * leave the unused tail of each key out of its pages. Many tuples may share a
+ * key, so the tree keeps all their RIDs.
  */
 INDEX_TEMPLATE_ARGUMENTS
-BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager)
+BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager,
+                                     page_id_t header_page_id)
     : Index(std::move(metadata)),
       comparator_(GetMetadata()->GetKeySchema()),
-      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_) {}
+      container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_, LEAF_PAGE_SIZE, INTERNAL_PAGE_SIZE, true,
+                 false, header_page_id) {}
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
@@ -36,7 +41,7 @@ void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *t
   KeyType index_key;
   index_key.SetFromKey(key);
 
-  container_.Remove(index_key, transaction);
+  container_.Remove(index_key, rid, transaction);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -48,6 +53,23 @@ void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, T
   container_.GetValue(index_key, result, transaction);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::BulkLoad(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) {
+  // construct bulk load index keys
+  std::vector<std::pair<KeyType, ValueType>> items(entries.size());
+  for (size_t i = 0; i < entries.size(); ++i) {
+    items[i].first.SetFromKey(entries[i].first);
+    items[i].second = entries[i].second;
+  }
+
+  if (!container_.BulkLoad(items.begin(), items.end())) {
+    // the tree already has keys, so it can't be built bottom-up
+    for (const auto &[index_key, rid] : items) {
+      container_.Insert(index_key, rid, transaction);
+    }
+  }
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator() { return container_.Begin(); }
 
@@ -57,6 +79,18 @@ INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key) {
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetEndIterator() { return container_.End(); }
 
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetReverseBeginIterator() { return container_.RBegin(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetReverseBeginIterator(const KeyType &key) { return container_.RBegin(key); }
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetRangeIterator(const KeyType &low_key, const KeyType &high_key,
+                                                          bool low_inclusive, bool high_inclusive, bool reverse) {
+  return container_.Range(low_key, high_key, low_inclusive, high_inclusive, reverse);
+}
+
 template class BPlusTreeIndex<GenericKey<4>, RID, GenericComparator<4>>;
 template class BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
@@ -42,6 +42,23 @@ void HASH_TABLE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result,
   container_.GetValue(transaction, index_key, result);
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_INDEX_TYPE::BulkLoad(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) {
+  // construct bulk load index keys
+  std::vector<std::pair<KeyType, ValueType>> items(entries.size());
+  for (size_t i = 0; i < entries.size(); ++i) {
+    items[i].first.SetFromKey(entries[i].first);
+    items[i].second = entries[i].second;
+  }
+
+  if (!container_.BulkLoad(items.begin(), items.end())) {
+    // the table already has keys, so it can't be built by hash prefix
+    for (const auto &[index_key, rid] : items) {
+      container_.Insert(transaction, index_key, rid);
+    }
+  }
+}
+
 // The followings are explicit instantiation(in order not to generate repeated same template instance)
 template class ExtendibleHashTableIndex<GenericKey<4>, RID, GenericComparator<4>>;
 template class ExtendibleHashTableIndex<GenericKey<8>, RID, GenericComparator<8>>;
@@ -5,31 +5,190 @@
 
 #include "common/config.h"
 #include "storage/index/index_iterator.h"
+#include "storage/page/b_plus_tree_internal_page.h"
 #include "storage/page/b_plus_tree_page.h"
 
 namespace bustub {
 
+/*
+ * Helper for read-ahead: the leaves next to the given leaf in scan order,
+ * taken from the siblings of the leaf in its parent. When the leaf is the
+ * last child in that direction, only its next_page_id_ (prev_page_id_ when
+ * scanning in reverse) is known and the next call continues in the next parent.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+static size_t GetNeighbourLeafPages(BufferPoolManager *buffer_pool_manager, page_id_t page_id, page_id_t *page_ids,
+                                    size_t max_pages, bool reverse) {
+  Page *page = buffer_pool_manager->FetchPage(page_id);
+  if (page == nullptr) {
+    return 0;
+  }
+  page->RLatch();
+  auto leaf_page = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page->GetData());
+  page_id_t parent_page_id = leaf_page->GetParentPageId();
+  page_id_t neighbour_page_id = reverse ? leaf_page->GetPrevPageId() : leaf_page->GetNextPageId();
+  page->RUnlatch();
+  buffer_pool_manager->UnpinPage(page_id, false);
+
+  size_t num_pages = 0;
+  Page *parent = parent_page_id == INVALID_PAGE_ID ? nullptr : buffer_pool_manager->FetchPage(parent_page_id);
+  if (parent != nullptr) {
+    parent->RLatch();
+    auto parent_page = reinterpret_cast<BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *>(parent->GetData());
+    // The parent may have changed since the leaf was read, in which case the leaf is not found here.
+    int index = parent_page->ValueIndex(page_id);
+    int step = reverse ? -1 : 1;
+    for (int i = index + step; index != -1 && i >= 0 && i < parent_page->GetSize() && num_pages < max_pages;
+         i += step) {
+      page_ids[num_pages++] = parent_page->ValueAt(i);
+    }
+    parent->RUnlatch();
+    buffer_pool_manager->UnpinPage(parent_page_id, false);
+  }
+  if (num_pages == 0 && neighbour_page_id != INVALID_PAGE_ID) {
+    page_ids[num_pages++] = neighbour_page_id;
+  }
+  return num_pages;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+static size_t GetFollowingLeafPages(BufferPoolManager *buffer_pool_manager, page_id_t page_id, page_id_t *page_ids,
+                                    size_t max_pages) {
+  return GetNeighbourLeafPages<KeyType, ValueType, KeyComparator>(buffer_pool_manager, page_id, page_ids, max_pages,
+                                                                  false);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+static size_t GetPrecedingLeafPages(BufferPoolManager *buffer_pool_manager, page_id_t page_id, page_id_t *page_ids,
+                                    size_t max_pages) {
+  return GetNeighbourLeafPages<KeyType, ValueType, KeyComparator>(buffer_pool_manager, page_id, page_ids, max_pages,
+                                                                  true);
+}
+
 /*
  * NOTE: you can change the destructor/constructor method here
  * set your own input parameters
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::IndexIterator(): leaf_page_(nullptr), index_(-1), buffer_pool_manager_(nullptr) {}
+INDEXITERATOR_TYPE::IndexIterator()
+  : leaf_page_(nullptr),
+    index_(-1),
+    unique_keys_(true),
+    buffer_pool_manager_(nullptr),
+    read_ahead_(nullptr, GetFollowingLeafPages<KeyType, ValueType, KeyComparator>, 0) {}
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *buffer_pool_manager, 
-  B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_page, int index)
+  B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_page, int index, bool unique_keys, bool reverse)
+  : IndexIterator(buffer_pool_manager, leaf_page, index, unique_keys, reverse, nullptr, KeyType(), true,
+                  INVALID_PAGE_ID) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *buffer_pool_manager, B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_page,
+  int index, bool unique_keys, bool reverse, const KeyComparator *comparator, const KeyType &stop_key,
+  bool stop_inclusive, page_id_t stop_page_id)
   : leaf_page_(leaf_page), 
     index_(index), 
-    buffer_pool_manager_(buffer_pool_manager) {}
+    unique_keys_(unique_keys),
+    reverse_(reverse),
+    comparator_(comparator),
+    stop_key_(stop_key),
+    stop_inclusive_(stop_inclusive),
+    buffer_pool_manager_(buffer_pool_manager),
+    read_ahead_(buffer_pool_manager, reverse ? GetPrecedingLeafPages<KeyType, ValueType, KeyComparator>
+                                             : GetFollowingLeafPages<KeyType, ValueType, KeyComparator>) {
+  read_ahead_.SetLastPage(stop_page_id);
+  if (leaf_page_ != nullptr) {
+    read_ahead_.OnPage(leaf_page_->GetPageId());
+    Settle();
+  }
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::~IndexIterator() {
+  if (posting_page_ != nullptr) {
+    buffer_pool_manager_->UnpinPage(posting_page_id_, false);
+  }
   if (leaf_page_ != nullptr) {
     buffer_pool_manager_->UnpinPage(leaf_page_->GetPageId(), false);
   }
 }
 
+/*
+ * Make index_ point at an entry: while it is off either end of the leaf page,
+ * move to the next leaf page in scan order (which may be empty too). Then
+ * stop at a key beyond the stop key, or load the entry.
+ * A leaf whose last key in scan order has reached the stop key is never
+ * followed, as every key after it is out of range.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Settle() {
+  while (index_ < 0 || index_ >= leaf_page_->GetSize()) {
+    int size = leaf_page_->GetSize();
+    page_id_t page_id = reverse_ ? leaf_page_->GetPrevPageId() : leaf_page_->GetNextPageId();
+    if (page_id == INVALID_PAGE_ID ||
+        (comparator_ != nullptr && size > 0 && CompareToStopKey(leaf_page_->KeyAt(reverse_ ? 0 : size - 1)) >= 0)) {
+      Finish();
+      return;
+    }
+    buffer_pool_manager_->UnpinPage(leaf_page_->GetPageId(), false);
+    leaf_page_ = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+    index_ = reverse_ ? leaf_page_->GetSize() - 1 : 0;
+    read_ahead_.OnPage(page_id);
+  }
+  if (comparator_ != nullptr) {
+    int cmp = CompareToStopKey(leaf_page_->KeyAt(index_));
+    if (cmp > 0 || (cmp == 0 && !stop_inclusive_)) {
+      Finish();
+      return;
+    }
+  }
+  LoadItem();
+}
+
+/*
+ * Release the leaf page and become the end iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Finish() {
+  buffer_pool_manager_->UnpinPage(leaf_page_->GetPageId(), false);
+  leaf_page_ = nullptr;
+  index_ = -1;
+}
+
+/*
+ * Compare key with the stop key in scan order: > 0 if key comes after it
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int INDEXITERATOR_TYPE::CompareToStopKey(const KeyType &key) const {
+  int cmp = (*comparator_)(key, stop_key_);
+  return reverse_ ? -cmp : cmp;
+}
+
+/*
+ * Copy the entry at index_ of the leaf page into item_. A key with a posting
+ * list comes up once per value, starting with the first value of its first
+ * posting page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::LoadItem() {
+  item_ = leaf_page_->GetItem(index_);
+  if (!unique_keys_ && BPlusTreePostingPage::IsPostingList(item_.second)) {
+    LoadPostingPage(item_.second.GetPageId());
+  }
+}
+
+/*
+ * Pin the posting page and move to its first value
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::LoadPostingPage(page_id_t page_id) {
+  posting_page_ = reinterpret_cast<BPlusTreePostingPage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+  posting_page_id_ = page_id;
+  posting_index_ = 0;
+  item_.second = posting_page_->RidAt(0);
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 bool INDEXITERATOR_TYPE::IsEnd() {
   return leaf_page_ == nullptr;
@@ -38,7 +197,7 @@ bool INDEXITERATOR_TYPE::IsEnd() {
 INDEX_TEMPLATE_ARGUMENTS
 const MappingType &INDEXITERATOR_TYPE::operator*() {
   assert(!IsEnd());
-  return leaf_page_->GetItem(index_);
+  return item_;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -46,23 +205,23 @@ INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
   if (IsEnd()) {
     return *this;
   }
-  if (index_ == leaf_page_->GetSize() - 1) {
-    // we have finished traversing this leaf page, switching to next one
-    index_ = 0;
-    page_id_t next_page_id = leaf_page_->GetNextPageId();
-    buffer_pool_manager_->UnpinPage(leaf_page_->GetPageId(), false);
-
-    if (next_page_id == INVALID_PAGE_ID) {
-      leaf_page_ = nullptr;
-      index_ = -1;
-    } else {
-      leaf_page_ = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE*>(
-        buffer_pool_manager_->FetchPage(next_page_id)->GetData());
+  if (posting_page_ != nullptr) {
+    // the next value of the same key, if any
+    if (++posting_index_ < posting_page_->GetSize()) {
+      item_.second = posting_page_->RidAt(posting_index_);
+      return *this;
+    }
+    page_id_t next_page_id = posting_page_->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(posting_page_id_, false);
+    posting_page_ = nullptr;
+    posting_index_ = 0;
+    if (next_page_id != INVALID_PAGE_ID) {
+      LoadPostingPage(next_page_id);
+      return *this;
     }
-
-  } else {
-    ++index_;
   }
+  index_ += reverse_ ? -1 : 1;
+  Settle();
   return *this;
 }
 
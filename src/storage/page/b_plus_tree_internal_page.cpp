@@ -9,6 +9,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cassert>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 
@@ -25,10 +28,12 @@ namespace bustub {
  * max page size
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size, int key_size) {
   SetPageId(page_id);
   SetParentPageId(parent_id);
   SetMaxSize(max_size);
+  assert(key_size >= 1 && key_size <= static_cast<int>(sizeof(KeyType)));
+  SetKeySize(key_size);
   SetPageType(IndexPageType::INTERNAL_PAGE);
 }
 /*
@@ -41,7 +46,7 @@ KeyType B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const {
   if (index <0 || index >= GetSize()) {
     return KeyType{};
   }
-  return array_[index].first;
+  return SlotKey(index);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -49,7 +54,7 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
   if (index <0 || index >= GetSize()) {
     return;
   }
-  array_[index].first = key;
+  SetSlotKey(index, key);
 }
 
 /*
@@ -59,7 +64,7 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const {
   for (int i = 0; i < GetSize(); ++i) {
-    if (array_[i].second == value) {
+    if (SlotValue(i) == value) {
       return i;
     }
   }
@@ -75,7 +80,65 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const {
   if (index <0 || index >= GetSize()) {
     return ValueType{};
   }
-  return array_[index].second;
+  return SlotValue(index);
+}
+
+/*
+ * Entries are packed as GetKeySize() key bytes followed by the child page id.
+ * Keys are written truncated to GetKeySize() bytes and read back zero padded.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+const char *B_PLUS_TREE_INTERNAL_PAGE_TYPE::SlotAt(int index) const {
+  return array_ + index * (GetKeySize() + sizeof(ValueType));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+char *B_PLUS_TREE_INTERNAL_PAGE_TYPE::SlotAt(int index) {
+  return array_ + index * (GetKeySize() + sizeof(ValueType));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+KeyType B_PLUS_TREE_INTERNAL_PAGE_TYPE::SlotKey(int index) const {
+  // optimistic readers read the page unlatched, so a torn key size must not overflow the key
+  int key_size = std::clamp<int>(GetKeySize(), 0, sizeof(KeyType));
+  KeyType key;
+  memcpy(&key, SlotAt(index), key_size);
+  if (key_size < static_cast<int>(sizeof(KeyType))) {
+    memset(reinterpret_cast<char *>(&key) + key_size, 0, sizeof(KeyType) - key_size);
+  }
+  return key;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::SlotValue(int index) const {
+  ValueType value;
+  memcpy(&value, SlotAt(index) + GetKeySize(), sizeof(ValueType));
+  return value;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+MappingType B_PLUS_TREE_INTERNAL_PAGE_TYPE::SlotItem(int index) const {
+  return {SlotKey(index), SlotValue(index)};
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetSlotKey(int index, const KeyType &key) {
+  memcpy(SlotAt(index), &key, GetKeySize());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetSlotValue(int index, const ValueType &value) {
+  memcpy(SlotAt(index) + GetKeySize(), &value, sizeof(ValueType));
+}
+
+/*
+ * Move {count} entries starting at index {from} so they start at index {to}
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveSlots(int to, int from, int count) {
+  if (count > 0) {
+    memmove(SlotAt(to), SlotAt(from), count * (GetKeySize() + sizeof(ValueType)));
+  }
 }
 
 /*****************************************************************************
@@ -85,24 +148,22 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const {
  * Find and return the child pointer(page_id) which points to the child page
  * that contains input "key"
  * Start the search from the second key(the first key should always be invalid)
+ * Binary search for the first key that is bigger than input "key"; the child
+ * right before it covers the key.
  */
 INDEX_TEMPLATE_ARGUMENTS
 ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const {
-
-  if (comparator(array_[1].first, key) > 0) {
-    // the key is smaller than the first bound key
-    return array_[0].second;
-  }
-  for (int i = 1; i < GetSize()-1; ++i) {
-    if (comparator(array_[i].first, key) <= 0 && comparator(array_[i+1].first, key) > 0) {
-      return array_[i].second;
+  int left = 1;
+  int right = GetSize();
+  while (left < right) {
+    int mid = left + (right - left) / 2;
+    if (comparator(SlotKey(mid), key) <= 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
     }
   }
-  if (comparator(array_[GetSize()-1].first, key) <= 0) {
-    // the key is bigger than the last bound key
-    return array_[GetSize()-1].second;
-  }
-  return INVALID_PAGE_ID;
+  return SlotValue(left - 1);
 }
 
 /*****************************************************************************
@@ -119,8 +180,9 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value,
                                                      const ValueType &new_value) 
 {
   SetSize(2);
-  array_[0].second = old_value;
-  array_[1] = {new_key, new_value};
+  SetSlotValue(0, old_value);
+  SetSlotKey(1, new_key);
+  SetSlotValue(1, new_value);
   // std::cout << "[DEBUG] populate a new root(page id " << GetPageId() << ") "<< "v0 " << old_value << " k1 " << new_key 
   //   << " v1 " << new_value << std::endl;
 }
@@ -139,10 +201,9 @@ int B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAfter(const ValueType &old_value,
   }                                                      
 
   int index = ValueIndex(old_value);
-  for (int i = old_size; i > index + 1; --i) {
-    array_[i] = array_[i-1];
-  }
-  array_[index+1] = {new_key, new_value};
+  MoveSlots(index + 2, index + 1, old_size - index - 1);
+  SetSlotKey(index + 1, new_key);
+  SetSlotValue(index + 1, new_value);
 
   SetSize(old_size + 1);
   return GetSize();
@@ -162,7 +223,7 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *recipient
 
   MappingType *items = new MappingType[old_size - old_size/2];
   for (int i = old_size/2; i < old_size; ++i) {
-    items[i-old_size/2] = array_[i];
+    items[i-old_size/2] = SlotItem(i);
   }
   recipient->CopyNFrom(items, old_size-old_size/2, buffer_pool_manager);
   delete [] items;
@@ -176,8 +237,9 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *recipient
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(MappingType *items, int size, BufferPoolManager *buffer_pool_manager) {
   for (int i = 0; i < size; ++i) {
-    // note that array_[0].first should be regarded as invalid key(although it isn't)
-    array_[i] = items[i];
+    // note that the first key should be regarded as invalid key(although it isn't)
+    SetSlotKey(i, items[i].first);
+    SetSlotValue(i, items[i].second);
     auto child_page = reinterpret_cast<BPlusTreePage*>(
       buffer_pool_manager->FetchPage(items[i].second)->GetData());
     // change the child page's parent page id
@@ -197,9 +259,7 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(MappingType *items, int size, Buf
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(int index) {
-  for (int i = index; i < GetSize() - 1; ++i) {
-    array_[i] = array_[i+1];
-  }
+  MoveSlots(index, index + 1, GetSize() - index - 1);
   SetSize(GetSize() - 1);
 }
 
@@ -225,9 +285,9 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient,
 {
   for (int i = 0; i < GetSize(); ++i) {
     if (i == 0) {
-      array_[0].first = middle_key;
+      SetSlotKey(0, middle_key);
     }
-    recipient->CopyLastFrom(array_[i], buffer_pool_manager);
+    recipient->CopyLastFrom(SlotItem(i), buffer_pool_manager);
   }
 }
 
@@ -246,10 +306,8 @@ INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
                                                       BufferPoolManager *buffer_pool_manager) 
 {
-  recipient->CopyLastFrom(array_[0], buffer_pool_manager);
-  for (int i = 0; i < GetSize() - 1; ++i) {
-    array_[i] = array_[i+1];
-  }
+  recipient->CopyLastFrom(SlotItem(0), buffer_pool_manager);
+  MoveSlots(0, 1, GetSize() - 1);
   SetSize(GetSize() - 1);
 }
 
@@ -263,7 +321,8 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyLastFrom(const MappingType &pair, Buffe
   auto child_page = reinterpret_cast<BPlusTreePage*>(buffer_pool_manager->FetchPage(pair.second)->GetData());
   child_page->SetParentPageId(GetPageId());
   buffer_pool_manager->UnpinPage(pair.second, true);
-  array_[GetSize()] = pair;
+  SetSlotKey(GetSize(), pair.first);
+  SetSlotValue(GetSize(), pair.second);
   SetSize(GetSize() + 1);
 }
 
@@ -278,7 +337,7 @@ INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
                                                        BufferPoolManager *buffer_pool_manager) 
 {
-  recipient->CopyFirstFrom(array_[GetSize()-1], buffer_pool_manager);
+  recipient->CopyFirstFrom(SlotItem(GetSize()-1), buffer_pool_manager);
   SetSize(GetSize() - 1);
 }
 
@@ -292,10 +351,9 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyFirstFrom(const MappingType &pair, Buff
   auto child_page = reinterpret_cast<BPlusTreePage*>(buffer_pool_manager->FetchPage(pair.second)->GetData());
   child_page->SetParentPageId(GetPageId());
   buffer_pool_manager->UnpinPage(pair.second, true);
-  for (int i = GetSize(); i > 0; --i) {
-    array_[i] = array_[i-1];
-  }
-  array_[0] = pair;
+  MoveSlots(1, 0, GetSize());
+  SetSlotKey(0, pair.first);
+  SetSlotValue(0, pair.second);
   SetSize(GetSize() + 1);
 }
 
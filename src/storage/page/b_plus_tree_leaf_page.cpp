@@ -9,6 +9,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cassert>
+#include <cstring>
 #include <sstream>
 
 #include "common/exception.h"
@@ -25,15 +28,18 @@ namespace bustub {
 /**
  * Init method after creating a new leaf page
  * Including set page type, set current size to zero, set page id/parent id, set
- * next page id and set max size
+ * next/prev page id and set max size
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size, int key_size) {
   SetPageId(page_id);
   SetParentPageId(parent_id);
   SetMaxSize(max_size);
+  assert(key_size >= 1 && key_size <= static_cast<int>(sizeof(KeyType)));
+  SetKeySize(key_size);
   SetPageType(IndexPageType::LEAF_PAGE);
   SetNextPageId(INVALID_PAGE_ID);
+  SetPrevPageId(INVALID_PAGE_ID);
 }
 
 /**
@@ -49,18 +55,47 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
   next_page_id_ = next_page_id;
 }
 
+/**
+ * Helper methods to set/get prev page id
+ */
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t B_PLUS_TREE_LEAF_PAGE_TYPE::GetPrevPageId() const {
+  return prev_page_id_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetPrevPageId(page_id_t prev_page_id) {
+  prev_page_id_ = prev_page_id;
+}
+
 /**
  * Helper method to find the first index i so that array[i].first >= key
  * NOTE: This method is only used when generating index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
-  for (int i = 0; i < GetSize(); ++i) {
-    if (comparator(array_[i].first, key) >= 0) {
-      return i;
+  int index = LowerBound(key, comparator);
+  return index < GetSize() ? index : -1;
+}
+
+/*
+ * Binary search for the first index i so that array[i].first >= key, or
+ * GetSize() if every key is smaller. Keys are sorted, so this needs log(n)
+ * comparisons instead of one per item.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_LEAF_PAGE_TYPE::LowerBound(const KeyType &key, const KeyComparator &comparator) const {
+  int left = 0;
+  int right = GetSize();
+  while (left < right) {
+    int mid = left + (right - left) / 2;
+    if (comparator(SlotKey(mid), key) < 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
     }
   }
-  return -1;
+  return left;
 }
 
 /*
@@ -74,8 +109,7 @@ KeyType B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const {
     std::cout << "[ERROR] index " << index << " out of range, size " << GetSize() << "\n";
     return KeyType{};
   }
-  // std::cout << "[DEBUG] key " << array_[index].first << " at index " << index << std::endl;
-  return array_[index].first;
+  return SlotKey(index);
 }
 
 /*
@@ -83,13 +117,63 @@ KeyType B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const {
  * "index"(a.k.a array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-const MappingType &B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) {
+MappingType B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) const {
   // replace with your own code
   if (index <0 || index >= GetSize()) {
     // TODO(greenhandzpx) not sure if the index is out of range
-    return array_[0];
+    index = 0;
+  }
+  return {SlotKey(index), SlotValue(index)};
+}
+
+/*
+ * Entries are packed as GetKeySize() key bytes followed by the value. Keys
+ * are written truncated to GetKeySize() bytes and read back zero padded.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+const char *B_PLUS_TREE_LEAF_PAGE_TYPE::SlotAt(int index) const {
+  return array_ + index * (GetKeySize() + sizeof(ValueType));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+char *B_PLUS_TREE_LEAF_PAGE_TYPE::SlotAt(int index) {
+  return array_ + index * (GetKeySize() + sizeof(ValueType));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+KeyType B_PLUS_TREE_LEAF_PAGE_TYPE::SlotKey(int index) const {
+  // optimistic readers read the page unlatched, so a torn key size must not overflow the key
+  int key_size = std::clamp<int>(GetKeySize(), 0, sizeof(KeyType));
+  KeyType key;
+  memcpy(&key, SlotAt(index), key_size);
+  if (key_size < static_cast<int>(sizeof(KeyType))) {
+    memset(reinterpret_cast<char *>(&key) + key_size, 0, sizeof(KeyType) - key_size);
+  }
+  return key;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+ValueType B_PLUS_TREE_LEAF_PAGE_TYPE::SlotValue(int index) const {
+  ValueType value;
+  memcpy(&value, SlotAt(index) + GetKeySize(), sizeof(ValueType));
+  return value;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetSlot(int index, const KeyType &key, const ValueType &value) {
+  char *slot = SlotAt(index);
+  memcpy(slot, &key, GetKeySize());
+  memcpy(slot + GetKeySize(), &value, sizeof(ValueType));
+}
+
+/*
+ * Move {count} entries starting at index {from} so they start at index {to}
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveSlots(int to, int from, int count) {
+  if (count > 0) {
+    memmove(SlotAt(to), SlotAt(from), count * (GetKeySize() + sizeof(ValueType)));
   }
-  return array_[index];
 }
 
 /*****************************************************************************
@@ -106,28 +190,13 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &valu
     // the leaf page is already full, should not insert anymore
     return -1;
   }
-  for (int i = 0; i < old_size; ++i) {
-    if (comparator(key, array_[i].first) == 0) {
-      // the key already exists
-      return -1;
-    }
-  }
-  if (comparator(key, array_[old_size-1].first) > 0) {
-    array_[old_size].first = key;
-    array_[old_size].second = value;
-
-  } else {
-    for (int i = 0; i < old_size; ++i) {
-      if (comparator(key, array_[i].first) < 0) {
-        for (int k = old_size; k > i; --k) {
-          array_[k] = array_[k-1];
-        }
-        array_[i].first = key;
-        array_[i].second = value;
-        break;
-      }
-    }
+  int index = LowerBound(key, comparator);
+  if (index < old_size && comparator(SlotKey(index), key) == 0) {
+    // the key already exists
+    return -1;
   }
+  MoveSlots(index + 1, index, old_size - index);
+  SetSlot(index, key, value);
   // std::cout << "[DEBUG] insert a key " << key << " value " << value
   //   << " leaf page id " << GetPageId() << std::endl;
   SetSize(old_size + 1);
@@ -146,7 +215,7 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient) {
 
   MappingType *items = new MappingType[old_size - old_size/2];
   for (int i = old_size/2; i < old_size; ++i) {
-    items[i-old_size/2] = array_[i];
+    items[i-old_size/2] = GetItem(i);
   }
   recipient->CopyNFrom(items, old_size-old_size/2);
   delete [] items;
@@ -159,7 +228,7 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient) {
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(MappingType *items, int size) {
   for (int i = 0; i < size; ++i) {
-    array_[i] = items[i];
+    SetSlot(i, items[i].first, items[i].second);
   }
   SetSize(size);
 }
@@ -174,11 +243,24 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(MappingType *items, int size) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const {
-  for (int i = 0; i < GetSize(); ++i) {
-    if (comparator(array_[i].first, key) == 0) {
-      *value = array_[i].second;
-      return true;
-    }
+  int index = LowerBound(key, comparator);
+  if (index < GetSize() && comparator(SlotKey(index), key) == 0) {
+    *value = SlotValue(index);
+    return true;
+  }
+  return false;
+}
+
+/*
+ * Replace the value stored with the given key
+ * @return: false if the key does not exist
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::SetValue(const KeyType &key, const ValueType &value, const KeyComparator &comparator) {
+  int index = LowerBound(key, comparator);
+  if (index < GetSize() && comparator(SlotKey(index), key) == 0) {
+    SetSlot(index, key, value);
+    return true;
   }
   return false;
 }
@@ -194,15 +276,10 @@ bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *value, co
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) {
-
-  for (int i = 0; i < GetSize(); ++i) {
-    if (comparator(array_[i].first, key) == 0) {
-      for (int k = i; k < GetSize()-1; ++k) {
-        array_[k] = array_[k+1];
-      }
-      SetSize(GetSize() - 1);
-      break;
-    }
+  int index = LowerBound(key, comparator);
+  if (index < GetSize() && comparator(SlotKey(index), key) == 0) {
+    MoveSlots(index, index + 1, GetSize() - index - 1);
+    SetSize(GetSize() - 1);
   }
   return GetSize();
 }
@@ -212,7 +289,8 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const
  *****************************************************************************/
 /*
  * Remove all of key & value pairs from this page to "recipient" page. Don't forget
- * to update the next_page id in the sibling page
+ * to update the next_page id in the sibling page. The page after this one still
+ * points back here; the caller must link it to "recipient".
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
@@ -234,7 +312,7 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
   //   recipient->SetNextPageId(GetNextPageId());
   // }
   for (int i = 0; i < GetSize(); ++i) {
-    recipient->CopyLastFrom(array_[i]);
+    recipient->CopyLastFrom(GetItem(i));
   }
   // modify the sibling pointer
   recipient->SetNextPageId(GetNextPageId());
@@ -248,10 +326,8 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient) {
-  recipient->CopyLastFrom(array_[0]);
-  for (int i = 0; i < GetSize() - 1; ++i) {
-    array_[i] = array_[i+1];
-  }
+  recipient->CopyLastFrom(GetItem(0));
+  MoveSlots(0, 1, GetSize() - 1);
   SetSize(GetSize() - 1);
 }
 
@@ -261,7 +337,7 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient)
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyLastFrom(const MappingType &item) {
   // std::cout << "[DEBUG] copy last from key " << item.first << std::endl;
-  array_[GetSize()] = item;
+  SetSlot(GetSize(), item.first, item.second);
   SetSize(GetSize() + 1);
 }
 
@@ -270,7 +346,7 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyLastFrom(const MappingType &item) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient) {
-  recipient->CopyFirstFrom(array_[GetSize() - 1]);
+  recipient->CopyFirstFrom(GetItem(GetSize() - 1));
   SetSize(GetSize() - 1);
 }
 
@@ -279,10 +355,8 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient)
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyFirstFrom(const MappingType &item) {
-  for (int i = GetSize(); i > 0; --i) {
-    array_[i] = array_[i-1];
-  } 
-  array_[0] = item;
+  MoveSlots(1, 0, GetSize());
+  SetSlot(0, item.first, item.second);
   SetSize(GetSize() + 1);
 }
 
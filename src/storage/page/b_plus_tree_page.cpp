@@ -74,6 +74,12 @@ void BPlusTreePage::SetPageId(page_id_t page_id) {
   page_id_ = page_id;
 }
 
+/*
+ * Helper methods to get/set the number of key bytes stored per entry
+ */
+int BPlusTreePage::GetKeySize() const { return key_size_; }
+void BPlusTreePage::SetKeySize(int key_size) { key_size_ = key_size; }
+
 /*
  * Helper methods to set lsn
  */
@@ -0,0 +1,45 @@
+//===----------------------------------------------------------------------===//
+//
+//                         CMU-DB Project (15-445/645)
+//                         ***DO NO SHARE PUBLICLY***
+//
+// Identification: src/page/b_plus_tree_posting_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/b_plus_tree_posting_page.h"
+
+namespace bustub {
+
+/*
+ * Init method after creating a new posting page
+ * Set the next page id and set current size to zero
+ */
+void BPlusTreePostingPage::Init(page_id_t next_page_id) {
+  next_page_id_ = next_page_id;
+  size_ = 0;
+}
+
+/*
+ * Helper methods to get/set next page id
+ */
+page_id_t BPlusTreePostingPage::GetNextPageId() const { return next_page_id_; }
+void BPlusTreePostingPage::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+int BPlusTreePostingPage::GetSize() const { return size_; }
+bool BPlusTreePostingPage::IsFull() const { return size_ == static_cast<int>(POSTING_PAGE_SIZE); }
+RID BPlusTreePostingPage::RidAt(int index) const { return array_[index]; }
+
+void BPlusTreePostingPage::Append(const RID &rid) { array_[size_++] = rid; }
+
+bool BPlusTreePostingPage::Remove(const RID &rid) {
+  for (int i = 0; i < size_; ++i) {
+    if (array_[i] == rid) {
+      array_[i] = array_[--size_];
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace bustub
@@ -0,0 +1,36 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_list_page.cpp
+//
+// Identification: src/storage/page/free_list_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/free_list_page.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void FreeListPage::Init(page_id_t page_id, page_id_t next_page_id) {
+  page_id_ = page_id;
+  lsn_ = INVALID_LSN;
+  next_page_id_ = next_page_id;
+  count_ = 0;
+}
+
+void FreeListPage::Push(page_id_t page_id) {
+  BUSTUB_ASSERT(!IsFull(), "free list page is full");
+  free_page_ids_[count_++] = page_id;
+}
+
+page_id_t FreeListPage::Pop() {
+  BUSTUB_ASSERT(!IsEmpty(), "free list page is empty");
+  return free_page_ids_[--count_];
+}
+
+}  // namespace bustub
@@ -11,7 +11,12 @@
 //===----------------------------------------------------------------------===//
 
 #include "storage/page/hash_table_bucket_page.h"
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "common/config.h"
 #include "common/logger.h"
 #include "common/util/hash_util.h"
@@ -25,16 +30,19 @@ namespace bustub {
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) {
   bool flag = false;
-  for (size_t i = 0; i < BUCKET_ARRAY_SIZE; ++i) {
-    if (!IsOccupied(i)) {
-      break;
-    }
-    if (!IsReadable(i)) {
-      continue;
+  uint8_t fingerprint = Fingerprint(key, cmp);
+  for (size_t base = 0; base < BUCKET_ARRAY_SIZE; base += BUCKET_PROBE_WIDTH) {
+    uint32_t candidates = MatchFingerprints(base, fingerprint) & BitmapGroup(readable_, base);
+    for (; candidates != 0; candidates &= candidates - 1) {
+      size_t i = base + __builtin_ctz(candidates);
+      if (cmp(key, array_[i].first) == 0) {
+        result->push_back(array_[i].second);
+        flag = true;
+      }
     }
-    if (cmp(key, KeyAt(i)) == 0) {
-      result->push_back(ValueAt(i));
-      flag = true;
+    if (BitmapGroup(occupied_, base) != (1U << BUCKET_PROBE_WIDTH) - 1) {
+      // occupied slots are a prefix of the bucket
+      break;
     }
   }
   return flag;
@@ -44,59 +52,60 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BUCKET_TYPE::Insert(KeyType key, ValueType value, KeyComparator cmp) {
   size_t slot;
   bool has_slot = false;
-  size_t extend_slot;
-  bool has_extend_slot = false;
-  for (size_t i = 0; i < BUCKET_ARRAY_SIZE; ++i) {
-    if (!IsOccupied(i)) {
-      has_extend_slot = true;
-      extend_slot = i;
-      break;
+  uint8_t fingerprint = Fingerprint(key, cmp);
+  for (size_t base = 0; base < BUCKET_ARRAY_SIZE; base += BUCKET_PROBE_WIDTH) {
+    uint32_t occupied = BitmapGroup(occupied_, base);
+    uint32_t readable = BitmapGroup(readable_, base);
+    uint32_t candidates = MatchFingerprints(base, fingerprint) & readable;
+    for (; candidates != 0; candidates &= candidates - 1) {
+      size_t i = base + __builtin_ctz(candidates);
+      if (cmp(key, array_[i].first) == 0 && value == array_[i].second) {
+        // The key already exists.
+        return false;
+      }
     }
-    if (!IsReadable(i)) {
-      // tombstone or just nothing
-      if (!has_slot) {
-        slot = i;
+    if (!has_slot) {
+      uint32_t free = occupied & ~readable;
+      if (free == 0) {
+        // no tombstone, so take the first slot that was never used
+        free = ~occupied & ((1U << BUCKET_PROBE_WIDTH) - 1);
+      }
+      if (free != 0 && base + __builtin_ctz(free) < BUCKET_ARRAY_SIZE) {
+        slot = base + __builtin_ctz(free);
         has_slot = true;
       }
-      continue;
     }
-    if (cmp(key, KeyAt(i)) == 0 && value == ValueAt(i)) {
-      // The key already exists.
-      // LOG_DEBUG("kv has existed");
-      return false;
+    if (occupied != (1U << BUCKET_PROBE_WIDTH) - 1) {
+      break;
     }
   }
 
-  if (has_slot) {
-    // there is tombstone
-    array_[slot] = std::make_pair(key, value);
-    SetReadable(slot);
-    return true;
+  if (!has_slot) {
+    return false;
   }
-
-  if (has_extend_slot) {
-    array_[extend_slot] = std::make_pair(key, value);
-    SetOccupied(extend_slot);
-    SetReadable(extend_slot);
-    return true;
+  array_[slot] = std::make_pair(key, value);
+  if constexpr (BUCKET_FINGERPRINT_SIZE != 0) {
+    fingerprints_[slot] = fingerprint;
   }
-
-  return false;
+  SetOccupied(slot);
+  SetReadable(slot);
+  return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BUCKET_TYPE::Remove(KeyType key, ValueType value, KeyComparator cmp) {
-  for (size_t i = 0; i < BUCKET_ARRAY_SIZE; ++i) {
-    if (!IsOccupied(i)) {
-      break;
-    }
-    if (!IsReadable(i)) {
-      // tombstone or just nothing
-      continue;
+  uint8_t fingerprint = Fingerprint(key, cmp);
+  for (size_t base = 0; base < BUCKET_ARRAY_SIZE; base += BUCKET_PROBE_WIDTH) {
+    uint32_t candidates = MatchFingerprints(base, fingerprint) & BitmapGroup(readable_, base);
+    for (; candidates != 0; candidates &= candidates - 1) {
+      size_t i = base + __builtin_ctz(candidates);
+      if (cmp(key, array_[i].first) == 0 && value == array_[i].second) {
+        RemoveAt(i);
+        return true;
+      }
     }
-    if (cmp(key, KeyAt(i)) == 0 && value == ValueAt(i)) {
-      RemoveAt(i);
-      return true;
+    if (BitmapGroup(occupied_, base) != (1U << BUCKET_PROBE_WIDTH) - 1) {
+      break;
     }
   }
   return false;
@@ -157,22 +166,32 @@ bool HASH_TABLE_BUCKET_TYPE::IsFull() {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 uint32_t HASH_TABLE_BUCKET_TYPE::NumReadable() {
+  // bits past BUCKET_ARRAY_SIZE are never set, so whole words can be counted
   uint32_t cnt = 0;
-  for (size_t i = 0; i < BUCKET_ARRAY_SIZE; ++i) {
-    if (!IsOccupied(i)) {
-      break;
-    }
-    if (IsReadable(i)) {
-      ++cnt;
-    }
+  size_t offset = 0;
+  for (; offset + sizeof(uint64_t) <= sizeof(readable_); offset += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, readable_ + offset, sizeof(uint64_t));
+    cnt += __builtin_popcountll(word);
+  }
+  for (; offset < sizeof(readable_); ++offset) {
+    cnt += __builtin_popcount(static_cast<uint8_t>(readable_[offset]));
   }
   return cnt;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_BUCKET_TYPE::IsEmpty() {
-  for (size_t i = 0; i < BUCKET_ARRAY_SIZE; ++i) {
-    if (IsReadable(i)) {
+  size_t offset = 0;
+  for (; offset + sizeof(uint64_t) <= sizeof(readable_); offset += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, readable_ + offset, sizeof(uint64_t));
+    if (word != 0) {
+      return false;
+    }
+  }
+  for (; offset < sizeof(readable_); ++offset) {
+    if (readable_[offset] != 0) {
       return false;
     }
   }
@@ -201,6 +220,59 @@ void HASH_TABLE_BUCKET_TYPE::PrintBucket() {
   LOG_INFO("Bucket Capacity: %lu, Size: %u, Taken: %u, Free: %u", BUCKET_ARRAY_SIZE, size, taken, free);
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint8_t HASH_TABLE_BUCKET_TYPE::Fingerprint(const KeyType &key, const KeyComparator &cmp) {
+  if constexpr (BUCKET_FINGERPRINT_SIZE == 0) {
+    return 0;
+  } else {
+    if (!cmp.IsFixedWidth()) {
+      // equal keys may differ in their bytes, so every slot is a candidate
+      return 0;
+    }
+    // the comparator never looks past KeyLength(), and the directory indexes by the low bits of the table's hash
+    // function, which every key in a bucket shares, so the fingerprint is a separate multiplicative hash of the prefix
+    const char *bytes = reinterpret_cast<const char *>(&key);
+    size_t length = std::min(sizeof(KeyType), cmp.KeyLength());
+    uint64_t hash = length;
+    for (size_t offset = 0; offset < length; offset += sizeof(uint64_t)) {
+      uint64_t word = 0;
+      memcpy(&word, bytes + offset, std::min(sizeof(uint64_t), length - offset));
+      hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+    }
+    return static_cast<uint8_t>(hash >> 56);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_BUCKET_TYPE::BitmapGroup(const char *bitmap, size_t base) {
+  static_assert(BUCKET_PROBE_WIDTH == 16, "a probe group covers two bitmap bytes");
+  constexpr size_t bitmap_size = (BUCKET_ARRAY_SIZE - 1) / 8 + 1;
+  uint32_t group = static_cast<uint8_t>(bitmap[base / 8]);
+  if (base / 8 + 1 < bitmap_size) {
+    group |= static_cast<uint32_t>(static_cast<uint8_t>(bitmap[base / 8 + 1])) << 8;
+  }
+  return group;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t HASH_TABLE_BUCKET_TYPE::MatchFingerprints(size_t base, uint8_t fingerprint) const {
+  if constexpr (BUCKET_FINGERPRINT_SIZE == 0) {
+    return (1U << BUCKET_PROBE_WIDTH) - 1;
+  } else {
+#ifdef __SSE2__
+    __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(fingerprints_ + base));
+    __m128i matches = _mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(fingerprint)));
+    return static_cast<uint32_t>(_mm_movemask_epi8(matches));
+#else
+    uint32_t matches = 0;
+    for (size_t i = 0; i < BUCKET_PROBE_WIDTH; ++i) {
+      matches |= static_cast<uint32_t>(fingerprints_[base + i] == fingerprint) << i;
+    }
+    return matches;
+#endif
+  }
+}
+
 // DO NOT REMOVE ANYTHING BELOW THIS LINE
 template class HashTableBucketPage<int, int, IntComparator>;
 
@@ -16,8 +16,25 @@
 
 namespace bustub {
 
+/** A table page only knows its successor, so the heap is read one page ahead. */
+static size_t GetFollowingTablePages(BufferPoolManager *buffer_pool_manager, page_id_t page_id, page_id_t *page_ids,
+                                     size_t max_pages) {
+  auto page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(page_id));
+  if (page == nullptr) {
+    return 0;
+  }
+  page->RLatch();
+  page_ids[0] = page->GetNextPageId();
+  page->RUnlatch();
+  buffer_pool_manager->UnpinPage(page_id, false);
+  return page_ids[0] == INVALID_PAGE_ID ? 0 : 1;
+}
+
 TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn)
-    : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn) {
+    : table_heap_(table_heap),
+      tuple_(new Tuple(rid)),
+      txn_(txn),
+      read_ahead_(table_heap->buffer_pool_manager_, GetFollowingTablePages, table_scan_read_ahead_pages) {
   if (rid.GetPageId() != INVALID_PAGE_ID) {
     table_heap_->GetTuple(tuple_->rid_, tuple_, txn_);
   }
@@ -59,8 +76,10 @@ TableIterator &TableIterator::operator++() {
     table_heap_->GetTuple(tuple_->rid_, tuple_, txn_);
   }
   // release until copy the tuple
+  page_id_t cur_page_id = cur_page->GetTablePageId();
   cur_page->RUnlatch();
-  buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
+  buffer_pool_manager->UnpinPage(cur_page_id, false);
+  read_ahead_.OnPage(cur_page_id);
   return *this;
 }
 
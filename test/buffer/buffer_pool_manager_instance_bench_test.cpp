@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_manager_instance_bench_test.cpp
+//
+// Identification: test/buffer/buffer_pool_manager_instance_bench_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+const size_t BENCH_POOL_SIZE = 64;
+const size_t BENCH_OPS_PER_THREAD = 50000;
+
+// Fetch and unpin random pages. hot_percent of the accesses go to the first hot_pages pages, the rest are spread over
+// all working_set pages.
+void FetchUnpinHelper(BufferPoolManager *bpm, size_t working_set, size_t hot_pages, int hot_percent, uint64_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> percent(0, 99);
+  std::uniform_int_distribution<page_id_t> hot(0, static_cast<page_id_t>(hot_pages) - 1);
+  std::uniform_int_distribution<page_id_t> any(0, static_cast<page_id_t>(working_set) - 1);
+  for (size_t i = 0; i < BENCH_OPS_PER_THREAD; ++i) {
+    page_id_t page_id = percent(rng) < hot_percent ? hot(rng) : any(rng);
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    ASSERT_EQ(page_id, page->GetPageId());
+    bpm->UnpinPage(page_id, false);
+  }
+}
+
+// Returns the hit ratio of one run and prints its throughput.
+double RunFetchUnpinBenchmark(const std::string &name, size_t num_threads, size_t working_set, size_t hot_pages,
+                              int hot_percent) {
+  const std::string db_name = "bpm_bench.db";
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(BENCH_POOL_SIZE, disk_manager);
+
+  // Create the working set and leave the hot pages resident.
+  page_id_t page_id;
+  for (size_t i = 0; i < working_set; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id));
+    bpm->UnpinPage(page_id, true);
+  }
+  for (size_t i = 0; i < hot_pages; ++i) {
+    EXPECT_NE(nullptr, bpm->FetchPage(i));
+    bpm->UnpinPage(i, false);
+  }
+  size_t warm_misses = bpm->GetNumMisses();
+
+  auto start = std::chrono::high_resolution_clock::now();
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads.emplace_back(FetchUnpinHelper, bpm, working_set, hot_pages, hot_percent, i);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+
+  double total_ops = static_cast<double>(num_threads * BENCH_OPS_PER_THREAD);
+  double seconds = std::chrono::duration<double>(end - start).count();
+  double hit_ratio = 1.0 - static_cast<double>(bpm->GetNumMisses() - warm_misses) / total_ops;
+  std::cout << "[BENCHMARK: BufferPoolManagerInstanceBench." << name << "] threads: " << num_threads
+            << " ops/s: " << static_cast<uint64_t>(total_ops / seconds) << " hit ratio: " << hit_ratio << std::endl;
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove("bpm_bench.log");
+  delete bpm;
+  delete disk_manager;
+  return hit_ratio;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceBench, ResidentHitScaling) {
+  for (size_t num_threads : {1, 2, 4, 8, 16}) {
+    EXPECT_EQ(1.0, RunFetchUnpinBenchmark("ResidentHitScaling", num_threads, BENCH_POOL_SIZE, BENCH_POOL_SIZE, 100));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceBench, SkewedHitScaling) {
+  for (size_t num_threads : {1, 2, 4, 8, 16}) {
+    double hit_ratio = RunFetchUnpinBenchmark("SkewedHitScaling", num_threads, 4 * BENCH_POOL_SIZE,
+                                              BENCH_POOL_SIZE / 2, 99);
+    EXPECT_GT(hit_ratio, 0.9);
+  }
+}
+
+}  // namespace bustub
@@ -11,9 +11,12 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/buffer_pool_manager_instance.h"
+#include <chrono>  // NOLINT
 #include <cstdio>
 #include <random>
+#include <set>
 #include <string>
+#include <thread>  // NOLINT
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
 
@@ -141,4 +144,131 @@ TEST(BufferPoolManagerInstanceTest, SampleTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, BackgroundWriterTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  const size_t num_clean_frames = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Scenario: Fill the buffer pool with dirty, unpinned pages.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: The background writer cleans the next victims, i.e. the oldest pages, and leaves the rest dirty.
+  bpm->StartBackgroundWriter(num_clean_frames);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  auto pages = bpm->GetPages();
+  while (pages[num_clean_frames - 1].IsDirty() && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_EQ(i >= num_clean_frames, pages[i].IsDirty());
+  }
+  bpm->StopBackgroundWriter();
+
+  // Scenario: Evicting the cleaned pages needs no write-back, evicting the others does.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  EXPECT_EQ(num_clean_frames, bpm->GetNumCleanEvictions());
+  EXPECT_EQ(buffer_pool_size - num_clean_frames, bpm->GetNumDirtyEvictions());
+
+  // Scenario: Both the cleaned and the written back pages can be read again.
+  for (int i = 0; i < static_cast<int>(buffer_pool_size); ++i) {
+    auto *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(i), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(i, false));
+  }
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, PageReuseTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  // Enough pages that the free page list spans several list pages.
+  const int num_pages = 3 * FreeListPage::CAPACITY;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  for (int i = 0; i < num_pages; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(i, page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: A pinned page cannot be deleted, and so is not freed.
+  ASSERT_NE(nullptr, bpm->FetchPage(0));
+  EXPECT_EQ(false, bpm->DeletePage(0));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+
+  // Scenario: Delete every page but the first, both resident and evicted ones.
+  for (int i = 1; i < num_pages; ++i) {
+    EXPECT_EQ(true, bpm->DeletePage(i));
+  }
+  bpm->FlushAllPages();
+
+  // Scenario: New pages reuse each deleted page exactly once before the file grows.
+  std::set<page_id_t> reused;
+  for (int i = 1; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    EXPECT_GT(page_id_temp, 0);
+    EXPECT_LT(page_id_temp, num_pages);
+    EXPECT_TRUE(reused.insert(page_id_temp).second);
+    // A reused page starts out zeroed, like any new page.
+    EXPECT_EQ(0, page->GetData()[0]);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(num_pages, page_id_temp);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+
+  // Scenario: A page deleted twice, once resident and once not, is only handed out once.
+  EXPECT_EQ(true, bpm->DeletePage(1));
+  EXPECT_EQ(true, bpm->DeletePage(1));
+  page_id_t first_page_id;
+  page_id_t second_page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&first_page_id));
+  ASSERT_NE(nullptr, bpm->NewPage(&second_page_id));
+  EXPECT_EQ(1, first_page_id);
+  EXPECT_NE(first_page_id, second_page_id);
+  EXPECT_EQ(true, bpm->UnpinPage(first_page_id, false));
+  EXPECT_EQ(true, bpm->UnpinPage(second_page_id, false));
+
+  // Scenario: A deleted page cannot be fetched until it is handed out again, so nobody holds it pinned by then.
+  EXPECT_EQ(true, bpm->DeletePage(2));
+  EXPECT_EQ(nullptr, bpm->FetchPage(2));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(2, page_id_temp);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  ASSERT_NE(nullptr, bpm->FetchPage(2));
+  EXPECT_EQ(true, bpm->UnpinPage(2, false));
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
@@ -19,7 +19,7 @@
 
 namespace bustub {
 
-TEST(ClockReplacerTest, DISABLED_SampleTest) {
+TEST(ClockReplacerTest, SampleTest) {
   ClockReplacer clock_replacer(7);
 
   // Scenario: unpin six elements, i.e. add them to the replacer.
@@ -59,4 +59,45 @@ TEST(ClockReplacerTest, DISABLED_SampleTest) {
   EXPECT_EQ(4, value);
 }
 
+TEST(ClockReplacerTest, ConcurrentPinUnpinTest) {
+  const int num_threads = 8;
+  const int frames_per_thread = 64;
+  ClockReplacer clock_replacer(num_threads * frames_per_thread);
+
+  // Every thread pins and unpins its own frames while the main thread keeps evicting.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([&clock_replacer, tid] {
+      for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < frames_per_thread; ++i) {
+          clock_replacer.Pin(tid * frames_per_thread + i);
+          clock_replacer.Unpin(tid * frames_per_thread + i);
+        }
+      }
+    });
+  }
+  int value;
+  for (int i = 0; i < 1000; ++i) {
+    if (clock_replacer.Victim(&value)) {
+      EXPECT_GE(value, 0);
+      EXPECT_LT(value, num_threads * frames_per_thread);
+    }
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Put back the frames the main thread evicted; now each frame must be a victim exactly once.
+  for (int i = 0; i < num_threads * frames_per_thread; ++i) {
+    clock_replacer.Unpin(i);
+  }
+  EXPECT_EQ(num_threads * frames_per_thread, clock_replacer.Size());
+  std::vector<bool> seen(num_threads * frames_per_thread, false);
+  while (clock_replacer.Victim(&value)) {
+    EXPECT_FALSE(seen[value]);
+    seen[value] = true;
+  }
+  EXPECT_EQ(0, clock_replacer.Size());
+}
+
 }  // namespace bustub
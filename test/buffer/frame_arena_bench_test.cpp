@@ -0,0 +1,172 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena_bench_test.cpp
+//
+// Identification: test/buffer/frame_arena_bench_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/frame_arena.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+const size_t BENCH_NUM_FRAMES = 32768;
+const size_t BENCH_NUM_OPS = 2000000;
+
+// Counts the data TLB misses of this thread in user space. Reports -1 if the system does not expose the counter, e.g.
+// inside a VM or with a restrictive perf_event_paranoid.
+class TLBMissCounter {
+ public:
+  TLBMissCounter() {
+    perf_event_attr attr{};
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+
+  ~TLBMissCounter() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  void Start() {
+    if (fd_ >= 0) {
+      ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+
+  int64_t Stop() {
+    uint64_t count = 0;
+    if (fd_ < 0) {
+      return -1;
+    }
+    ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(fd_, &count, sizeof(count)) != sizeof(count)) {
+      return -1;
+    }
+    return static_cast<int64_t>(count);
+  }
+
+ private:
+  int fd_;
+};
+
+const char *HugePageModeName(FrameArena::HugePageMode mode) {
+  switch (mode) {
+    case FrameArena::HugePageMode::NONE:
+      return "none";
+    case FrameArena::HugePageMode::TRANSPARENT:
+      return "transparent";
+    case FrameArena::HugePageMode::HUGETLB:
+      return "hugetlb";
+  }
+  return "unknown";
+}
+
+void PrintResult(const std::string &name, FrameArena::HugePageMode mode, double seconds, int64_t tlb_misses) {
+  std::cout << "[BENCHMARK: FrameArenaBench." << name << "] huge pages: " << HugePageModeName(mode)
+            << " ops/s: " << static_cast<uint64_t>(BENCH_NUM_OPS / seconds) << " dTLB-load-misses/op: ";
+  if (tlb_misses < 0) {
+    std::cout << "unavailable" << std::endl;
+  } else {
+    std::cout << static_cast<double>(tlb_misses) / BENCH_NUM_OPS << std::endl;
+  }
+}
+
+// Read one word at a random offset of a random frame, which is the access pattern of key lookups in index pages.
+// NOLINTNEXTLINE
+TEST(FrameArenaBench, RandomFrameAccess) {
+  for (bool huge_pages : {false, true}) {
+    FrameArena arena(BENCH_NUM_FRAMES, huge_pages);
+    for (size_t i = 0; i < BENCH_NUM_FRAMES; ++i) {
+      arena.GetFrameData(static_cast<frame_id_t>(i))[0] = 1;
+    }
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<frame_id_t> frame(0, BENCH_NUM_FRAMES - 1);
+    std::uniform_int_distribution<size_t> offset(0, PAGE_SIZE / sizeof(uint64_t) - 1);
+
+    TLBMissCounter counter;
+    uint64_t sum = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    counter.Start();
+    for (size_t i = 0; i < BENCH_NUM_OPS; ++i) {
+      sum += reinterpret_cast<uint64_t *>(arena.GetFrameData(frame(rng)))[offset(rng)];
+    }
+    int64_t tlb_misses = counter.Stop();
+    auto end = std::chrono::high_resolution_clock::now();
+    EXPECT_LE(sum, BENCH_NUM_OPS);
+    PrintResult("RandomFrameAccess", arena.GetHugePageMode(), std::chrono::duration<double>(end - start).count(),
+                tlb_misses);
+  }
+}
+
+// Fetch random resident pages through the buffer pool and read one word of each.
+// NOLINTNEXTLINE
+TEST(FrameArenaBench, RandomFetch) {
+  bool saved_huge_pages = buffer_pool_huge_pages;
+  for (bool huge_pages : {false, true}) {
+    buffer_pool_huge_pages = huge_pages;
+    const std::string db_name = "frame_arena_bench.db";
+    auto *disk_manager = new DiskManager(db_name);
+    auto *bpm = new BufferPoolManagerInstance(BENCH_NUM_FRAMES, disk_manager);
+    page_id_t page_id;
+    for (size_t i = 0; i < BENCH_NUM_FRAMES; ++i) {
+      ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+      bpm->UnpinPage(page_id, false);
+    }
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<page_id_t> any(0, BENCH_NUM_FRAMES - 1);
+    std::uniform_int_distribution<size_t> offset(0, PAGE_SIZE / sizeof(uint64_t) - 1);
+
+    TLBMissCounter counter;
+    uint64_t sum = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    counter.Start();
+    for (size_t i = 0; i < BENCH_NUM_OPS; ++i) {
+      page_id = any(rng);
+      Page *page = bpm->FetchPage(page_id);
+      sum += reinterpret_cast<uint64_t *>(page->GetData())[offset(rng)];
+      bpm->UnpinPage(page_id, false);
+    }
+    int64_t tlb_misses = counter.Stop();
+    auto end = std::chrono::high_resolution_clock::now();
+    EXPECT_EQ(0, sum);
+    EXPECT_EQ(0, bpm->GetNumMisses());
+    PrintResult("RandomFetch", bpm->GetFrameArena().GetHugePageMode(),
+                std::chrono::duration<double>(end - start).count(), tlb_misses);
+
+    disk_manager->ShutDown();
+    remove(db_name.c_str());
+    remove("frame_arena_bench.log");
+    delete bpm;
+    delete disk_manager;
+  }
+  buffer_pool_huge_pages = saved_huge_pages;
+}
+
+}  // namespace bustub
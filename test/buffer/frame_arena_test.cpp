@@ -0,0 +1,109 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena_test.cpp
+//
+// Identification: test/buffer/frame_arena_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/frame_arena.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// Every frame must be page-aligned, zeroed, and must not overlap its neighbours.
+void CheckFrames(FrameArena *arena, size_t num_frames) {
+  for (size_t i = 0; i < num_frames; ++i) {
+    char *data = arena->GetFrameData(static_cast<frame_id_t>(i));
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(data) % PAGE_SIZE);
+    EXPECT_EQ(0, data[0]);
+    EXPECT_EQ(0, data[PAGE_SIZE - 1]);
+    memset(data, static_cast<int>(i % 128), PAGE_SIZE);
+  }
+  for (size_t i = 0; i < num_frames; ++i) {
+    char *data = arena->GetFrameData(static_cast<frame_id_t>(i));
+    EXPECT_EQ(static_cast<char>(i % 128), data[0]);
+    EXPECT_EQ(static_cast<char>(i % 128), data[PAGE_SIZE - 1]);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, RegularPagesTest) {
+  const size_t num_frames = 100;
+  FrameArena arena(num_frames, false);
+  EXPECT_EQ(FrameArena::HugePageMode::NONE, arena.GetHugePageMode());
+  EXPECT_EQ(-1, arena.GetNumaNode());
+  CheckFrames(&arena, num_frames);
+}
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, HugePagesTest) {
+  // Whether huge pages are available depends on the system, but the arena must work either way.
+  const size_t num_frames = 1000;
+  FrameArena arena(num_frames, true);
+  if (arena.GetHugePageMode() != FrameArena::HugePageMode::NONE) {
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(arena.GetFrameData(0)) % FrameArena::HUGE_PAGE_SIZE);
+  }
+  CheckFrames(&arena, num_frames);
+}
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, NumaNodeTest) {
+  ASSERT_GE(FrameArena::GetNumNumaNodes(), 1);
+  const size_t num_frames = 10;
+  FrameArena arena(num_frames, true, 0);
+  // Placement is only requested on systems with more than one node.
+  EXPECT_EQ(FrameArena::GetNumNumaNodes() > 1 ? 0 : -1, arena.GetNumaNode());
+  CheckFrames(&arena, num_frames);
+
+  // A node that does not exist is ignored.
+  FrameArena other_arena(num_frames, true, static_cast<int>(FrameArena::GetNumNumaNodes()));
+  EXPECT_EQ(-1, other_arena.GetNumaNode());
+  CheckFrames(&other_arena, num_frames);
+}
+
+// NOLINTNEXTLINE
+TEST(FrameArenaTest, BufferPoolFramesTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(2, buffer_pool_size, disk_manager);
+
+  // Pages handed out by the buffer pool point into its arena, and their data survives eviction.
+  page_id_t page_id;
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < 4 * buffer_pool_size; ++i) {
+    Page *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(page->GetData()) % PAGE_SIZE);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    page_ids.push_back(page_id);
+  }
+  for (page_id_t page_id : page_ids) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(page_id), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove("test.log");
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer_test.cpp
+//
+// Identification: test/buffer/lru_k_replacer_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <vector>
+
+#include "buffer/lru_k_replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(LRUKReplacerTest, SampleTest) {
+  LRUKReplacer lru_k_replacer(7, 2);
+
+  // Scenario: pin and unpin six frames once each, then access frame 1 again. Frame 1 now has two accesses.
+  for (frame_id_t frame_id = 1; frame_id <= 6; ++frame_id) {
+    lru_k_replacer.Pin(frame_id);
+    lru_k_replacer.Unpin(frame_id);
+  }
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Unpin(1);
+  EXPECT_EQ(6, lru_k_replacer.Size());
+
+  // Scenario: frames with a single access go first, oldest first access first. Frame 1 is kept.
+  int value;
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+  EXPECT_EQ(std::vector<frame_id_t>({4, 5, 6, 1}), lru_k_replacer.PeekVictims(10));
+
+  // Scenario: pinned frames are not victims. Pinning 3 again has no effect on the size, it was already victimized.
+  lru_k_replacer.Pin(3);
+  lru_k_replacer.Pin(4);
+  EXPECT_EQ(3, lru_k_replacer.Size());
+
+  // Scenario: 4 now has two accesses as well, but its second-most-recent access is newer than the one of 1.
+  lru_k_replacer.Unpin(4);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(5, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(6, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(4, value);
+  EXPECT_FALSE(lru_k_replacer.Victim(&value));
+  EXPECT_EQ(0, lru_k_replacer.Size());
+  // Scenario: 3 was pinned and never unpinned. Unpinning it makes it evictable.
+  lru_k_replacer.Unpin(3);
+  EXPECT_EQ(1, lru_k_replacer.Size());
+}
+
+TEST(LRUKReplacerTest, RecordAccessAndRemove) {
+  LRUKReplacer lru_k_replacer(7, 2);
+
+  // Scenario: frame 1 is pinned once and hit again while pinned, so it has two accesses; 2 and 3 have one each.
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.RecordAccess(1);
+  lru_k_replacer.Unpin(1);
+  for (frame_id_t frame_id = 2; frame_id <= 3; ++frame_id) {
+    lru_k_replacer.Pin(frame_id);
+    lru_k_replacer.Unpin(frame_id);
+  }
+  EXPECT_EQ(std::vector<frame_id_t>({2, 3, 1}), lru_k_replacer.PeekVictims(10));
+
+  // Scenario: removing a frame takes it out without an access, and it starts over with no history.
+  lru_k_replacer.Remove(1);
+  lru_k_replacer.Remove(2);
+  EXPECT_EQ(std::vector<frame_id_t>({3}), lru_k_replacer.PeekVictims(10));
+  lru_k_replacer.Pin(1);
+  lru_k_replacer.Unpin(1);
+  EXPECT_EQ(std::vector<frame_id_t>({3, 1}), lru_k_replacer.PeekVictims(10));
+
+  // Scenario: an access to an evictable frame moves it in the queues.
+  lru_k_replacer.RecordAccess(3);
+  EXPECT_EQ(std::vector<frame_id_t>({1, 3}), lru_k_replacer.PeekVictims(10));
+}
+
+}  // namespace bustub
@@ -0,0 +1,159 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_replacer_bench_test.cpp
+//
+// Identification: test/buffer/lru_replacer_bench_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <mutex>  // NOLINT
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/lru_replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/**
+ * The previous LRUReplacer, kept as a baseline: a heap-allocated node per unpinned frame and a hash map from frame id
+ * to node.
+ */
+class NodeLRUReplacer : public Replacer {
+ public:
+  explicit NodeLRUReplacer(size_t num_pages) {
+    head_ = new FrameInfo(-1);
+    tail_ = new FrameInfo(-1);
+    head_->next_ = tail_;
+    tail_->prev_ = head_;
+  }
+
+  ~NodeLRUReplacer() override {
+    FrameInfo *frame_info = head_;
+    while (frame_info != nullptr) {
+      FrameInfo *next = frame_info->next_;
+      delete frame_info;
+      frame_info = next;
+    }
+  }
+
+  bool Victim(frame_id_t *frame_id) override {
+    std::lock_guard<std::mutex> guard(latch_);
+    if (frame_holders_.empty()) {
+      return false;
+    }
+    FrameInfo *frame_info = head_->next_;
+    *frame_id = frame_info->frame_id_;
+    frame_holders_.erase(frame_info->frame_id_);
+    Unlink(frame_info);
+    delete frame_info;
+    return true;
+  }
+
+  void Pin(frame_id_t frame_id) override {
+    std::lock_guard<std::mutex> guard(latch_);
+    auto iter = frame_holders_.find(frame_id);
+    if (iter == frame_holders_.end()) {
+      return;
+    }
+    FrameInfo *frame_info = iter->second;
+    frame_holders_.erase(iter);
+    Unlink(frame_info);
+    delete frame_info;
+  }
+
+  void Unpin(frame_id_t frame_id) override {
+    std::lock_guard<std::mutex> guard(latch_);
+    if (frame_holders_.find(frame_id) != frame_holders_.end()) {
+      return;
+    }
+    auto *frame_info = new FrameInfo(frame_id);
+    frame_holders_.insert({frame_id, frame_info});
+    frame_info->prev_ = tail_->prev_;
+    frame_info->next_ = tail_;
+    tail_->prev_->next_ = frame_info;
+    tail_->prev_ = frame_info;
+  }
+
+  size_t Size() override { return frame_holders_.size(); }
+
+ private:
+  struct FrameInfo {
+    explicit FrameInfo(frame_id_t frame_id) : frame_id_(frame_id) {}
+    frame_id_t frame_id_;
+    FrameInfo *prev_{nullptr};
+    FrameInfo *next_{nullptr};
+  };
+
+  void Unlink(FrameInfo *frame_info) {
+    frame_info->prev_->next_ = frame_info->next_;
+    frame_info->next_->prev_ = frame_info->prev_;
+  }
+
+  FrameInfo *head_;
+  FrameInfo *tail_;
+  std::unordered_map<frame_id_t, FrameInfo *> frame_holders_;
+  std::mutex latch_;
+};
+
+const size_t LRU_BENCH_NUM_FRAMES = 4096;
+const size_t LRU_BENCH_NUM_OPS = 1000000;
+
+// Returns the throughput in operations per second of the given workload.
+template <typename Workload>
+double Measure(Workload workload) {
+  auto start = std::chrono::high_resolution_clock::now();
+  workload();
+  auto end = std::chrono::high_resolution_clock::now();
+  return LRU_BENCH_NUM_OPS / std::chrono::duration<double>(end - start).count();
+}
+
+void RunReplacerBenchmark(const std::string &name, Replacer *replacer) {
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<frame_id_t> dist(0, LRU_BENCH_NUM_FRAMES - 1);
+  std::vector<frame_id_t> frames(LRU_BENCH_NUM_OPS);
+  for (auto &frame_id : frames) {
+    frame_id = dist(rng);
+  }
+  for (size_t i = 0; i < LRU_BENCH_NUM_FRAMES; ++i) {
+    replacer->Unpin(i);
+  }
+
+  // A buffer pool hit on an unpinned page followed by its unpin.
+  double pin_unpin = Measure([&] {
+    for (size_t i = 0; i < LRU_BENCH_NUM_OPS; i += 2) {
+      replacer->Pin(frames[i]);
+      replacer->Unpin(frames[i]);
+    }
+  });
+  // A buffer pool miss: evict a frame and unpin it again once the new page is released.
+  double victim_unpin = Measure([&] {
+    frame_id_t frame_id;
+    for (size_t i = 0; i < LRU_BENCH_NUM_OPS; i += 2) {
+      ASSERT_TRUE(replacer->Victim(&frame_id));
+      replacer->Unpin(frame_id);
+    }
+  });
+  EXPECT_EQ(LRU_BENCH_NUM_FRAMES, replacer->Size());
+
+  std::cout << "[BENCHMARK: LRUReplacerBench] " << name << " pin/unpin ops/s: " << static_cast<uint64_t>(pin_unpin)
+            << " victim/unpin ops/s: " << static_cast<uint64_t>(victim_unpin) << std::endl;
+}
+
+// NOLINTNEXTLINE
+TEST(LRUReplacerBench, PinUnpinVictim) {
+  NodeLRUReplacer node_replacer(LRU_BENCH_NUM_FRAMES);
+  RunReplacerBenchmark("node-based", &node_replacer);
+  LRUReplacer lru_replacer(LRU_BENCH_NUM_FRAMES);
+  RunReplacerBenchmark("array-based", &lru_replacer);
+}
+
+}  // namespace bustub
@@ -13,7 +13,10 @@
 #include "buffer/parallel_buffer_pool_manager.h"
 #include <cstdio>
 #include <random>
+#include <set>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
 
@@ -179,4 +182,205 @@ TEST(ParallelBufferPoolManagerTest, SampleTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, PageReuseTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 5;
+  const size_t num_instances = 2;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  std::set<page_id_t> created;
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    created.insert(page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+
+  // Scenario: Each instance only hands out the deleted pages of its own stripe, so every deleted page gets reused once.
+  for (page_id_t page_id : created) {
+    EXPECT_EQ(true, bpm->DeletePage(page_id));
+  }
+  std::set<page_id_t> reused;
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    reused.insert(page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+    // Fetching goes to the instance that owns the page id, which must be the one that created it.
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  EXPECT_EQ(created, reused);
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, NewPageHomeInstanceTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  const size_t num_instances = 4;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+
+  // Scenario: Threads that keep their pages pinned each fill their own home instance.
+  std::vector<std::vector<page_id_t>> thread_page_ids(num_instances);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < num_instances; ++t) {
+    threads.emplace_back([&, t] {
+      page_id_t page_id;
+      for (size_t i = 0; i < buffer_pool_size; ++i) {
+        ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+        thread_page_ids[t].push_back(page_id);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (size_t t = 0; t < num_instances; ++t) {
+    // Each thread got all its pages from one instance, since that never ran out of frames before the thread was done.
+    for (page_id_t page_id : thread_page_ids[t]) {
+      EXPECT_EQ(thread_page_ids[t][0] % num_instances, page_id % num_instances);
+    }
+  }
+  for (const auto &stats : bpm->GetInstanceStats()) {
+    EXPECT_EQ(buffer_pool_size, stats.num_pinned_frames_);
+  }
+
+  // Scenario: Once every frame is pinned, no instance has a frame to spare.
+  page_id_t page_id_temp;
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+  // Scenario: A thread whose home instance is full falls back to another instance.
+  page_id_t freed_page_id = thread_page_ids[0][0];
+  EXPECT_EQ(true, bpm->UnpinPage(freed_page_id, true));
+  for (size_t t = 0; t < num_instances; ++t) {
+    std::thread([&] {
+      page_id_t page_id;
+      Page *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(freed_page_id % num_instances, page_id % num_instances);
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    }).join();
+  }
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, NewPageFreeFramesFirstTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  const size_t num_instances = 4;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+
+  // Scenario: A single thread that unpins its pages right away fills every instance before any page is evicted.
+  page_id_t page_id;
+  for (size_t i = 0; i < buffer_pool_size * num_instances; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(0, bpm->GetNumCleanEvictions() + bpm->GetNumDirtyEvictions());
+
+  // Scenario: Once no instance has a free frame, the next page evicts one.
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  EXPECT_EQ(1, bpm->GetNumCleanEvictions() + bpm->GetNumDirtyEvictions());
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, InstanceStatsTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 2;
+  const size_t num_instances = 2;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+
+  // Scenario: Two pinned pages fill the home instance of this thread, so the next two come from the other instance.
+  page_id_t page_id_temp;
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    page_ids.push_back(page_id_temp);
+  }
+  size_t home_index = page_ids[0] % num_instances;
+  EXPECT_EQ(home_index, page_ids[1] % num_instances);
+  std::vector<page_id_t> other_page_ids;
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(1 - home_index, page_id_temp % num_instances);
+    other_page_ids.push_back(page_id_temp);
+  }
+
+  auto stats = bpm->GetInstanceStats();
+  ASSERT_EQ(num_instances, stats.size());
+  EXPECT_EQ(buffer_pool_size, stats[home_index].pool_size_);
+  EXPECT_EQ(2, stats[home_index].num_pinned_frames_);
+  EXPECT_EQ(2, stats[1 - home_index].num_pinned_frames_);
+  for (page_id_t page_id : other_page_ids) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+  for (page_id_t page_id : page_ids) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: Fetch both resident pages twice.
+  for (int i = 0; i < 2; ++i) {
+    for (page_id_t page_id : page_ids) {
+      ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+      EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+    }
+  }
+  // Scenario: No instance has a free frame, so a new page evicts the first page at home, which is dirty. Fetching it
+  // back evicts the second page, which is also dirty, and fetching that one back evicts the first page again, which is
+  // clean by now.
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  for (page_id_t page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  stats = bpm->GetInstanceStats();
+  EXPECT_EQ(4, stats[home_index].num_hits_);
+  EXPECT_EQ(2, stats[home_index].num_misses_);
+  EXPECT_EQ(1, stats[home_index].num_clean_evictions_);
+  EXPECT_EQ(2, stats[home_index].num_dirty_evictions_);
+  EXPECT_EQ(1, stats[home_index].num_pinned_frames_);
+  EXPECT_EQ(0, stats[1 - home_index].num_hits_);
+  EXPECT_EQ(0, stats[1 - home_index].num_misses_);
+  EXPECT_EQ(0, stats[1 - home_index].num_pinned_frames_);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
@@ -0,0 +1,155 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer_bench_test.cpp
+//
+// Identification: test/buffer/replacer_bench_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+const size_t SCAN_BENCH_POOL_SIZE = 64;
+const size_t SCAN_BENCH_HOT_PAGES = 32;
+const size_t SCAN_BENCH_SCAN_PAGES = 512;
+const size_t SCAN_BENCH_LOOKUPS = 20000;
+const size_t CONTENTION_BENCH_FRAMES = 1024;
+const size_t CONTENTION_BENCH_OPS_PER_THREAD = 200000;
+
+std::string ReplacerName(ReplacerType replacer_type) {
+  switch (replacer_type) {
+    case ReplacerType::LRU:
+      return "LRU";
+    case ReplacerType::LRU_K:
+      return "LRU-K";
+    case ReplacerType::CLOCK:
+      return "CLOCK";
+  }
+  return "";
+}
+
+// Point lookups on a small hot set (think B+ tree inner pages) interleaved with a sequential scan that loops over a
+// table eight times the size of the pool. Returns the hit ratio of the point lookups.
+double RunScanMixBenchmark(ReplacerType replacer_type) {
+  const std::string db_name = "replacer_bench.db";
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(SCAN_BENCH_POOL_SIZE, disk_manager, nullptr, replacer_type);
+
+  // Pages [0, SCAN_BENCH_HOT_PAGES) are hot, the rest are scanned.
+  page_id_t page_id;
+  for (size_t i = 0; i < SCAN_BENCH_HOT_PAGES + SCAN_BENCH_SCAN_PAGES; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id));
+    bpm->UnpinPage(page_id, true);
+  }
+
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<page_id_t> hot(0, SCAN_BENCH_HOT_PAGES - 1);
+  size_t scan_cursor = 0;
+  size_t lookup_misses = 0;
+  for (size_t i = 0; i < SCAN_BENCH_LOOKUPS; ++i) {
+    // Every point lookup is followed by the scan advancing one page.
+    size_t misses = bpm->GetNumMisses();
+    page_id = hot(rng);
+    EXPECT_NE(nullptr, bpm->FetchPage(page_id));
+    bpm->UnpinPage(page_id, false);
+    lookup_misses += bpm->GetNumMisses() - misses;
+
+    page_id = static_cast<page_id_t>(SCAN_BENCH_HOT_PAGES + scan_cursor);
+    scan_cursor = (scan_cursor + 1) % SCAN_BENCH_SCAN_PAGES;
+    EXPECT_NE(nullptr, bpm->FetchPage(page_id));
+    bpm->UnpinPage(page_id, false);
+  }
+
+  double hit_ratio = 1.0 - static_cast<double>(lookup_misses) / SCAN_BENCH_LOOKUPS;
+  std::cout << "[BENCHMARK: ReplacerBench.ScanResistance] replacer: " << ReplacerName(replacer_type)
+            << " lookup hit ratio: " << hit_ratio << " total misses: " << bpm->GetNumMisses() << std::endl;
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove("replacer_bench.log");
+  delete bpm;
+  delete disk_manager;
+  return hit_ratio;
+}
+
+// NOLINTNEXTLINE
+TEST(ReplacerBench, ScanResistance) {
+  double lru_hit_ratio = RunScanMixBenchmark(ReplacerType::LRU);
+  double lru_k_hit_ratio = RunScanMixBenchmark(ReplacerType::LRU_K);
+  EXPECT_GT(lru_k_hit_ratio, lru_hit_ratio);
+  RunScanMixBenchmark(ReplacerType::CLOCK);
+}
+
+std::unique_ptr<Replacer> MakeReplacer(ReplacerType replacer_type, size_t num_pages) {
+  switch (replacer_type) {
+    case ReplacerType::LRU:
+      return std::make_unique<LRUReplacer>(num_pages);
+    case ReplacerType::LRU_K:
+      return std::make_unique<LRUKReplacer>(num_pages);
+    case ReplacerType::CLOCK:
+      return std::make_unique<ClockReplacer>(num_pages);
+  }
+  return nullptr;
+}
+
+// The replacer calls a buffer pool makes on hits: every thread pins and unpins random frames of its own, and one call
+// in 64 asks for a victim, which it then gives back.
+void PinUnpinHelper(Replacer *replacer, size_t thread_id, size_t num_threads) {
+  size_t frames_per_thread = CONTENTION_BENCH_FRAMES / num_threads;
+  std::mt19937 rng(thread_id);
+  std::uniform_int_distribution<size_t> frame(0, frames_per_thread - 1);
+  for (size_t i = 0; i < CONTENTION_BENCH_OPS_PER_THREAD; ++i) {
+    auto frame_id = static_cast<frame_id_t>(thread_id * frames_per_thread + frame(rng));
+    replacer->Pin(frame_id);
+    replacer->Unpin(frame_id);
+    if (i % 64 == 0 && replacer->Victim(&frame_id)) {
+      replacer->Unpin(frame_id);
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(ReplacerBench, PinUnpinContention) {
+  for (auto replacer_type : {ReplacerType::LRU, ReplacerType::LRU_K, ReplacerType::CLOCK}) {
+    for (size_t num_threads : {1, 4, 16, 32}) {
+      auto replacer = MakeReplacer(replacer_type, CONTENTION_BENCH_FRAMES);
+      for (size_t i = 0; i < CONTENTION_BENCH_FRAMES; ++i) {
+        replacer->Unpin(static_cast<frame_id_t>(i));
+      }
+
+      auto start = std::chrono::high_resolution_clock::now();
+      std::vector<std::thread> threads;
+      for (size_t i = 0; i < num_threads; ++i) {
+        threads.emplace_back(PinUnpinHelper, replacer.get(), i, num_threads);
+      }
+      for (auto &thread : threads) {
+        thread.join();
+      }
+      auto end = std::chrono::high_resolution_clock::now();
+
+      double total_ops = static_cast<double>(num_threads * CONTENTION_BENCH_OPS_PER_THREAD);
+      double seconds = std::chrono::duration<double>(end - start).count();
+      std::cout << "[BENCHMARK: ReplacerBench.PinUnpinContention] replacer: " << ReplacerName(replacer_type)
+                << " threads: " << num_threads << " pin/unpin pairs/s: " << static_cast<uint64_t>(total_ops / seconds)
+                << std::endl;
+      EXPECT_EQ(CONTENTION_BENCH_FRAMES, replacer->Size());
+    }
+  }
+}
+
+}  // namespace bustub
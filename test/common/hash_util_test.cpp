@@ -0,0 +1,223 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_util_test.cpp
+//
+// Identification: test/common/hash_util_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "container/hash/hash_function.h"
+#include "gtest/gtest.h"
+#include "murmur3/MurmurHash3.h"
+#include "storage/index/generic_key.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// Flipping any input bit flips every output bit for about half of the inputs.
+void CheckAvalanche(size_t input_bytes, const std::function<hash_t(const char *)> &hash) {
+  const int num_samples = 2000;
+  std::mt19937_64 rng(0);
+  std::vector<char> input(input_bytes);
+  std::vector<int> flips(input_bytes * 8 * 64);
+  for (int sample = 0; sample < num_samples; ++sample) {
+    for (auto &byte : input) {
+      byte = static_cast<char>(rng());
+    }
+    hash_t base = hash(input.data());
+    for (size_t bit = 0; bit < input_bytes * 8; ++bit) {
+      input[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+      hash_t diff = base ^ hash(input.data());
+      input[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+      for (int out = 0; out < 64; ++out) {
+        flips[bit * 64 + out] += static_cast<int>((diff >> out) & 1);
+      }
+    }
+  }
+  for (size_t i = 0; i < flips.size(); ++i) {
+    double share = static_cast<double>(flips[i]) / num_samples;
+    ASSERT_GT(share, 0.4) << "input bit " << i / 64 << " output bit " << i % 64;
+    ASSERT_LT(share, 0.6) << "input bit " << i / 64 << " output bit " << i % 64;
+  }
+}
+
+// The hashes of sequential keys spread evenly over the buckets of their low bits and of their high bits.
+void CheckDistribution(const std::function<hash_t(int64_t)> &hash) {
+  const int64_t num_keys = 100000;
+  const int num_buckets = 1024;
+  std::vector<int> low(num_buckets);
+  std::vector<int> high(num_buckets);
+  std::unordered_set<hash_t> hashes;
+  for (int64_t key = 0; key < num_keys; ++key) {
+    hash_t value = hash(key);
+    ++low[value % num_buckets];
+    ++high[value >> 54];
+    hashes.insert(value);
+  }
+  EXPECT_EQ(num_keys, hashes.size());
+  double expected = static_cast<double>(num_keys) / num_buckets;
+  for (const auto &buckets : {low, high}) {
+    double chi_square = 0;
+    for (int count : buckets) {
+      chi_square += (count - expected) * (count - expected) / expected;
+    }
+    // 1023 degrees of freedom: mean 1023, standard deviation about 45
+    EXPECT_LT(chi_square, 1300);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, Avalanche) {
+  CheckAvalanche(8, [](const char *bytes) {
+    uint64_t value;
+    memcpy(&value, bytes, sizeof(value));
+    return HashUtil::HashInt(value);
+  });
+  for (size_t length : {3, 8, 12, 16, 40, 100}) {
+    CheckAvalanche(length, [length](const char *bytes) { return HashUtil::HashBytes(bytes, length); });
+  }
+  CheckAvalanche(16, [](const char *bytes) {
+    hash_t l;
+    hash_t r;
+    memcpy(&l, bytes, sizeof(l));
+    memcpy(&r, bytes + 8, sizeof(r));
+    return HashUtil::CombineHashes(l, r);
+  });
+}
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, Distribution) {
+  CheckDistribution([](int64_t key) { return HashUtil::Hash(&key); });
+  CheckDistribution([](int64_t key) { return HashUtil::HashBytes(reinterpret_cast<const char *>(&key), 8); });
+  HashFunction<GenericKey<8>> hash_fn;
+  hash_fn.SetKeyLength(4);
+  CheckDistribution([&hash_fn](int64_t key) {
+    GenericKey<8> index_key;
+    index_key.SetFromInteger(key);
+    return hash_fn.GetHash(index_key);
+  });
+  CheckDistribution([](int64_t key) {
+    std::string text = "key" + std::to_string(key);
+    return HashUtil::HashBytes(text.data(), text.size());
+  });
+}
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, LengthsAndSeeds) {
+  // every prefix of a buffer hashes differently, also when it is all zeros
+  for (char fill : {'\0', 'x'}) {
+    std::vector<char> bytes(256, fill);
+    std::unordered_set<hash_t> hashes;
+    for (size_t length = 0; length <= bytes.size(); ++length) {
+      hashes.insert(HashUtil::HashBytes(bytes.data(), length));
+    }
+    EXPECT_EQ(bytes.size() + 1, hashes.size());
+  }
+  const char *text = "the quick brown fox jumps over the lazy dog";
+  EXPECT_EQ(HashUtil::HashBytes(text, strlen(text)), HashUtil::HashBytes(text, strlen(text), 0));
+  EXPECT_NE(HashUtil::HashBytes(text, strlen(text), 1), HashUtil::HashBytes(text, strlen(text), 2));
+  EXPECT_NE(HashUtil::CombineHashes(1, 2), HashUtil::CombineHashes(2, 1));
+}
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, ReferenceVectors) {
+  // the test vectors of the wyhash repository, hashed with the index of each message as the seed
+  const std::vector<std::pair<std::string, hash_t>> vectors = {
+      {"", 0x42bc986dc5eec4d3},
+      {"a", 0x84508dc903c31551},
+      {"abc", 0x0bc54887cfc9ecb1},
+      {"message digest", 0x6e2ff3298208a67c},
+      {"abcdefghijklmnopqrstuvwxyz", 0x9a64e42e897195b9},
+      {"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789", 0x9199383239c32554},
+      {"12345678901234567890123456789012345678901234567890123456789012345678901234567890", 0x7c1ccf6bba30f5a5},
+  };
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    EXPECT_EQ(vectors[i].second, HashUtil::HashBytes(vectors[i].first.data(), vectors[i].first.size(), i)) << i;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, EqualKeysHashEqual) {
+  // equal values of different integer types, and the two zeros of a decimal
+  Value tinyint = ValueFactory::GetTinyIntValue(7);
+  Value bigint = ValueFactory::GetBigIntValue(7);
+  EXPECT_EQ(HashUtil::HashValue(&tinyint), HashUtil::HashValue(&bigint));
+  Value zero = ValueFactory::GetDecimalValue(0.0);
+  Value negative_zero = ValueFactory::GetDecimalValue(-0.0);
+  EXPECT_EQ(HashUtil::HashValue(&zero), HashUtil::HashValue(&negative_zero));
+
+  // the bytes of a key past its key length don't count
+  HashFunction<GenericKey<8>> hash_fn;
+  hash_fn.SetKeyLength(4);
+  GenericKey<8> key;
+  GenericKey<8> padded_key;
+  key.SetFromInteger(42);
+  padded_key.SetFromInteger(42 + (int64_t{99} << 32));
+  EXPECT_EQ(hash_fn.GetHash(key), hash_fn.GetHash(padded_key));
+  hash_fn.SetKeyLength(8);
+  EXPECT_NE(hash_fn.GetHash(key), hash_fn.GetHash(padded_key));
+}
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, HashBench) {
+  const int num_hashes = 1000000;
+  std::vector<char> bytes(256);
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    bytes[i] = static_cast<char>(i * 37);
+  }
+  auto bench = [num_hashes](const std::function<hash_t(int)> &hash) {
+    hash_t sink = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < num_hashes; ++i) {
+      sink += hash(i);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    EXPECT_NE(0, sink);
+    return std::chrono::duration<double, std::nano>(end - start).count() / num_hashes;
+  };
+
+  for (size_t length : {4, 8, 16, 64, 256}) {
+    double bytes_ns = bench([&bytes, length](int i) {
+      bytes[0] = static_cast<char>(i);
+      return HashUtil::HashBytes(bytes.data(), length);
+    });
+    double murmur_ns = bench([&bytes, length](int i) {
+      bytes[0] = static_cast<char>(i);
+      uint64_t hash[2];
+      murmur3::MurmurHash3_x64_128(bytes.data(), static_cast<int>(length), 0, hash);
+      return hash[0];
+    });
+    double byte_loop_ns = bench([&bytes, length](int i) {
+      // the byte-at-a-time rotate and xor loop HashBytes used to be
+      bytes[0] = static_cast<char>(i);
+      hash_t hash = length;
+      for (size_t j = 0; j < length; ++j) {
+        hash = ((hash << 5) ^ (hash >> 27)) ^ bytes[j];
+      }
+      return hash;
+    });
+    std::cout << "[BENCHMARK: HashUtilTest.HashBench] bytes: " << length << " HashBytes ns: " << bytes_ns
+              << " murmur3 ns: " << murmur_ns << " byte loop ns: " << byte_loop_ns << std::endl;
+  }
+  double int_ns = bench([](int i) {
+    auto key = static_cast<int64_t>(i);
+    return HashUtil::Hash(&key);
+  });
+  std::cout << "[BENCHMARK: HashUtilTest.HashBench] int64 Hash ns: " << int_ns << std::endl;
+}
+
+}  // namespace bustub
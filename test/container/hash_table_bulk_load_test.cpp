@@ -0,0 +1,149 @@
+/**
+ * hash_table_bulk_load_test.cpp
+ */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "container/hash/extendible_hash_table.h"
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using BulkLoadHashTable = ExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>>;
+
+// Every key in [0, num_keys) that is in the table is found by GetValue with its one value, and the directory is
+// consistent.
+void CheckHashTable(BulkLoadHashTable *ht, int64_t num_keys, const std::function<bool(int64_t)> &contains) {
+  CheckIndexKeys(num_keys, contains, [ht](const GenericKey<8> &key, std::vector<RID> *result) {
+    return ht->GetValue(nullptr, key, result);
+  });
+  ht->VerifyIntegrity();
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableBulkLoadTest, BulkLoad) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  const int64_t num_keys = 10000;
+
+  for (double fill_factor : {0.1, 0.5, 0.9, 1.0}) {
+    auto *disk_manager = new DiskManager("bulk_load_test.db");
+    auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+    BulkLoadHashTable ht("bulk_load_index", bpm, comparator, HashFunction<GenericKey<8>>());
+
+    // load the even keys, shuffled and with duplicates
+    std::vector<int64_t> keys;
+    for (int64_t key = 0; key < num_keys; key += 2) {
+      keys.push_back(key);
+      keys.push_back(key);
+    }
+    std::mt19937 rng(0);
+    std::shuffle(keys.begin(), keys.end(), rng);
+    auto items = MakeIndexItems(keys);
+    EXPECT_TRUE(ht.BulkLoad(items.begin(), items.end(), fill_factor));
+    EXPECT_GT(ht.GetGlobalDepth(), 0);
+    CheckHashTable(&ht, num_keys, [](int64_t key) { return key % 2 == 0; });
+
+    // a table with keys can't be bulk loaded again
+    EXPECT_FALSE(ht.BulkLoad(items.begin(), items.end(), fill_factor));
+
+    // the table keeps working for inserts and removes that split and merge its buckets
+    GenericKey<8> index_key;
+    for (int64_t key = 1; key < num_keys; key += 2) {
+      index_key.SetFromInteger(key);
+      EXPECT_TRUE(ht.Insert(nullptr, index_key, RID(0, static_cast<uint32_t>(key))));
+    }
+    for (int64_t key = 0; key < num_keys; key += 3) {
+      index_key.SetFromInteger(key);
+      EXPECT_TRUE(ht.Remove(nullptr, index_key, RID(0, static_cast<uint32_t>(key))));
+    }
+    CheckHashTable(&ht, num_keys, [](int64_t key) { return key % 3 != 0; });
+
+    disk_manager->ShutDown();
+    delete bpm;
+    delete disk_manager;
+    remove("bulk_load_test.db");
+    remove("bulk_load_test.log");
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableBulkLoadTest, SingleBucketAndEmptyInput) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManager("bulk_load_test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  BulkLoadHashTable ht("bulk_load_index", bpm, comparator, HashFunction<GenericKey<8>>());
+
+  std::vector<std::pair<GenericKey<8>, RID>> items;
+  EXPECT_TRUE(ht.BulkLoad(items.begin(), items.end()));
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+
+  items = MakeIndexItems({3, 1, 2});
+  EXPECT_TRUE(ht.BulkLoad(items.begin(), items.end()));
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+  CheckHashTable(&ht, 5, [](int64_t key) { return key >= 1 && key <= 3; });
+
+  disk_manager->ShutDown();
+  delete bpm;
+  delete disk_manager;
+  remove("bulk_load_test.db");
+  remove("bulk_load_test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableBulkLoadTest, BulkLoadBench) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  const int64_t num_keys = 80000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < num_keys; ++key) {
+    keys.push_back(key);
+  }
+  std::mt19937 rng(0);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  auto items = MakeIndexItems(keys);
+
+  double seconds[2];
+  for (int bulk = 0; bulk < 2; ++bulk) {
+    auto *disk_manager = new DiskManager("bulk_load_test.db");
+    auto *bpm = new BufferPoolManagerInstance(1024, disk_manager);
+    BulkLoadHashTable ht("bulk_load_index", bpm, comparator, HashFunction<GenericKey<8>>());
+
+    auto start = std::chrono::high_resolution_clock::now();
+    if (bulk == 1) {
+      ht.BulkLoad(items.begin(), items.end());
+    } else {
+      for (const auto &[index_key, rid] : items) {
+        ht.Insert(nullptr, index_key, rid);
+      }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    seconds[bulk] = std::chrono::duration<double>(end - start).count();
+
+    GenericKey<8> index_key;
+    std::vector<RID> result;
+    index_key.SetFromInteger(num_keys / 2);
+    EXPECT_TRUE(ht.GetValue(nullptr, index_key, &result));
+
+    disk_manager->ShutDown();
+    delete bpm;
+    delete disk_manager;
+    remove("bulk_load_test.db");
+    remove("bulk_load_test.log");
+  }
+
+  std::cout << "[BENCHMARK: HashTableBulkLoadTest.BulkLoadBench] keys: " << num_keys
+            << " insert one by one: " << seconds[0] << "s bulk load: " << seconds[1] << "s" << std::endl;
+}
+
+}  // namespace bustub
@@ -0,0 +1,99 @@
+/**
+ * hash_table_concurrent_bench_test.cpp
+ */
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "container/hash/extendible_hash_table.h"
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using BenchHashTable = ExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>>;
+
+const int64_t HASH_BENCH_PRELOAD_KEYS = 20000;
+const int64_t HASH_BENCH_NUM_OPS = 128000;
+const std::vector<size_t> HASH_BENCH_THREAD_COUNTS = {1, 2, 4, 8, 16};
+
+double RunHashBenchThreads(size_t num_threads, const std::function<void(size_t)> &task) {
+  std::vector<std::thread> threads;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads.emplace_back(task, i);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+// Ingest while reading: one in four operations inserts a new key, which keeps buckets splitting, and the rest look up
+// a preloaded key. The pool holds the whole table, so the numbers measure latching rather than disk I/O.
+// NOLINTNEXTLINE
+TEST(HashTableConcurrentBench, InsertLookupScaling) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  for (size_t num_threads : HASH_BENCH_THREAD_COUNTS) {
+    auto *disk_manager = new DiskManager("hash_bench.db");
+    auto *bpm = new BufferPoolManagerInstance(1024, disk_manager);
+    BenchHashTable ht("hash_bench", bpm, comparator, HashFunction<GenericKey<8>>());
+    GenericKey<8> index_key;
+    for (int64_t key = 0; key < HASH_BENCH_PRELOAD_KEYS; ++key) {
+      index_key.SetFromInteger(key);
+      ht.Insert(nullptr, index_key, RID(0, key));
+    }
+
+    std::atomic<int64_t> num_found = 0;
+    std::atomic<int64_t> num_inserted = 0;
+    double seconds = RunHashBenchThreads(num_threads, [&](size_t thread_itr) {
+      std::mt19937 thread_rng(thread_itr);
+      std::uniform_int_distribution<int64_t> any(0, HASH_BENCH_PRELOAD_KEYS - 1);
+      GenericKey<8> thread_key;
+      std::vector<RID> result;
+      int64_t found = 0;
+      int64_t inserted = 0;
+      for (int64_t i = thread_itr; i < HASH_BENCH_NUM_OPS; i += num_threads) {
+        if (i % 4 == 0) {
+          int64_t key = HASH_BENCH_PRELOAD_KEYS + i;
+          thread_key.SetFromInteger(key);
+          inserted += ht.Insert(nullptr, thread_key, RID(0, key)) ? 1 : 0;
+          continue;
+        }
+        int64_t key = any(thread_rng);
+        thread_key.SetFromInteger(key);
+        result.clear();
+        if (ht.GetValue(nullptr, thread_key, &result) && result[0].GetSlotNum() == static_cast<uint32_t>(key)) {
+          ++found;
+        }
+      }
+      num_found += found;
+      num_inserted += inserted;
+    });
+    EXPECT_EQ(HASH_BENCH_NUM_OPS / 4, num_inserted);
+    EXPECT_EQ(HASH_BENCH_NUM_OPS - HASH_BENCH_NUM_OPS / 4, num_found);
+    ht.VerifyIntegrity();
+
+    std::cout << "[BENCHMARK: HashTableConcurrentBench.InsertLookupScaling] threads: " << num_threads
+              << " ops/s: " << static_cast<uint64_t>(HASH_BENCH_NUM_OPS / seconds) << std::endl;
+
+    disk_manager->ShutDown();
+    delete bpm;
+    delete disk_manager;
+    remove("hash_bench.db");
+    remove("hash_bench.log");
+  }
+}
+
+}  // namespace bustub
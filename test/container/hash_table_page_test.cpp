@@ -17,8 +17,12 @@
 #include "common/logger.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/index/generic_key.h"
+#include "storage/page/hash_table_block_page.h"
 #include "storage/page/hash_table_bucket_page.h"
 #include "storage/page/hash_table_directory_page.h"
+#include "storage/page/hash_table_header_page.h"
+#include "test_util.h"  // NOLINT
 
 namespace bustub {
 
@@ -56,6 +60,99 @@ TEST(HashTablePageTest, DirectoryPageSampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, HeaderPageSampleTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
+
+  // get a header page from the BufferPoolManager
+  page_id_t header_page_id = INVALID_PAGE_ID;
+  auto header_page = reinterpret_cast<HashTableHeaderPage *>(bpm->NewPage(&header_page_id, nullptr)->GetData());
+
+  // set some fields
+  for (int i = 0; i < 11; i++) {
+    header_page->SetSize(i);
+    EXPECT_EQ(i, header_page->GetSize());
+    header_page->SetPageId(i);
+    EXPECT_EQ(i, header_page->GetPageId());
+    header_page->SetLSN(i);
+    EXPECT_EQ(i, header_page->GetLSN());
+  }
+
+  // add a few hypothetical block pages, up to as many as fit into the page
+  for (unsigned i = 0; i < HEADER_BLOCK_ARRAY_SIZE; i++) {
+    header_page->AddBlockPageId(i);
+    EXPECT_EQ(i + 1, header_page->NumBlocks());
+  }
+
+  // check for correct block page IDs
+  for (unsigned i = 0; i < HEADER_BLOCK_ARRAY_SIZE; i++) {
+    EXPECT_EQ(i, header_page->GetBlockPageId(i));
+  }
+  EXPECT_EQ(10, header_page->GetSize());
+
+  // unpin the header page now that we are done
+  bpm->UnpinPage(header_page_id, true, nullptr);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, BlockPageSampleTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
+
+  // get a block page from the BufferPoolManager
+  page_id_t block_page_id = INVALID_PAGE_ID;
+
+  auto block_page =
+      reinterpret_cast<HashTableBlockPage<int, int, IntComparator> *>(bpm->NewPage(&block_page_id, nullptr)->GetData());
+
+  // insert a few (key, value) pairs
+  for (unsigned i = 0; i < 10; i++) {
+    EXPECT_TRUE(block_page->Insert(i, i, i));
+  }
+  // an index can only be claimed once
+  EXPECT_FALSE(block_page->Insert(3, 100, 100));
+
+  // check for the inserted pairs
+  for (unsigned i = 0; i < 10; i++) {
+    EXPECT_EQ(i, block_page->KeyAt(i));
+    EXPECT_EQ(i, block_page->ValueAt(i));
+  }
+
+  // remove a few pairs
+  for (unsigned i = 0; i < 10; i++) {
+    if (i % 2 == 1) {
+      block_page->Remove(i);
+    }
+  }
+  EXPECT_EQ(5, block_page->NumReadable());
+
+  // check for the flags
+  for (unsigned i = 0; i < 15; i++) {
+    if (i < 10) {
+      EXPECT_TRUE(block_page->IsOccupied(i));
+      if (i % 2 == 1) {
+        EXPECT_FALSE(block_page->IsReadable(i));
+      } else {
+        EXPECT_TRUE(block_page->IsReadable(i));
+      }
+    } else {
+      EXPECT_FALSE(block_page->IsOccupied(i));
+    }
+  }
+
+  // unpin the block page now that we are done
+  bpm->UnpinPage(block_page_id, true, nullptr);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 // NOLINTNEXTLINE
 TEST(HashTablePageTest, BucketPageSampleTest) {
   DiskManager *disk_manager = new DiskManager("test.db");
@@ -114,4 +211,73 @@ TEST(HashTablePageTest, BucketPageSampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, BucketPageFingerprintTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  using BucketPage = HashTableBucketPage<GenericKey<8>, RID, GenericComparator<8>>;
+  using Mapping = std::pair<GenericKey<8>, RID>;
+  const auto bucket_size = static_cast<int64_t>(4 * (PAGE_SIZE - 32) / (4 * sizeof(Mapping) + 5));
+  EXPECT_LE(sizeof(BucketPage) + bucket_size * sizeof(Mapping), static_cast<size_t>(PAGE_SIZE));
+
+  page_id_t bucket_page_id = INVALID_PAGE_ID;
+  auto bucket_page = reinterpret_cast<BucketPage *>(bpm->NewPage(&bucket_page_id, nullptr)->GetData());
+  EXPECT_TRUE(bucket_page->IsEmpty());
+
+  // every key appears twice with different values
+  GenericKey<8> index_key;
+  for (int64_t i = 0; i < bucket_size; i++) {
+    index_key.SetFromInteger(i / 2);
+    EXPECT_TRUE(bucket_page->Insert(index_key, RID(0, i), comparator));
+  }
+  EXPECT_TRUE(bucket_page->IsFull());
+  EXPECT_EQ(bucket_size, bucket_page->NumReadable());
+  index_key.SetFromInteger(0);
+  EXPECT_FALSE(bucket_page->Insert(index_key, RID(0, 0), comparator));
+  index_key.SetFromInteger(bucket_size);
+  EXPECT_FALSE(bucket_page->Insert(index_key, RID(0, 0), comparator));
+  for (int64_t i = 0; i < bucket_size; i += 2) {
+    index_key.SetFromInteger(i / 2);
+    std::vector<RID> result;
+    EXPECT_TRUE(bucket_page->GetValue(index_key, comparator, &result));
+    std::vector<RID> expected = {RID(0, i)};
+    if (i + 1 < bucket_size) {
+      expected.emplace_back(0, i + 1);
+    }
+    EXPECT_EQ(expected, result);
+  }
+  std::vector<RID> result;
+  index_key.SetFromInteger(bucket_size);
+  EXPECT_FALSE(bucket_page->GetValue(index_key, comparator, &result));
+
+  // a removed slot is reused by the next insert, wherever it is
+  index_key.SetFromInteger(3);
+  EXPECT_FALSE(bucket_page->Remove(index_key, RID(0, 8), comparator));
+  EXPECT_TRUE(bucket_page->Remove(index_key, RID(0, 7), comparator));
+  index_key.SetFromInteger((bucket_size - 1) / 2);
+  EXPECT_TRUE(bucket_page->Remove(index_key, RID(0, bucket_size - 1), comparator));
+  EXPECT_EQ(bucket_size - 2, bucket_page->NumReadable());
+  index_key.SetFromInteger(bucket_size);
+  EXPECT_TRUE(bucket_page->Insert(index_key, RID(0, 0), comparator));
+  EXPECT_EQ(0, comparator(index_key, bucket_page->KeyAt(7)));
+  index_key.SetFromInteger(bucket_size + 1);
+  EXPECT_TRUE(bucket_page->Insert(index_key, RID(0, 0), comparator));
+  EXPECT_TRUE(bucket_page->IsFull());
+  EXPECT_TRUE(bucket_page->GetValue(index_key, comparator, &result));
+
+  for (int64_t i = 0; i < bucket_size; i++) {
+    bucket_page->RemoveAt(i);
+  }
+  EXPECT_TRUE(bucket_page->IsEmpty());
+  EXPECT_EQ(0, bucket_page->NumReadable());
+
+  bpm->UnpinPage(bucket_page_id, true, nullptr);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
@@ -0,0 +1,328 @@
+/**
+ * linear_probe_hash_table_test.cpp
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "container/hash/extendible_hash_table.h"
+#include "container/hash/linear_probe_hash_table.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/generic_key.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using ProbeHashTable = LinearProbeHashTable<GenericKey<8>, RID, GenericComparator<8>>;
+
+void CheckProbeHashTable(ProbeHashTable *ht, int64_t num_keys, const std::function<bool(int64_t)> &contains) {
+  CheckIndexKeys(num_keys, contains, [ht](const GenericKey<8> &key, std::vector<RID> *result) {
+    return ht->GetValue(nullptr, key, result);
+  });
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, SampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 1000, HashFunction<int>());
+
+  // insert a few values
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(1, res.size()) << "Failed to insert " << i << std::endl;
+    EXPECT_EQ(i, res[0]);
+  }
+
+  // insert one more value for each key
+  for (int i = 0; i < 5; i++) {
+    if (i == 0) {
+      // duplicate values for the same key are not allowed
+      EXPECT_FALSE(ht.Insert(nullptr, i, 2 * i));
+    } else {
+      EXPECT_TRUE(ht.Insert(nullptr, i, 2 * i));
+    }
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    if (i == 0) {
+      EXPECT_EQ(1, res.size());
+      EXPECT_EQ(i, res[0]);
+    } else {
+      EXPECT_EQ(2, res.size());
+      EXPECT_NE(res[0], res[1]);
+    }
+  }
+
+  // look for a key that does not exist
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 20, &res));
+  EXPECT_EQ(0, res.size());
+
+  // delete some values
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    std::vector<int> res;
+    if (i == 0) {
+      // (0, 0) is the only pair with key 0
+      EXPECT_FALSE(ht.GetValue(nullptr, i, &res));
+    } else {
+      EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+      EXPECT_EQ(1, res.size());
+      EXPECT_EQ(2 * i, res[0]);
+    }
+    // a removed pair can't be removed again
+    EXPECT_FALSE(ht.Remove(nullptr, i, i));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, IncrementalResize) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  ProbeHashTable ht("probe_index", bpm, comparator, 10, HashFunction<GenericKey<8>>());
+  size_t initial_size = ht.GetSize();
+
+  // the table grows a block at a time, and every pair stays visible while it does
+  const int64_t num_keys = 5000;
+  GenericKey<8> index_key;
+  bool resized = false;
+  for (int64_t key = 0; key < num_keys; ++key) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(ht.Insert(nullptr, index_key, RID(0, key)));
+    if (ht.IsResizing()) {
+      resized = true;
+      CheckProbeHashTable(&ht, key + 2, [key](int64_t k) { return k <= key; });
+      // a pair still in the old table is not inserted again
+      index_key.SetFromInteger(0);
+      EXPECT_FALSE(ht.Insert(nullptr, index_key, RID(0, 0)));
+    }
+  }
+  EXPECT_TRUE(resized);
+  EXPECT_GT(ht.GetSize(), initial_size);
+  CheckProbeHashTable(&ht, num_keys, [](int64_t key) { return true; });
+
+  // removes during a resize find the pairs in either table
+  ht.Resize(ht.GetSize());
+  EXPECT_TRUE(ht.IsResizing());
+  for (int64_t key = 0; key < num_keys; key += 2) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(ht.Remove(nullptr, index_key, RID(0, key)));
+  }
+  EXPECT_FALSE(ht.IsResizing());
+  CheckProbeHashTable(&ht, num_keys, [](int64_t key) { return key % 2 == 1; });
+
+  // the tombstones are cleared out by rebuilding the table rather than growing it
+  size_t size = ht.GetSize();
+  for (int round = 0; round < 4; ++round) {
+    for (int64_t key = 0; key < num_keys; key += 2) {
+      index_key.SetFromInteger(key);
+      EXPECT_TRUE(ht.Insert(nullptr, index_key, RID(0, key)));
+    }
+    for (int64_t key = 0; key < num_keys; key += 2) {
+      index_key.SetFromInteger(key);
+      EXPECT_TRUE(ht.Remove(nullptr, index_key, RID(0, key)));
+    }
+  }
+  EXPECT_EQ(size, ht.GetSize());
+  CheckProbeHashTable(&ht, num_keys, [](int64_t key) { return key % 2 == 1; });
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, ConcurrentLookupsDuringResize) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  ProbeHashTable ht("probe_index", bpm, comparator, 10, HashFunction<GenericKey<8>>());
+  const int64_t num_preloaded = 1000;
+  const int64_t num_keys = 4000;
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < num_preloaded; ++key) {
+    index_key.SetFromInteger(key);
+    ht.Insert(nullptr, index_key, RID(0, key));
+  }
+
+  // the preloaded keys are found all the while the writer grows the table
+  std::atomic<bool> done = false;
+  std::atomic<int64_t> num_missed = 0;
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 2; ++i) {
+    readers.emplace_back([&, i] {
+      std::mt19937 rng(i);
+      std::uniform_int_distribution<int64_t> any(0, num_preloaded - 1);
+      GenericKey<8> thread_key;
+      std::vector<RID> result;
+      while (!done) {
+        thread_key.SetFromInteger(any(rng));
+        result.clear();
+        if (!ht.GetValue(nullptr, thread_key, &result)) {
+          ++num_missed;
+        }
+      }
+    });
+  }
+  for (int64_t key = num_preloaded; key < num_keys; ++key) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(ht.Insert(nullptr, index_key, RID(0, key)));
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(0, num_missed);
+  CheckProbeHashTable(&ht, num_keys, [](int64_t key) { return true; });
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, PinnedBufferPool) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(10, disk_manager);
+  ProbeHashTable ht("probe_index", bpm, comparator, 10, HashFunction<GenericKey<8>>());
+  const int64_t num_keys = 100;
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < num_keys; ++key) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(ht.Insert(nullptr, index_key, RID(0, key)));
+  }
+  ht.Resize(ht.GetSize());
+  EXPECT_TRUE(ht.IsResizing());
+
+  // with every frame pinned, no page of the table can be fetched and every operation fails
+  std::vector<page_id_t> pinned_page_ids;
+  page_id_t page_id;
+  while (bpm->NewPage(&page_id) != nullptr) {
+    pinned_page_ids.push_back(page_id);
+  }
+  std::vector<RID> result;
+  index_key.SetFromInteger(0);
+  EXPECT_FALSE(ht.GetValue(nullptr, index_key, &result));
+  EXPECT_FALSE(ht.Remove(nullptr, index_key, RID(0, 0)));
+  index_key.SetFromInteger(num_keys);
+  EXPECT_FALSE(ht.Insert(nullptr, index_key, RID(0, num_keys)));
+  EXPECT_EQ(0, ht.GetSize());
+  EXPECT_TRUE(ht.IsResizing());
+
+  // once the frames are free again, no pair was lost and the resize goes on
+  for (auto pinned_page_id : pinned_page_ids) {
+    EXPECT_TRUE(bpm->UnpinPage(pinned_page_id, false));
+    EXPECT_TRUE(bpm->DeletePage(pinned_page_id));
+  }
+  CheckProbeHashTable(&ht, num_keys, [](int64_t key) { return true; });
+  for (int64_t key = num_keys; key < 2 * num_keys; ++key) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(ht.Insert(nullptr, index_key, RID(0, key)));
+  }
+  EXPECT_FALSE(ht.IsResizing());
+  CheckProbeHashTable(&ht, 2 * num_keys, [](int64_t key) { return true; });
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// Point lookups of existing keys against the linear probe hash table, the extendible hash table and the B+ tree, each
+// loaded with the same keys into a pool that holds all of it.
+// NOLINTNEXTLINE
+TEST(LinearProbeHashTableTest, LookupBench) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  const int64_t num_keys = 20000;
+  const int64_t num_lookups = 100000;
+  std::vector<int64_t> lookups(num_lookups);
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<int64_t> any(0, num_keys - 1);
+  for (auto &key : lookups) {
+    key = any(rng);
+  }
+
+  auto bench = [&](const std::function<void(const GenericKey<8> &, const RID &)> &insert,
+                   const std::function<bool(const GenericKey<8> &, std::vector<RID> *)> &get_value) {
+    GenericKey<8> index_key;
+    for (int64_t key = 0; key < num_keys; ++key) {
+      index_key.SetFromInteger(key);
+      insert(index_key, RID(0, key));
+    }
+    std::vector<RID> result;
+    int64_t num_found = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (auto key : lookups) {
+      index_key.SetFromInteger(key);
+      result.clear();
+      num_found += get_value(index_key, &result) ? 1 : 0;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    EXPECT_EQ(num_lookups, num_found);
+    return std::chrono::duration<double, std::nano>(end - start).count() / num_lookups;
+  };
+
+  double ns[3];
+  for (int kind = 0; kind < 3; ++kind) {
+    auto *disk_manager = new DiskManager("lookup_bench.db");
+    auto *bpm = new BufferPoolManagerInstance(1024, disk_manager);
+    if (kind == 0) {
+      ProbeHashTable ht("probe_index", bpm, comparator, 1000, HashFunction<GenericKey<8>>());
+      ns[kind] = bench([&ht](const GenericKey<8> &key, const RID &rid) { ht.Insert(nullptr, key, rid); },
+                       [&ht](const GenericKey<8> &key, std::vector<RID> *result) {
+                         return ht.GetValue(nullptr, key, result);
+                       });
+    } else if (kind == 1) {
+      ExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>> ht("extendible_index", bpm, comparator,
+                                                                      HashFunction<GenericKey<8>>());
+      ns[kind] = bench([&ht](const GenericKey<8> &key, const RID &rid) { ht.Insert(nullptr, key, rid); },
+                       [&ht](const GenericKey<8> &key, std::vector<RID> *result) {
+                         return ht.GetValue(nullptr, key, result);
+                       });
+    } else {
+      page_id_t header_page_id;
+      bpm->NewPage(&header_page_id);
+      BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("tree_index", bpm, comparator);
+      Transaction transaction(0);
+      ns[kind] = bench([&](const GenericKey<8> &key, const RID &rid) { tree.Insert(key, rid, &transaction); },
+                       [&tree](const GenericKey<8> &key, std::vector<RID> *result) {
+                         return tree.GetValue(key, result);
+                       });
+      bpm->UnpinPage(header_page_id, true);
+    }
+    disk_manager->ShutDown();
+    delete bpm;
+    delete disk_manager;
+    remove("lookup_bench.db");
+    remove("lookup_bench.log");
+  }
+
+  std::cout << "[BENCHMARK: LinearProbeHashTableTest.LookupBench] keys: " << num_keys << " linear probe ns: " << ns[0]
+            << " extendible ns: " << ns[1] << " b+ tree ns: " << ns[2] << std::endl;
+}
+
+}  // namespace bustub
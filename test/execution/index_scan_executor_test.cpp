@@ -0,0 +1,177 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_scan_executor_test.cpp
+//
+// Identification: test/execution/index_scan_executor_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "execution/plans/index_scan_plan.h"
+#include "executor_test_util.h"  // NOLINT
+#include "test_util.h"           // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+using KeyType = GenericKey<8>;
+using ValueType = RID;
+using ComparatorType = GenericComparator<8>;
+using HashFunctionType = HashFunction<KeyType>;
+
+/** Run the plan and return the value of the given output column in every result tuple. */
+std::vector<int32_t> ScanColumn(ExecutorTest *test, const AbstractPlanNode *plan, const std::string &col_name) {
+  std::vector<Tuple> result_set{};
+  test->GetExecutionEngine()->Execute(plan, &result_set, test->GetTxn(), test->GetExecutorContext());
+  const Schema *out_schema = plan->OutputSchema();
+  std::vector<int32_t> values;
+  for (const auto &tuple : result_set) {
+    values.push_back(tuple.GetValue(out_schema, out_schema->GetColIdx(col_name)).GetAs<int32_t>());
+  }
+  return values;
+}
+
+// SELECT colA, colB FROM test_1 WHERE colA <cmp> <value>, through a B+ tree index on colA
+TEST_F(ExecutorTest, IndexScanRangeTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto key_schema = ParseCreateStatement("colA integer");
+  auto *index_info = GetExecutorContext()->GetCatalog()->CreateIndex<KeyType, ValueType, ComparatorType>(
+      GetTxn(), "index_a", "test_1", schema, *key_schema, {0}, 8, HashFunctionType{}, IndexType::BPlusTree);
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *out_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+
+  // colA holds 0..999 in insertion order
+  std::vector<int32_t> all(TEST1_SIZE);
+  for (size_t i = 0; i < all.size(); ++i) {
+    all[i] = static_cast<int32_t>(i);
+  }
+  IndexScanPlanNode full_plan{out_schema, nullptr, index_info->index_oid_};
+  EXPECT_EQ(all, ScanColumn(this, &full_plan, "colA"));
+  std::vector<int32_t> all_descending(all.rbegin(), all.rend());
+  IndexScanPlanNode full_descending_plan{out_schema, nullptr, index_info->index_oid_, true};
+  EXPECT_EQ(all_descending, ScanColumn(this, &full_descending_plan, "colA"));
+
+  struct Case {
+    ComparisonType comp_type_;
+    int32_t value_;
+    std::function<bool(int32_t)> matches_;
+  };
+  std::vector<Case> cases = {
+      {ComparisonType::Equal, 500, [](int32_t a) { return a == 500; }},
+      {ComparisonType::Equal, 5000, [](int32_t a) { return a == 5000; }},
+      {ComparisonType::LessThan, 100, [](int32_t a) { return a < 100; }},
+      {ComparisonType::LessThanOrEqual, 100, [](int32_t a) { return a <= 100; }},
+      {ComparisonType::GreaterThan, 900, [](int32_t a) { return a > 900; }},
+      {ComparisonType::GreaterThanOrEqual, 900, [](int32_t a) { return a >= 900; }},
+      {ComparisonType::NotEqual, 3, [](int32_t a) { return a != 3; }},
+      {ComparisonType::GreaterThan, -5, [](int32_t a) { return a > -5; }},
+  };
+  for (const auto &test_case : cases) {
+    std::vector<int32_t> expected;
+    std::copy_if(all.begin(), all.end(), std::back_inserter(expected), test_case.matches_);
+    std::vector<int32_t> expected_descending(expected.rbegin(), expected.rend());
+    auto *constant = MakeConstantValueExpression(ValueFactory::GetIntegerValue(test_case.value_));
+    auto *predicate = MakeComparisonExpression(col_a, constant, test_case.comp_type_);
+    IndexScanPlanNode plan{out_schema, predicate, index_info->index_oid_};
+    EXPECT_EQ(expected, ScanColumn(this, &plan, "colA"));
+    IndexScanPlanNode descending_plan{out_schema, predicate, index_info->index_oid_, true};
+    EXPECT_EQ(expected_descending, ScanColumn(this, &descending_plan, "colA"));
+  }
+
+  // 100 > colA is colA < 100, and a BIGINT constant is compared as an INTEGER
+  auto *constant = MakeConstantValueExpression(ValueFactory::GetBigIntValue(100));
+  auto *predicate = MakeComparisonExpression(constant, col_a, ComparisonType::GreaterThan);
+  IndexScanPlanNode flipped_plan{out_schema, predicate, index_info->index_oid_};
+  EXPECT_EQ(std::vector<int32_t>(all.begin(), all.begin() + 100), ScanColumn(this, &flipped_plan, "colA"));
+
+  // a predicate on another column is only checked against the tuples
+  auto *constant_b = MakeConstantValueExpression(ValueFactory::GetIntegerValue(3));
+  auto *predicate_b = MakeComparisonExpression(col_b, constant_b, ComparisonType::Equal);
+  IndexScanPlanNode other_plan{out_schema, predicate_b, index_info->index_oid_};
+  std::vector<int32_t> values_b = ScanColumn(this, &other_plan, "colB");
+  EXPECT_FALSE(values_b.empty());
+  EXPECT_TRUE(std::all_of(values_b.begin(), values_b.end(), [](int32_t b) { return b == 3; }));
+}
+
+// SELECT colA, colB FROM test_1 WHERE colB = 7, through indexes on colB, which has many duplicates
+TEST_F(ExecutorTest, IndexScanDuplicateKeyTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto key_schema = ParseCreateStatement("colB integer");
+  auto *tree_info = GetExecutorContext()->GetCatalog()->CreateIndex<KeyType, ValueType, ComparatorType>(
+      GetTxn(), "tree_b", "test_1", schema, *key_schema, {1}, 8, HashFunctionType{}, IndexType::BPlusTree);
+  auto *hash_info = GetExecutorContext()->GetCatalog()->CreateIndex<KeyType, ValueType, ComparatorType>(
+      GetTxn(), "hash_b", "test_1", schema, *key_schema, {1}, 8, HashFunctionType{});
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *out_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+  auto *constant = MakeConstantValueExpression(ValueFactory::GetIntegerValue(7));
+  auto *predicate = MakeComparisonExpression(col_b, constant, ComparisonType::Equal);
+
+  SeqScanPlanNode seq_plan{out_schema, predicate, table_info->oid_};
+  std::vector<int32_t> expected = ScanColumn(this, &seq_plan, "colA");
+  std::sort(expected.begin(), expected.end());
+  ASSERT_FALSE(expected.empty());
+
+  for (auto *index_info : {tree_info, hash_info}) {
+    IndexScanPlanNode plan{out_schema, predicate, index_info->index_oid_};
+    std::vector<int32_t> values = ScanColumn(this, &plan, "colA");
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(expected, values);
+  }
+
+  // a hash index can't serve a range
+  auto *range = MakeComparisonExpression(col_b, constant, ComparisonType::LessThan);
+  IndexScanPlanNode range_plan{out_schema, range, hash_info->index_oid_};
+  std::vector<Tuple> result_set{};
+  EXPECT_THROW(GetExecutionEngine()->Execute(&range_plan, &result_set, GetTxn(), GetExecutorContext()),
+               NotImplementedException);
+
+  // the B+ tree returns the other values of colB in order
+  IndexScanPlanNode tree_plan{out_schema, range, tree_info->index_oid_};
+  std::vector<int32_t> values_b = ScanColumn(this, &tree_plan, "colB");
+  EXPECT_TRUE(std::is_sorted(values_b.begin(), values_b.end()));
+  EXPECT_TRUE(std::all_of(values_b.begin(), values_b.end(), [](int32_t b) { return b < 7; }));
+}
+
+// DELETE FROM test_1 WHERE colA < 600, with an index scan on colA as the child that the delete shrinks as it goes
+TEST_F(ExecutorTest, IndexScanDeleteTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto key_schema = ParseCreateStatement("colA integer");
+  auto *index_info = GetExecutorContext()->GetCatalog()->CreateIndex<KeyType, ValueType, ComparatorType>(
+      GetTxn(), "index_a", "test_1", schema, *key_schema, {0}, 8, HashFunctionType{}, IndexType::BPlusTree);
+  // the delete builds index keys from the child's tuples, so the scan outputs every column
+  std::vector<std::pair<std::string, const AbstractExpression *>> columns;
+  for (uint32_t i = 0; i < schema.GetColumnCount(); ++i) {
+    const std::string &col_name = schema.GetColumn(i).GetName();
+    columns.emplace_back(col_name, MakeColumnValueExpression(schema, 0, col_name));
+  }
+  auto *out_schema = MakeOutputSchema(columns);
+  auto *constant = MakeConstantValueExpression(ValueFactory::GetIntegerValue(600));
+  auto *predicate = MakeComparisonExpression(columns[0].second, constant, ComparisonType::LessThan);
+
+  // deleting most of the keys merges the leaves the scan walks through
+  IndexScanPlanNode scan_plan{out_schema, predicate, index_info->index_oid_};
+  DeletePlanNode delete_plan{&scan_plan, table_info->oid_};
+  GetExecutionEngine()->Execute(&delete_plan, nullptr, GetTxn(), GetExecutorContext());
+
+  EXPECT_TRUE(ScanColumn(this, &scan_plan, "colA").empty());
+  std::vector<int32_t> rest(TEST1_SIZE - 600);
+  for (size_t i = 0; i < rest.size(); ++i) {
+    rest[i] = static_cast<int32_t>(600 + i);
+  }
+  IndexScanPlanNode full_plan{out_schema, nullptr, index_info->index_oid_};
+  EXPECT_EQ(rest, ScanColumn(this, &full_plan, "colA"));
+}
+
+}  // namespace bustub
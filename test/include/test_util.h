@@ -15,15 +15,20 @@
 #include <sys/stat.h>
 #include <algorithm>
 #include <cstring>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "catalog/schema.h"
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/rid.h"
 #include "common/util/string_util.h"
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
 #include "storage/page/header_page.h"
 
 namespace bustub {
@@ -92,4 +97,32 @@ std::unique_ptr<Schema> ParseCreateStatement(const std::string &sql_base) {
   return std::make_unique<Schema>(v);
 }
 
+// The (key, value) pairs to bulk load an index with the given keys. The value of a key is the RID made of its upper and
+// lower 32 bits, so its slot number is the key for any key below 2^32.
+std::vector<std::pair<GenericKey<8>, RID>> MakeIndexItems(const std::vector<int64_t> &keys) {
+  std::vector<std::pair<GenericKey<8>, RID>> items(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    items[i].first.SetFromInteger(keys[i]);
+    items[i].second.Set(static_cast<int32_t>(keys[i] >> 32), keys[i] & 0xFFFFFFFF);
+  }
+  return items;
+}
+
+// Every key in [0, num_keys) that is in the index is found by get_value with its one value, whose slot number is the
+// key, and every other key is not found.
+void CheckIndexKeys(int64_t num_keys, const std::function<bool(int64_t)> &contains,
+                    const std::function<bool(const GenericKey<8> &, std::vector<RID> *)> &get_value) {
+  GenericKey<8> index_key;
+  std::vector<RID> result;
+  for (int64_t key = 0; key < num_keys; ++key) {
+    index_key.SetFromInteger(key);
+    result.clear();
+    EXPECT_EQ(contains(key), get_value(index_key, &result)) << key;
+    if (contains(key)) {
+      ASSERT_EQ(1, result.size());
+      EXPECT_EQ(key, result[0].GetSlotNum());
+    }
+  }
+}
+
 }  // namespace bustub
@@ -0,0 +1,164 @@
+/**
+ * b_plus_tree_bulk_load_test.cpp
+ */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using BulkLoadTree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+// Every key in [0, num_keys) that is in the tree is found by GetValue, and the iterator returns exactly these keys in
+// order.
+void CheckTree(BulkLoadTree *tree, int64_t num_keys, const std::function<bool(int64_t)> &contains) {
+  CheckIndexKeys(num_keys, contains,
+                 [tree](const GenericKey<8> &key, std::vector<RID> *result) { return tree->GetValue(key, result); });
+  std::vector<int64_t> expected;
+  for (int64_t key = 0; key < num_keys; ++key) {
+    if (contains(key)) {
+      expected.push_back(key);
+    }
+  }
+  size_t i = 0;
+  for (auto iterator = tree->Begin(); iterator != tree->End(); ++iterator, ++i) {
+    ASSERT_LT(i, expected.size());
+    EXPECT_EQ(expected[i], (*iterator).first.ToString());
+  }
+  EXPECT_EQ(expected.size(), i);
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeBulkLoadTest, SmallPages) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  const int64_t num_keys = 1000;
+
+  for (double fill_factor : {0.1, 0.5, 0.9, 1.0}) {
+    DiskManager *disk_manager = new DiskManager("bulk_load_test.db");
+    BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+    page_id_t header_page_id;
+    bpm->NewPage(&header_page_id);
+    BulkLoadTree tree("bulk_load_index", bpm, comparator, 5, 5);
+    Transaction transaction(0);
+
+    // load the even keys, shuffled and with duplicates
+    std::vector<int64_t> keys;
+    for (int64_t key = 0; key < num_keys; key += 2) {
+      keys.push_back(key);
+      keys.push_back(key);
+    }
+    std::mt19937 rng(0);
+    std::shuffle(keys.begin(), keys.end(), rng);
+    auto items = MakeIndexItems(keys);
+    EXPECT_TRUE(tree.BulkLoad(items.begin(), items.end(), fill_factor));
+    CheckTree(&tree, num_keys, [](int64_t key) { return key % 2 == 0; });
+
+    // a tree with keys can't be bulk loaded again
+    EXPECT_FALSE(tree.BulkLoad(items.begin(), items.end(), fill_factor));
+
+    // the tree keeps working for inserts and removes that split and merge its pages
+    GenericKey<8> index_key;
+    for (int64_t key = 1; key < num_keys; key += 2) {
+      index_key.SetFromInteger(key);
+      EXPECT_TRUE(tree.Insert(index_key, RID(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF), &transaction));
+    }
+    for (int64_t key = 0; key < num_keys; key += 3) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, &transaction);
+    }
+    CheckTree(&tree, num_keys, [](int64_t key) { return key % 3 != 0; });
+
+    bpm->UnpinPage(header_page_id, true);
+    delete bpm;
+    delete disk_manager;
+    remove("bulk_load_test.db");
+    remove("bulk_load_test.log");
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeBulkLoadTest, SingleLeafAndEmptyInput) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  DiskManager *disk_manager = new DiskManager("bulk_load_test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  BulkLoadTree tree("bulk_load_index", bpm, comparator);
+
+  std::vector<std::pair<GenericKey<8>, RID>> items;
+  EXPECT_TRUE(tree.BulkLoad(items.begin(), items.end()));
+  EXPECT_TRUE(tree.IsEmpty());
+
+  items = MakeIndexItems({3, 1, 2});
+  EXPECT_TRUE(tree.BulkLoad(items.begin(), items.end()));
+  CheckTree(&tree, 5, [](int64_t key) { return key >= 1 && key <= 3; });
+
+  bpm->UnpinPage(header_page_id, true);
+  delete bpm;
+  delete disk_manager;
+  remove("bulk_load_test.db");
+  remove("bulk_load_test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeBulkLoadTest, BulkLoadBench) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  const int64_t num_keys = 200000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < num_keys; ++key) {
+    keys.push_back(key);
+  }
+  std::mt19937 rng(0);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  auto items = MakeIndexItems(keys);
+
+  double seconds[2];
+  for (int bulk = 0; bulk < 2; ++bulk) {
+    DiskManager *disk_manager = new DiskManager("bulk_load_test.db");
+    BufferPoolManager *bpm = new BufferPoolManagerInstance(4096, disk_manager);
+    page_id_t header_page_id;
+    bpm->NewPage(&header_page_id);
+    BulkLoadTree tree("bulk_load_index", bpm, comparator);
+    Transaction transaction(0);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    if (bulk == 1) {
+      tree.BulkLoad(items.begin(), items.end());
+    } else {
+      for (const auto &[index_key, rid] : items) {
+        tree.Insert(index_key, rid, &transaction);
+      }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    seconds[bulk] = std::chrono::duration<double>(end - start).count();
+
+    GenericKey<8> index_key;
+    std::vector<RID> result;
+    index_key.SetFromInteger(num_keys / 2);
+    EXPECT_TRUE(tree.GetValue(index_key, &result));
+
+    bpm->UnpinPage(header_page_id, true);
+    delete bpm;
+    delete disk_manager;
+    remove("bulk_load_test.db");
+    remove("bulk_load_test.log");
+  }
+
+  std::cout << "[BENCHMARK: BPlusTreeBulkLoadTest.BulkLoadBench] keys: " << num_keys
+            << " insert one by one: " << seconds[0] << "s bulk load: " << seconds[1] << "s" << std::endl;
+}
+
+}  // namespace bustub
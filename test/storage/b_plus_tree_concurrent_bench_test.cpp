@@ -0,0 +1,168 @@
+/**
+ * b_plus_tree_concurrent_bench_test.cpp
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using BenchTree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+const int64_t BENCH_PRELOAD_KEYS = 50000;
+const int64_t BENCH_NUM_OPS = 64000;
+const std::vector<size_t> BENCH_THREAD_COUNTS = {1, 2, 4, 8, 16, 32};
+
+void InsertKeys(BenchTree *tree, const std::vector<int64_t> &keys, size_t num_threads, size_t thread_itr) {
+  GenericKey<8> index_key;
+  Transaction transaction(0);
+  for (size_t i = thread_itr; i < keys.size(); i += num_threads) {
+    index_key.SetFromInteger(keys[i]);
+    tree->Insert(index_key, RID(static_cast<int32_t>(keys[i] >> 32), keys[i] & 0xFFFFFFFF), &transaction);
+  }
+}
+
+void RemoveKeys(BenchTree *tree, const std::vector<int64_t> &keys, size_t num_threads, size_t thread_itr) {
+  GenericKey<8> index_key;
+  Transaction transaction(0);
+  for (size_t i = thread_itr; i < keys.size(); i += num_threads) {
+    index_key.SetFromInteger(keys[i]);
+    tree->Remove(index_key, &transaction);
+  }
+}
+
+double RunThreads(size_t num_threads, const std::function<void(size_t)> &task) {
+  std::vector<std::thread> threads;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads.emplace_back(task, i);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+// The tree is preloaded with the even keys, then every thread inserts its share of BENCH_NUM_OPS odd keys and removes
+// them again. The pool holds the whole tree, so the numbers measure latching rather than disk I/O.
+// NOLINTNEXTLINE
+TEST(BPlusTreeConcurrentBench, InsertRemoveScaling) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  std::vector<int64_t> preload_keys;
+  for (int64_t key = 0; key < BENCH_PRELOAD_KEYS; ++key) {
+    preload_keys.push_back(key * 2);
+  }
+  std::vector<int64_t> op_keys;
+  for (int64_t key = 0; key < BENCH_NUM_OPS; ++key) {
+    op_keys.push_back(key * 2 + 1);
+  }
+  std::mt19937 rng(0);
+  std::shuffle(preload_keys.begin(), preload_keys.end(), rng);
+  std::shuffle(op_keys.begin(), op_keys.end(), rng);
+
+  for (size_t num_threads : BENCH_THREAD_COUNTS) {
+    DiskManager *disk_manager = new DiskManager("concurrent_bench.db");
+    BufferPoolManager *bpm = new BufferPoolManagerInstance(4096, disk_manager);
+    page_id_t header_page_id;
+    bpm->NewPage(&header_page_id);
+    BenchTree tree("concurrent_bench_index", bpm, comparator);
+    InsertKeys(&tree, preload_keys, 1, 0);
+
+    double insert_seconds =
+        RunThreads(num_threads, [&](size_t thread_itr) { InsertKeys(&tree, op_keys, num_threads, thread_itr); });
+    double remove_seconds =
+        RunThreads(num_threads, [&](size_t thread_itr) { RemoveKeys(&tree, op_keys, num_threads, thread_itr); });
+
+    int64_t size = 0;
+    for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator) {
+      ++size;
+    }
+    EXPECT_EQ(BENCH_PRELOAD_KEYS, size);
+
+    std::cout << "[BENCHMARK: BPlusTreeConcurrentBench.InsertRemoveScaling] threads: " << num_threads
+              << " inserts/s: " << static_cast<uint64_t>(BENCH_NUM_OPS / insert_seconds)
+              << " removes/s: " << static_cast<uint64_t>(BENCH_NUM_OPS / remove_seconds) << std::endl;
+
+    bpm->UnpinPage(header_page_id, true);
+    delete bpm;
+    delete disk_manager;
+    remove("concurrent_bench.db");
+    remove("concurrent_bench.log");
+  }
+}
+
+// Read-mostly mix: one in twenty operations inserts a new odd key, the rest look up a preloaded even key.
+// NOLINTNEXTLINE
+TEST(BPlusTreeConcurrentBench, ReadMostlyScaling) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  std::vector<int64_t> preload_keys;
+  for (int64_t key = 0; key < BENCH_PRELOAD_KEYS; ++key) {
+    preload_keys.push_back(key * 2);
+  }
+  std::mt19937 rng(0);
+  std::shuffle(preload_keys.begin(), preload_keys.end(), rng);
+
+  for (size_t num_threads : BENCH_THREAD_COUNTS) {
+    DiskManager *disk_manager = new DiskManager("concurrent_bench.db");
+    BufferPoolManager *bpm = new BufferPoolManagerInstance(4096, disk_manager);
+    page_id_t header_page_id;
+    bpm->NewPage(&header_page_id);
+    BenchTree tree("concurrent_bench_index", bpm, comparator);
+    InsertKeys(&tree, preload_keys, 1, 0);
+
+    const int64_t num_ops = BENCH_NUM_OPS * 4;
+    std::atomic<int64_t> num_found = 0;
+    double seconds = RunThreads(num_threads, [&](size_t thread_itr) {
+      std::mt19937 thread_rng(thread_itr);
+      std::uniform_int_distribution<int64_t> any(0, BENCH_PRELOAD_KEYS - 1);
+      GenericKey<8> index_key;
+      Transaction transaction(0);
+      std::vector<RID> result;
+      int64_t found = 0;
+      for (int64_t i = thread_itr; i < num_ops; i += num_threads) {
+        if (i % 20 == 0) {
+          int64_t key = i + 1;
+          index_key.SetFromInteger(key);
+          tree.Insert(index_key, RID(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF), &transaction);
+          continue;
+        }
+        int64_t key = any(thread_rng) * 2;
+        index_key.SetFromInteger(key);
+        result.clear();
+        if (tree.GetValue(index_key, &result) && result[0].GetSlotNum() == static_cast<uint32_t>(key)) {
+          ++found;
+        }
+      }
+      num_found += found;
+    });
+    EXPECT_EQ(num_ops - (num_ops + 19) / 20, num_found);
+
+    std::cout << "[BENCHMARK: BPlusTreeConcurrentBench.ReadMostlyScaling] threads: " << num_threads
+              << " ops/s: " << static_cast<uint64_t>(num_ops / seconds) << std::endl;
+
+    bpm->UnpinPage(header_page_id, true);
+    delete bpm;
+    delete disk_manager;
+    remove("concurrent_bench.db");
+    remove("concurrent_bench.log");
+  }
+}
+
+}  // namespace bustub
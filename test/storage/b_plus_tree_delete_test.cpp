@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 #include <algorithm>
+#include <sys/stat.h>
+
 #include <cstdio>
 
 #include "buffer/buffer_pool_manager_instance.h"
@@ -175,4 +177,56 @@ TEST(BPlusTreeTests, DeleteTest2) {
   remove("test.db");
   remove("test.log");
 }
+TEST(BPlusTreeTests, DeleteChurnFileSizeTest) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // create b+ tree with small nodes, so that the churn splits and merges many pages
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 8, 8);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // Pages freed by merges are reused by later splits. The second round may still grow the file a little, as reused ids
+  // come back in a different order than the first round allocated them, but from then on it stays flat.
+  const int64_t num_keys = 1000;
+  std::vector<off_t> file_sizes;
+  for (int round = 0; round < 5; ++round) {
+    for (int64_t key = 0; key < num_keys; ++key) {
+      rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, rid, transaction);
+    }
+    for (int64_t key = 0; key < num_keys; ++key) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, transaction);
+    }
+    bpm->FlushAllPages();
+    struct stat file_stat;
+    ASSERT_EQ(0, stat("test.db", &file_stat));
+    file_sizes.push_back(file_stat.st_size);
+  }
+  EXPECT_GT(file_sizes[0], 0);
+  EXPECT_LT(file_sizes[1], 2 * file_sizes[0]);
+  for (size_t round = 2; round < file_sizes.size(); ++round) {
+    EXPECT_EQ(file_sizes[1], file_sizes[round]);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
 }  // namespace bustub
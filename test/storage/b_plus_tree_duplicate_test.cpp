@@ -0,0 +1,208 @@
+/**
+ * b_plus_tree_duplicate_test.cpp
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+using DuplicateTree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+// Both lookups and a full scan see exactly the expected record ids of every key.
+void CheckValues(DuplicateTree *tree, const std::map<int64_t, std::vector<RID>> &expected, int64_t num_keys) {
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < num_keys; ++key) {
+    index_key.SetFromInteger(key);
+    std::vector<RID> result;
+    auto it = expected.find(key);
+    bool exists = it != expected.end() && !it->second.empty();
+    ASSERT_EQ(exists, tree->GetValue(index_key, &result)) << key;
+    if (exists) {
+      std::vector<RID> values = it->second;
+      std::sort(values.begin(), values.end(), [](const RID &lhs, const RID &rhs) { return lhs.Get() < rhs.Get(); });
+      std::sort(result.begin(), result.end(), [](const RID &lhs, const RID &rhs) { return lhs.Get() < rhs.Get(); });
+      EXPECT_EQ(values, result) << key;
+    }
+  }
+
+  std::map<int64_t, std::vector<RID>> scanned;
+  int64_t last_key = -1;
+  for (auto iterator = tree->Begin(); iterator != tree->End(); ++iterator) {
+    int64_t key = (*iterator).first.ToString();
+    EXPECT_LE(last_key, key);
+    last_key = key;
+    scanned[key].push_back((*iterator).second);
+  }
+  for (const auto &[key, values] : expected) {
+    EXPECT_EQ(values.size(), scanned[key].size()) << key;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeDuplicateTest, InsertAndRemoveValues) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  DiskManager *disk_manager = new DiskManager("duplicate_test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  DuplicateTree tree("duplicate_index", bpm, comparator, 5, 5, false, false);
+  Transaction transaction(0);
+
+  // key k has k % 5 values, and key 42 has enough values to fill several posting pages
+  const int64_t num_keys = 100;
+  std::vector<std::pair<int64_t, RID>> entries;
+  for (int64_t key = 0; key < num_keys; ++key) {
+    int64_t num_values = key == 42 ? 3 * POSTING_PAGE_SIZE + 7 : key % 5;
+    for (int64_t i = 0; i < num_values; ++i) {
+      entries.emplace_back(key, RID(static_cast<int32_t>(key), i));
+    }
+  }
+  std::mt19937 rng(0);
+  std::shuffle(entries.begin(), entries.end(), rng);
+
+  std::map<int64_t, std::vector<RID>> expected;
+  GenericKey<8> index_key;
+  for (const auto &[key, rid] : entries) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, rid, &transaction));
+    expected[key].push_back(rid);
+  }
+  CheckValues(&tree, expected, num_keys);
+
+  // the only value of a key can't be added twice
+  index_key.SetFromInteger(1);
+  EXPECT_FALSE(tree.Insert(index_key, RID(1, 0), &transaction));
+
+  // remove every other value, which takes some keys back to a single value and empties posting pages
+  std::shuffle(entries.begin(), entries.end(), rng);
+  for (const auto &[key, rid] : entries) {
+    if (rid.GetSlotNum() % 2 == 0) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, rid, &transaction);
+      auto &values = expected[key];
+      values.erase(std::find(values.begin(), values.end(), rid));
+    }
+  }
+  // a value the key doesn't have changes nothing
+  index_key.SetFromInteger(3);
+  tree.Remove(index_key, RID(3, 100), &transaction);
+  CheckValues(&tree, expected, num_keys);
+
+  // removing a key drops all of its values
+  for (int64_t key = 0; key < num_keys; key += 3) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, &transaction);
+    expected.erase(key);
+  }
+  CheckValues(&tree, expected, num_keys);
+
+  for (const auto &[key, values] : expected) {
+    index_key.SetFromInteger(key);
+    for (const auto &rid : values) {
+      tree.Remove(index_key, rid, &transaction);
+    }
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  bpm->UnpinPage(header_page_id, true);
+  delete bpm;
+  delete disk_manager;
+  remove("duplicate_test.db");
+  remove("duplicate_test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeDuplicateTest, BulkLoadValues) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  DiskManager *disk_manager = new DiskManager("duplicate_test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  DuplicateTree tree("duplicate_index", bpm, comparator, 5, 5, false, false);
+  Transaction transaction(0);
+
+  const int64_t num_keys = 50;
+  std::vector<std::pair<GenericKey<8>, RID>> items;
+  std::map<int64_t, std::vector<RID>> expected;
+  for (int64_t key = 0; key < num_keys; ++key) {
+    int64_t num_values = key == 7 ? POSTING_PAGE_SIZE + 1 : key % 4 + 1;
+    for (int64_t i = 0; i < num_values; ++i) {
+      items.emplace_back();
+      items.back().first.SetFromInteger(key);
+      items.back().second = RID(static_cast<int32_t>(key), i);
+      expected[key].push_back(items.back().second);
+    }
+  }
+  std::mt19937 rng(0);
+  std::shuffle(items.begin(), items.end(), rng);
+  EXPECT_TRUE(tree.BulkLoad(items.begin(), items.end()));
+  CheckValues(&tree, expected, num_keys);
+
+  // the loaded posting lists keep taking values
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(7);
+  EXPECT_TRUE(tree.Insert(index_key, RID(7, 1000), &transaction));
+  expected[7].push_back(RID(7, 1000));
+  CheckValues(&tree, expected, num_keys);
+
+  bpm->UnpinPage(header_page_id, true);
+  delete bpm;
+  delete disk_manager;
+  remove("duplicate_test.db");
+  remove("duplicate_test.log");
+}
+
+// An index on a column with few distinct values returns every matching RID.
+// NOLINTNEXTLINE
+TEST(BPlusTreeDuplicateTest, IndexScanKey) {
+  auto table_schema = ParseCreateStatement("a integer");
+  DiskManager *disk_manager = new DiskManager("duplicate_test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  auto metadata = std::make_unique<IndexMetadata>("duplicate_index", "table", table_schema.get(),
+                                                  std::vector<uint32_t>{0});
+  BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> index(std::move(metadata), bpm);
+  Transaction transaction(0);
+
+  const int num_rows = 3000;
+  for (int i = 0; i < num_rows; ++i) {
+    Tuple key({ValueFactory::GetIntegerValue(i % 3)}, table_schema.get());
+    index.InsertEntry(key, RID(i, 0), &transaction);
+  }
+  for (int value = 0; value < 3; ++value) {
+    Tuple key({ValueFactory::GetIntegerValue(value)}, table_schema.get());
+    std::vector<RID> result;
+    index.ScanKey(key, &result, &transaction);
+    EXPECT_EQ(num_rows / 3, result.size());
+  }
+
+  Tuple key({ValueFactory::GetIntegerValue(1)}, table_schema.get());
+  index.DeleteEntry(key, RID(1, 0), &transaction);
+  std::vector<RID> result;
+  index.ScanKey(key, &result, &transaction);
+  EXPECT_EQ(num_rows / 3 - 1, result.size());
+  EXPECT_EQ(result.end(), std::find(result.begin(), result.end(), RID(1, 0)));
+
+  bpm->UnpinPage(header_page_id, true);
+  delete bpm;
+  delete disk_manager;
+  remove("duplicate_test.db");
+  remove("duplicate_test.log");
+}
+
+}  // namespace bustub
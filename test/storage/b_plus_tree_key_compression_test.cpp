@@ -0,0 +1,230 @@
+/**
+ * b_plus_tree_key_compression_test.cpp
+ */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/page/header_page.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// Number of levels from the root of the named tree down to its leaves.
+template <size_t KeySize>
+int TreeHeight(BufferPoolManager *bpm, const std::string &index_name) {
+  auto *header_page = static_cast<HeaderPage *>(bpm->FetchPage(HEADER_PAGE_ID));
+  page_id_t page_id;
+  EXPECT_TRUE(header_page->GetRootId(index_name, &page_id));
+  bpm->UnpinPage(HEADER_PAGE_ID, false);
+
+  int height = 1;
+  auto *page = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(page_id)->GetData());
+  while (!page->IsLeafPage()) {
+    auto *internal_page =
+        reinterpret_cast<BPlusTreeInternalPage<GenericKey<KeySize>, page_id_t, GenericComparator<KeySize>> *>(page);
+    page_id_t child_page_id = internal_page->ValueAt(0);
+    bpm->UnpinPage(page_id, false);
+    page_id = child_page_id;
+    page = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(page_id)->GetData());
+    ++height;
+  }
+  bpm->UnpinPage(page_id, false);
+  return height;
+}
+
+// Insert the keys in random order, remove every third one, and check lookups and the scan order. Compressed and plain
+// trees must agree.
+template <size_t KeySize>
+void CheckInsertRemove(bool compress_keys) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<KeySize> comparator(key_schema.get());
+  DiskManager *disk_manager = new DiskManager("key_compression_test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(100, disk_manager);
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  BPlusTree<GenericKey<KeySize>, RID, GenericComparator<KeySize>> tree("key_compression_index", bpm, comparator, 5, 5,
+                                                                       compress_keys);
+  Transaction transaction(0);
+
+  const int64_t num_keys = 5000;
+  std::vector<int64_t> keys;
+  for (int64_t key = -num_keys / 2; key < num_keys / 2; ++key) {
+    keys.push_back(key);
+  }
+  std::mt19937 rng(0);
+  std::shuffle(keys.begin(), keys.end(), rng);
+
+  GenericKey<KeySize> index_key;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, key & 0xFFFFFFFF), &transaction));
+  }
+  for (auto key : keys) {
+    if (key % 3 == 0) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, &transaction);
+    }
+  }
+
+  std::vector<RID> result;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    result.clear();
+    EXPECT_EQ(key % 3 != 0, tree.GetValue(index_key, &result)) << key;
+    if (key % 3 != 0) {
+      ASSERT_EQ(1, result.size());
+      EXPECT_EQ(key & 0xFFFFFFFF, result[0].GetSlotNum());
+    }
+  }
+  std::vector<int64_t> expected;
+  for (int64_t key = -num_keys / 2; key < num_keys / 2; ++key) {
+    if (key % 3 != 0) {
+      expected.push_back(key);
+    }
+  }
+  size_t i = 0;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator, ++i) {
+    ASSERT_LT(i, expected.size());
+    EXPECT_EQ(expected[i], (*iterator).first.ToString());
+    EXPECT_EQ(expected[i] & 0xFFFFFFFF, (*iterator).second.GetSlotNum());
+  }
+  EXPECT_EQ(expected.size(), i);
+
+  bpm->UnpinPage(header_page_id, true);
+  delete bpm;
+  delete disk_manager;
+  remove("key_compression_test.db");
+  remove("key_compression_test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeKeyCompressionTest, InsertRemove) {
+  CheckInsertRemove<8>(false);
+  CheckInsertRemove<8>(true);
+  CheckInsertRemove<64>(false);
+  CheckInsertRemove<64>(true);
+}
+
+// A composite key built from tuples keeps its column order when only its first bytes are stored.
+// NOLINTNEXTLINE
+TEST(BPlusTreeKeyCompressionTest, CompositeKeys) {
+  auto key_schema = ParseCreateStatement("a integer,b smallint");
+  GenericComparator<32> comparator(key_schema.get());
+  EXPECT_EQ(6, comparator.KeyLength());
+  DiskManager *disk_manager = new DiskManager("key_compression_test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(100, disk_manager);
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  BPlusTree<GenericKey<32>, RID, GenericComparator<32>> tree("key_compression_index", bpm, comparator, 5, 5, true);
+  Transaction transaction(0);
+
+  std::vector<std::pair<int32_t, int16_t>> columns;
+  for (int32_t a = -20; a < 20; ++a) {
+    for (int16_t b = -10; b < 10; ++b) {
+      columns.emplace_back(a, b);
+    }
+  }
+  std::vector<std::pair<int32_t, int16_t>> shuffled = columns;
+  std::mt19937 rng(0);
+  std::shuffle(shuffled.begin(), shuffled.end(), rng);
+  GenericKey<32> index_key;
+  for (size_t i = 0; i < shuffled.size(); ++i) {
+    auto [a, b] = shuffled[i];
+    index_key.SetFromKey(
+        Tuple({ValueFactory::GetIntegerValue(a), ValueFactory::GetSmallIntValue(b)}, key_schema.get()));
+    EXPECT_TRUE(tree.Insert(index_key, RID(a, b), &transaction));
+  }
+
+  size_t i = 0;
+  for (auto iterator = tree.Begin(); iterator != tree.End(); ++iterator, ++i) {
+    ASSERT_LT(i, columns.size());
+    EXPECT_EQ(columns[i].first, (*iterator).second.GetPageId());
+    EXPECT_EQ(static_cast<uint32_t>(columns[i].second), (*iterator).second.GetSlotNum());
+    EXPECT_EQ(columns[i].first, (*iterator).first.ToValue(key_schema.get(), 0).GetAs<int32_t>());
+    EXPECT_EQ(columns[i].second, (*iterator).first.ToValue(key_schema.get(), 1).GetAs<int16_t>());
+  }
+  EXPECT_EQ(columns.size(), i);
+
+  bpm->UnpinPage(header_page_id, true);
+  delete bpm;
+  delete disk_manager;
+  remove("key_compression_test.db");
+  remove("key_compression_test.log");
+}
+
+// Builds the same bigint index with plain and compressed pages and reports pages used, height and lookup speed.
+template <size_t KeySize>
+void CompareFormats(const std::vector<int64_t> &keys) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<KeySize> comparator(key_schema.get());
+  for (bool compress_keys : {false, true}) {
+    DiskManager *disk_manager = new DiskManager("key_compression_test.db");
+    BufferPoolManager *bpm = new BufferPoolManagerInstance(16384, disk_manager);
+    page_id_t header_page_id;
+    bpm->NewPage(&header_page_id);
+    // the default page sizes, which compression scales up to what the page then fits
+    int leaf_max_size = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<KeySize>, RID>);
+    int internal_max_size = (PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<KeySize>, page_id_t>);
+    BPlusTree<GenericKey<KeySize>, RID, GenericComparator<KeySize>> tree(
+        "key_compression_index", bpm, comparator, leaf_max_size, internal_max_size, compress_keys);
+    Transaction transaction(0);
+
+    GenericKey<KeySize> index_key;
+    for (auto key : keys) {
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, RID(0, key & 0xFFFFFFFF), &transaction);
+    }
+    // page ids are handed out in order, so the next one tells how many pages the tree took
+    page_id_t next_page_id;
+    bpm->NewPage(&next_page_id);
+    bpm->UnpinPage(next_page_id, false);
+    int height = TreeHeight<KeySize>(bpm, "key_compression_index");
+
+    std::vector<RID> result;
+    int64_t found = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (auto key : keys) {
+      index_key.SetFromInteger(key);
+      result.clear();
+      found += static_cast<int64_t>(tree.GetValue(index_key, &result));
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    EXPECT_EQ(keys.size(), found);
+
+    std::cout << "[BENCHMARK: BPlusTreeKeyCompressionTest.MemoryAndHeight] GenericKey<" << KeySize << "> "
+              << (compress_keys ? "compressed" : "plain") << " keys: " << keys.size()
+              << " pages: " << next_page_id - header_page_id - 1 << " height: " << height
+              << " lookups/s: " << static_cast<uint64_t>(keys.size() / seconds) << std::endl;
+
+    bpm->UnpinPage(header_page_id, true);
+    delete bpm;
+    delete disk_manager;
+    remove("key_compression_test.db");
+    remove("key_compression_test.log");
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeKeyCompressionTest, MemoryAndHeight) {
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < 300000; ++key) {
+    keys.push_back(key);
+  }
+  std::mt19937 rng(0);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  CompareFormats<32>(keys);
+  CompareFormats<64>(keys);
+}
+
+}  // namespace bustub
@@ -0,0 +1,78 @@
+/**
+ * b_plus_tree_lookup_bench_test.cpp
+ */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"
+
+namespace bustub {
+
+const int64_t BENCH_NUM_KEYS = 100000;
+const size_t BENCH_NUM_LOOKUPS = 500000;
+
+// The pool holds the whole tree, so the benchmark measures searching pages rather than disk I/O.
+// NOLINTNEXTLINE
+TEST(BPlusTreeLookupBench, PointLookup) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  DiskManager *disk_manager = new DiskManager("lookup_bench.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(2048, disk_manager);
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("lookup_bench_index", bpm, comparator);
+  Transaction *transaction = new Transaction(0);
+
+  std::vector<int64_t> keys(BENCH_NUM_KEYS);
+  for (int64_t i = 0; i < BENCH_NUM_KEYS; ++i) {
+    keys[i] = i;
+  }
+  std::mt19937 rng(0);
+  std::shuffle(keys.begin(), keys.end(), rng);
+
+  GenericKey<8> index_key;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int64_t key : keys) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF), transaction);
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  double insert_seconds = std::chrono::duration<double>(end - start).count();
+
+  std::uniform_int_distribution<int64_t> any(0, BENCH_NUM_KEYS - 1);
+  std::vector<RID> result;
+  size_t num_found = 0;
+  start = std::chrono::high_resolution_clock::now();
+  for (size_t i = 0; i < BENCH_NUM_LOOKUPS; ++i) {
+    int64_t key = any(rng);
+    index_key.SetFromInteger(key);
+    result.clear();
+    if (tree.GetValue(index_key, &result) && result[0].GetSlotNum() == static_cast<uint32_t>(key)) {
+      ++num_found;
+    }
+  }
+  end = std::chrono::high_resolution_clock::now();
+  double lookup_seconds = std::chrono::duration<double>(end - start).count();
+  EXPECT_EQ(BENCH_NUM_LOOKUPS, num_found);
+
+  std::cout << "[BENCHMARK: BPlusTreeLookupBench.PointLookup] inserts/s: "
+            << static_cast<uint64_t>(BENCH_NUM_KEYS / insert_seconds)
+            << " lookups/s: " << static_cast<uint64_t>(BENCH_NUM_LOOKUPS / lookup_seconds) << std::endl;
+
+  bpm->UnpinPage(header_page_id, true);
+  delete transaction;
+  delete bpm;
+  delete disk_manager;
+  remove("lookup_bench.db");
+  remove("lookup_bench.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,176 @@
+/**
+ * b_plus_tree_merge_test.cpp
+ */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using MergeTree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+// Count the leaves of the tree by following their next page ids.
+int CountLeaves(MergeTree *tree, BufferPoolManager *bpm) {
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(0);
+  Page *page = tree->FindLeafPage(index_key, true);
+  int num_leaves = 0;
+  while (true) {
+    ++num_leaves;
+    page_id_t next_page_id = reinterpret_cast<BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>> *>(
+                                 page->GetData())
+                                 ->GetNextPageId();
+    bpm->UnpinPage(page->GetPageId(), false);
+    if (next_page_id == INVALID_PAGE_ID) {
+      return num_leaves;
+    }
+    page = bpm->FetchPage(next_page_id);
+  }
+}
+
+// The tree holds exactly the expected keys, in order.
+void CheckKeys(MergeTree *tree, const std::vector<int64_t> &expected) {
+  std::vector<int64_t> keys;
+  for (auto iterator = tree->Begin(); iterator != tree->End(); ++iterator) {
+    keys.push_back((*iterator).first.ToString());
+  }
+  EXPECT_EQ(expected, keys);
+  GenericKey<8> index_key;
+  for (auto key : expected) {
+    index_key.SetFromInteger(key);
+    std::vector<RID> result;
+    EXPECT_TRUE(tree->GetValue(index_key, &result)) << key;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeMergeTest, LazyMergeAndCompact) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  DiskManager *disk_manager = new DiskManager("merge_test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  MergeTree tree("merge_index", bpm, comparator, 8, 8);
+  tree.SetLeafMergeThreshold(0);
+  Transaction transaction(0);
+
+  std::vector<int64_t> keys(1000);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    keys[i] = static_cast<int64_t>(i);
+  }
+  std::mt19937 rng(0);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  GenericKey<8> index_key;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, key), &transaction));
+  }
+  int full_leaves = CountLeaves(&tree, bpm);
+
+  // keep one key in ten; leaves only go away once they are empty
+  std::vector<int64_t> expected;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    if (key % 10 != 0) {
+      tree.Remove(index_key, &transaction);
+    } else {
+      expected.push_back(key);
+    }
+  }
+  std::sort(expected.begin(), expected.end());
+  CheckKeys(&tree, expected);
+  int lazy_leaves = CountLeaves(&tree, bpm);
+  EXPECT_GT(lazy_leaves, static_cast<int>(expected.size()) / 4);
+  EXPECT_LE(lazy_leaves, full_leaves);
+
+  // compaction packs the leaves to at least half full
+  tree.Compact(&transaction);
+  CheckKeys(&tree, expected);
+  int compact_leaves = CountLeaves(&tree, bpm);
+  EXPECT_LT(compact_leaves, lazy_leaves);
+  EXPECT_LE(compact_leaves, static_cast<int>(expected.size()) / 3 + 1);
+
+  // removing the rest empties the tree
+  for (auto key : expected) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, &transaction);
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+  tree.Compact(&transaction);
+
+  bpm->UnpinPage(header_page_id, true);
+  delete bpm;
+  delete disk_manager;
+  remove("merge_test.db");
+  remove("merge_test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeMergeTest, BackgroundCompaction) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  DiskManager *disk_manager = new DiskManager("merge_test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  auto interval = btree_compaction_interval;
+  btree_compaction_interval = std::chrono::milliseconds(1);
+  {
+    MergeTree tree("merge_index", bpm, comparator, 8, 8);
+    tree.SetLeafMergeThreshold(0.1);
+    Transaction transaction(0);
+    GenericKey<8> index_key;
+    const int64_t num_keys = 2000;
+    for (int64_t key = 0; key < num_keys; ++key) {
+      index_key.SetFromInteger(key);
+      tree.Insert(index_key, RID(0, key), &transaction);
+    }
+
+    // two threads remove keys while the tree compacts itself
+    tree.StartBackgroundCompaction();
+    std::vector<std::thread> threads;
+    for (int64_t part = 0; part < 2; ++part) {
+      threads.emplace_back([&tree, part, num_keys] {
+        Transaction thread_transaction(static_cast<txn_id_t>(part + 1));
+        GenericKey<8> thread_key;
+        for (int64_t key = part; key < num_keys; key += 2) {
+          if (key % 8 != 0) {
+            thread_key.SetFromInteger(key);
+            tree.Remove(thread_key, &thread_transaction);
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    tree.StopBackgroundCompaction();
+
+    std::vector<int64_t> expected;
+    for (int64_t key = 0; key < num_keys; key += 8) {
+      expected.push_back(key);
+    }
+    CheckKeys(&tree, expected);
+    EXPECT_LE(CountLeaves(&tree, bpm), static_cast<int>(expected.size()) / 3 + 1);
+  }
+  btree_compaction_interval = interval;
+
+  bpm->UnpinPage(header_page_id, true);
+  delete bpm;
+  delete disk_manager;
+  remove("merge_test.db");
+  remove("merge_test.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,136 @@
+/**
+ * b_plus_tree_range_test.cpp
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using RangeTree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+// Drain the iterator and return its keys in the order they came.
+std::vector<int64_t> Keys(RangeTree *tree, IndexIterator<GenericKey<8>, RID, GenericComparator<8>> &&iterator) {
+  std::vector<int64_t> keys;
+  for (; iterator != tree->End(); ++iterator) {
+    keys.push_back((*iterator).first.ToString());
+    EXPECT_EQ(keys.back(), (*iterator).second.GetSlotNum());
+  }
+  return keys;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeRangeTest, ReverseAndRange) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  DiskManager *disk_manager = new DiskManager("range_test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  RangeTree tree("range_index", bpm, comparator, 5, 5);
+  Transaction transaction(0);
+
+  // even keys only, so that odd bounds fall between keys; removing some merges leaves
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < 2000; key += 2) {
+    keys.push_back(key);
+  }
+  std::mt19937 rng(0);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  GenericKey<8> index_key;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, key), &transaction));
+  }
+  std::vector<int64_t> expected;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    if (key % 6 == 0) {
+      tree.Remove(index_key, &transaction);
+    } else {
+      expected.push_back(key);
+    }
+  }
+  std::sort(expected.begin(), expected.end());
+
+  EXPECT_EQ(expected, Keys(&tree, tree.Begin()));
+  std::vector<int64_t> reversed(expected.rbegin(), expected.rend());
+  EXPECT_EQ(reversed, Keys(&tree, tree.RBegin()));
+
+  for (int64_t key : {-1, 0, 4, 5, 998, 1001, 1996, 1998, 2500}) {
+    index_key.SetFromInteger(key);
+    std::vector<int64_t> at_most;
+    std::copy_if(reversed.begin(), reversed.end(), std::back_inserter(at_most), [&](int64_t k) { return k <= key; });
+    EXPECT_EQ(at_most, Keys(&tree, tree.RBegin(index_key))) << key;
+  }
+
+  GenericKey<8> low_key;
+  GenericKey<8> high_key;
+  std::vector<std::pair<int64_t, int64_t>> bounds = {{-10, 3000}, {100, 200},  {101, 199}, {4, 4},    {5, 5},
+                                                     {500, 400},  {-10, -1},   {1998, 3000}, {2, 1996}, {998, 1004}};
+  for (auto [low, high] : bounds) {
+    low_key.SetFromInteger(low);
+    high_key.SetFromInteger(high);
+    for (bool low_inclusive : {false, true}) {
+      for (bool high_inclusive : {false, true}) {
+        std::vector<int64_t> in_range;
+        std::copy_if(expected.begin(), expected.end(), std::back_inserter(in_range), [&](int64_t k) {
+          return (low_inclusive ? k >= low : k > low) && (high_inclusive ? k <= high : k < high);
+        });
+        EXPECT_EQ(in_range, Keys(&tree, tree.Range(low_key, high_key, low_inclusive, high_inclusive))) << low << " "
+                                                                                                        << high;
+        std::reverse(in_range.begin(), in_range.end());
+        EXPECT_EQ(in_range, Keys(&tree, tree.Range(low_key, high_key, low_inclusive, high_inclusive, true)))
+            << low << " " << high;
+      }
+    }
+  }
+
+  // a range iterator that stopped is the end iterator
+  low_key.SetFromInteger(100);
+  high_key.SetFromInteger(104);
+  auto iterator = tree.Range(low_key, high_key);
+  ++iterator;
+  ++iterator;
+  EXPECT_TRUE(iterator.IsEnd());
+
+  bpm->UnpinPage(header_page_id, true);
+  delete bpm;
+  delete disk_manager;
+  remove("range_test.db");
+  remove("range_test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeRangeTest, EmptyTree) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  DiskManager *disk_manager = new DiskManager("range_test.db");
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  RangeTree tree("range_index", bpm, comparator, 5, 5);
+
+  GenericKey<8> low_key;
+  GenericKey<8> high_key;
+  low_key.SetFromInteger(0);
+  high_key.SetFromInteger(10);
+  EXPECT_TRUE(tree.RBegin() == tree.REnd());
+  EXPECT_TRUE(tree.RBegin(high_key) == tree.REnd());
+  EXPECT_TRUE(tree.Range(low_key, high_key) == tree.End());
+
+  bpm->UnpinPage(header_page_id, true);
+  delete bpm;
+  delete disk_manager;
+  remove("range_test.db");
+  remove("range_test.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_bench_test.cpp
+//
+// Identification: test/storage/disk_manager_bench_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+const size_t BENCH_NUM_PAGES = 1024;
+const size_t BENCH_NUM_READS = 4096;
+
+std::string BackendName(DiskIOBackendType backend_type) {
+  return backend_type == DiskIOBackendType::IO_URING ? "io_uring" : "thread_pool";
+}
+
+// Random page reads, keeping `depth` requests outstanding per batch. Returns pages per second.
+double RandomReadBenchmark(DiskManager *dm, size_t depth) {
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<page_id_t> dist(0, BENCH_NUM_PAGES - 1);
+  std::vector<char *> buffers(depth);
+  for (auto &buffer : buffers) {
+    buffer = static_cast<char *>(std::aligned_alloc(PAGE_SIZE, PAGE_SIZE));
+  }
+  std::vector<DiskRequest> requests(depth);
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (size_t done = 0; done < BENCH_NUM_READS; done += depth) {
+    for (size_t i = 0; i < depth; ++i) {
+      requests[i] = {false, dist(rng), buffers[i]};
+    }
+    dm->ExecuteRequests(requests.data(), depth);
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+
+  for (auto &buffer : buffers) {
+    std::free(buffer);
+  }
+  return BENCH_NUM_READS / std::chrono::duration<double>(end - start).count();
+}
+
+// Random page reads from `num_threads` threads at once, each keeping `depth` requests outstanding per batch. With a
+// depth of 1 these are single-page reads like buffer pool misses. Returns pages per second.
+double ConcurrentReadBenchmark(DiskManager *dm, size_t num_threads, size_t depth) {
+  std::vector<std::thread> threads;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (size_t thread_index = 0; thread_index < num_threads; ++thread_index) {
+    threads.emplace_back([dm, num_threads, depth, thread_index] {
+      std::mt19937 rng(thread_index);
+      std::uniform_int_distribution<page_id_t> dist(0, BENCH_NUM_PAGES - 1);
+      std::vector<char *> buffers(depth);
+      for (auto &buffer : buffers) {
+        buffer = static_cast<char *>(std::aligned_alloc(PAGE_SIZE, PAGE_SIZE));
+      }
+      std::vector<DiskRequest> requests(depth);
+      for (size_t done = 0; done < BENCH_NUM_READS / num_threads; done += depth) {
+        for (size_t i = 0; i < depth; ++i) {
+          requests[i] = {false, dist(rng), buffers[i]};
+        }
+        dm->ExecuteRequests(requests.data(), depth);
+      }
+      for (auto &buffer : buffers) {
+        std::free(buffer);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  return BENCH_NUM_READS / std::chrono::duration<double>(end - start).count();
+}
+
+// NOLINTNEXTLINE
+TEST(DiskManagerBench, OutstandingRequests) {
+  for (auto backend_type : {DiskIOBackendType::IO_URING, DiskIOBackendType::THREAD_POOL}) {
+    const std::string db_name = "disk_manager_bench.db";
+    DiskManager dm(db_name, backend_type);
+
+    // Lay out the file with batched writes.
+    std::vector<char *> buffers(BENCH_NUM_PAGES);
+    std::vector<DiskRequest> requests;
+    for (size_t i = 0; i < BENCH_NUM_PAGES; ++i) {
+      buffers[i] = static_cast<char *>(std::aligned_alloc(PAGE_SIZE, PAGE_SIZE));
+      snprintf(buffers[i], PAGE_SIZE, "page %zu", i);
+      requests.push_back({true, static_cast<page_id_t>(i), buffers[i]});
+    }
+    dm.ExecuteRequests(requests.data(), requests.size());
+    for (auto &buffer : buffers) {
+      std::free(buffer);
+    }
+
+    for (size_t depth : {1, 4, 16}) {
+      double pages_per_second = RandomReadBenchmark(&dm, depth);
+      std::cout << "[BENCHMARK: DiskManagerBench.OutstandingRequests] backend: " << BackendName(dm.GetBackendType())
+                << " direct_io: " << dm.IsDirectIO() << " outstanding: " << depth
+                << " pages/s: " << static_cast<uint64_t>(pages_per_second) << std::endl;
+    }
+    for (size_t depth : {1, 4}) {
+      for (size_t num_threads : {4, 16}) {
+        double pages_per_second = ConcurrentReadBenchmark(&dm, num_threads, depth);
+        std::cout << "[BENCHMARK: DiskManagerBench.OutstandingRequests] backend: " << BackendName(dm.GetBackendType())
+                  << " direct_io: " << dm.IsDirectIO() << " threads: " << num_threads << " outstanding: " << depth
+                  << " pages/s: " << static_cast<uint64_t>(pages_per_second) << std::endl;
+      }
+    }
+
+    dm.ShutDown();
+    remove(db_name.c_str());
+    remove("disk_manager_bench.log");
+  }
+}
+
+}  // namespace bustub
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <cstring>
+#include <vector>
 
 #include "common/exception.h"
 #include "gtest/gtest.h"
@@ -55,6 +56,40 @@ TEST_F(DiskManagerTest, ReadWritePageTest) {
   dm.ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, BatchedReadWritePageTest) {
+  const size_t num_pages = 100;
+  std::string db_file("test.db");
+  for (auto backend_type : {DiskIOBackendType::IO_URING, DiskIOBackendType::THREAD_POOL}) {
+    auto dm = DiskManager(db_file, backend_type);
+    std::vector<std::vector<char>> data(num_pages, std::vector<char>(PAGE_SIZE));
+    std::vector<std::vector<char>> buf(num_pages, std::vector<char>(PAGE_SIZE, 1));
+    std::vector<DiskRequest> requests;
+    for (size_t i = 0; i < num_pages; ++i) {
+      snprintf(data[i].data(), PAGE_SIZE, "page %zu", i);
+      requests.push_back({true, static_cast<page_id_t>(i), data[i].data()});
+    }
+    dm.ExecuteRequests(requests.data(), requests.size());
+    EXPECT_EQ(num_pages, dm.GetNumWrites());
+
+    // Read back in reverse order, together with a page past the end of the file that should read as zeros.
+    requests.clear();
+    for (size_t i = 0; i < num_pages; ++i) {
+      requests.push_back({false, static_cast<page_id_t>(num_pages - 1 - i), buf[i].data()});
+    }
+    std::vector<char> past_end(PAGE_SIZE, 1);
+    requests.push_back({false, static_cast<page_id_t>(num_pages * 2), past_end.data()});
+    dm.ExecuteRequests(requests.data(), requests.size());
+    for (size_t i = 0; i < num_pages; ++i) {
+      EXPECT_EQ(data[num_pages - 1 - i], buf[i]);
+    }
+    EXPECT_EQ(std::vector<char>(PAGE_SIZE, 0), past_end);
+
+    dm.ShutDown();
+    remove("test.db");
+  }
+}
+
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ReadWriteLogTest) {
   char buf[16] = {0};
@@ -0,0 +1,114 @@
+/**
+ * generic_comparator_test.cpp
+ */
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// Compare column by column through Value, the way GenericComparator used to.
+template <size_t KeySize>
+int ReferenceCompare(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs, Schema *key_schema) {
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    Value lhs_value = lhs.ToValue(key_schema, i);
+    Value rhs_value = rhs.ToValue(key_schema, i);
+    if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+template <size_t KeySize>
+GenericKey<KeySize> MakeKey(const std::vector<Value> &values, Schema *key_schema) {
+  GenericKey<KeySize> key;
+  key.SetFromKey(Tuple(values, key_schema));
+  return key;
+}
+
+template <size_t KeySize>
+void CheckAllPairs(const std::vector<GenericKey<KeySize>> &keys, Schema *key_schema) {
+  GenericComparator<KeySize> comparator(key_schema);
+  GenericComparator<KeySize> copy(comparator);
+  for (const auto &lhs : keys) {
+    for (const auto &rhs : keys) {
+      EXPECT_EQ(ReferenceCompare(lhs, rhs, key_schema), comparator(lhs, rhs));
+      EXPECT_EQ(ReferenceCompare(lhs, rhs, key_schema), copy(lhs, rhs));
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(GenericComparatorTest, IntegerKeys) {
+  auto key_schema = ParseCreateStatement("a integer");
+  std::vector<GenericKey<4>> keys;
+  for (int32_t v : {0, 1, -1, 42, -42, 1 << 30, -(1 << 30), BUSTUB_INT32_MAX, BUSTUB_INT32_MIN}) {
+    keys.push_back(MakeKey<4>({ValueFactory::GetIntegerValue(v)}, key_schema.get()));
+  }
+  keys.push_back(MakeKey<4>({ValueFactory::GetNullValueByType(TypeId::INTEGER)}, key_schema.get()));
+  CheckAllPairs(keys, key_schema.get());
+}
+
+// NOLINTNEXTLINE
+TEST(GenericComparatorTest, BigIntKeys) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  std::vector<GenericKey<8>> keys;
+  std::mt19937_64 rng(0);
+  for (int i = 0; i < 50; i++) {
+    GenericKey<8> key;
+    key.SetFromInteger(static_cast<int64_t>(rng()));
+    keys.push_back(key);
+  }
+  for (int64_t v : {0L, 1L, -1L}) {
+    GenericKey<8> key;
+    key.SetFromInteger(v);
+    keys.push_back(key);
+  }
+  CheckAllPairs(keys, key_schema.get());
+}
+
+// NOLINTNEXTLINE
+TEST(GenericComparatorTest, FixedWidthCompositeKeys) {
+  auto key_schema = ParseCreateStatement("a smallint,b integer,c double,d boolean");
+  std::vector<GenericKey<16>> keys;
+  for (int16_t a : {-3, 0, 7}) {
+    for (int32_t b : {-100, 5}) {
+      for (double c : {-1.5, 0.0, 2.25}) {
+        for (bool d : {false, true}) {
+          keys.push_back(MakeKey<16>({ValueFactory::GetSmallIntValue(a), ValueFactory::GetIntegerValue(b),
+                                      ValueFactory::GetDecimalValue(c), ValueFactory::GetBooleanValue(d)},
+                                     key_schema.get()));
+        }
+      }
+    }
+  }
+  keys.push_back(MakeKey<16>({ValueFactory::GetSmallIntValue(0), ValueFactory::GetNullValueByType(TypeId::INTEGER),
+                              ValueFactory::GetDecimalValue(1.0), ValueFactory::GetBooleanValue(true)},
+                             key_schema.get()));
+  CheckAllPairs(keys, key_schema.get());
+}
+
+// NOLINTNEXTLINE
+TEST(GenericComparatorTest, VarcharKeysFallBackToValues) {
+  auto key_schema = ParseCreateStatement("a integer,b varchar(8)");
+  std::vector<GenericKey<32>> keys;
+  for (int32_t a : {1, 2}) {
+    for (const char *b : {"", "abc", "abd", "b"}) {
+      keys.push_back(MakeKey<32>({ValueFactory::GetIntegerValue(a), ValueFactory::GetVarcharValue(std::string(b))},
+                                 key_schema.get()));
+    }
+  }
+  CheckAllPairs(keys, key_schema.get());
+}
+
+}  // namespace bustub
@@ -54,7 +54,8 @@ TEST(BPlusTreeTests, SplitTest) {
   }
   index_key.SetFromInteger(1);
   auto leaf_node =
-      reinterpret_cast<BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>> *>(tree.FindLeafPage(index_key));
+      reinterpret_cast<BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>> *>(
+      tree.FindLeafPage(index_key)->GetData());
   ASSERT_NE(nullptr, leaf_node);
   EXPECT_EQ(1, leaf_node->GetSize());
   EXPECT_EQ(2, leaf_node->GetMaxSize());
@@ -63,7 +64,7 @@ TEST(BPlusTreeTests, SplitTest) {
   for (int i = 0; i < 4; i++) {
     EXPECT_NE(INVALID_PAGE_ID, leaf_node->GetNextPageId());
     leaf_node = reinterpret_cast<BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>> *>(
-        bpm->FetchPage(leaf_node->GetNextPageId()));
+        bpm->FetchPage(leaf_node->GetNextPageId())->GetData());
   }
 
   EXPECT_EQ(INVALID_PAGE_ID, leaf_node->GetNextPageId());
@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// scan_read_ahead_bench_test.cpp
+//
+// Identification: test/storage/scan_read_ahead_bench_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/table/table_heap.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+const size_t BENCH_POOL_SIZE = 64;
+const size_t BENCH_TABLE_PAGES = 4096;
+const int64_t BENCH_NUM_KEYS = 200000;
+
+std::unique_ptr<BufferPoolManager> MakeBufferPool(DiskManager *disk_manager, bool parallel) {
+  if (parallel) {
+    return std::make_unique<ParallelBufferPoolManager>(4, BENCH_POOL_SIZE / 4, disk_manager);
+  }
+  return std::make_unique<BufferPoolManagerInstance>(BENCH_POOL_SIZE, disk_manager);
+}
+
+// Fill BENCH_TABLE_PAGES table pages directly, which is much faster than going through TableHeap::InsertTuple since
+// that walks the heap from its first page on every insert. Returns the first page id and the number of tuples.
+std::pair<page_id_t, size_t> BuildTable(BufferPoolManager *bpm, const Schema *schema, Transaction *txn) {
+  Tuple tuple({ValueFactory::GetIntegerValue(0), ValueFactory::GetVarcharValue(std::string(200, 'x'))}, schema);
+  page_id_t first_page_id;
+  auto *page = static_cast<TablePage *>(bpm->NewPage(&first_page_id));
+  page->Init(first_page_id, PAGE_SIZE, INVALID_PAGE_ID, nullptr, txn);
+  size_t num_tuples = 0;
+  for (size_t i = 1;; ++i) {
+    RID rid;
+    while (page->InsertTuple(tuple, &rid, txn, nullptr, nullptr)) {
+      ++num_tuples;
+    }
+    if (i == BENCH_TABLE_PAGES) {
+      break;
+    }
+    page_id_t next_page_id;
+    auto *next_page = static_cast<TablePage *>(bpm->NewPage(&next_page_id));
+    next_page->Init(next_page_id, PAGE_SIZE, page->GetTablePageId(), nullptr, txn);
+    page->SetNextPageId(next_page_id);
+    bpm->UnpinPage(page->GetTablePageId(), true);
+    page = next_page;
+  }
+  bpm->UnpinPage(page->GetTablePageId(), true);
+  // Write everything back so that the scans only pay for reads.
+  bpm->FlushAllPages();
+  return {first_page_id, num_tuples};
+}
+
+// Each run scans a table of BENCH_TABLE_PAGES pages through a pool of BENCH_POOL_SIZE frames, so nearly every page of
+// the scan is a miss unless it was read ahead.
+void RunTableScanBenchmarks(const std::string &name, bool parallel) {
+  const std::string db_name = "read_ahead_bench.db";
+  auto *disk_manager = new DiskManager(db_name);
+  auto bpm = MakeBufferPool(disk_manager, parallel);
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 200)});
+  Transaction txn(0);
+  auto [first_page_id, num_tuples] = BuildTable(bpm.get(), &schema, &txn);
+  TableHeap table(bpm.get(), nullptr, nullptr, first_page_id);
+
+  size_t saved_read_ahead_pages = table_scan_read_ahead_pages;
+  for (size_t read_ahead_pages : {0, 8}) {
+    table_scan_read_ahead_pages = read_ahead_pages;
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t count = 0;
+    for (auto iter = table.Begin(&txn); iter != table.End(); ++iter) {
+      ++count;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    EXPECT_EQ(num_tuples, count);
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << "[BENCHMARK: ScanReadAheadBench." << name << "] read-ahead: " << read_ahead_pages
+              << " pages/s: " << static_cast<uint64_t>(BENCH_TABLE_PAGES / seconds)
+              << " tuples/s: " << static_cast<uint64_t>(count / seconds) << std::endl;
+  }
+  table_scan_read_ahead_pages = saved_read_ahead_pages;
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove("read_ahead_bench.log");
+  bpm.reset();
+  delete disk_manager;
+}
+
+// Each run scans all leaves of a B+ tree of BENCH_NUM_KEYS keys, several times larger than the pool.
+void RunIndexScanBenchmarks(const std::string &name, bool parallel) {
+  const std::string db_name = "read_ahead_bench.db";
+  auto *disk_manager = new DiskManager(db_name);
+  auto bpm = MakeBufferPool(disk_manager, parallel);
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("read_ahead_index", bpm.get(), comparator);
+  Transaction txn(0);
+  GenericKey<8> index_key;
+  for (int64_t key = 0; key < BENCH_NUM_KEYS; ++key) {
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, RID(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF), &txn);
+  }
+  bpm->UnpinPage(header_page_id, true);
+  bpm->FlushAllPages();
+
+  size_t saved_read_ahead_pages = scan_read_ahead_pages;
+  for (size_t read_ahead_pages : {0, 8, 16, 32}) {
+    scan_read_ahead_pages = read_ahead_pages;
+    auto start = std::chrono::high_resolution_clock::now();
+    int64_t count = 0;
+    for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+      EXPECT_EQ(count, (*iter).second.GetSlotNum());
+      ++count;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    EXPECT_EQ(BENCH_NUM_KEYS, count);
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << "[BENCHMARK: ScanReadAheadBench." << name << "] read-ahead: " << read_ahead_pages
+              << " keys/s: " << static_cast<uint64_t>(count / seconds) << std::endl;
+  }
+  scan_read_ahead_pages = saved_read_ahead_pages;
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove("read_ahead_bench.log");
+  bpm.reset();
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ScanReadAheadBench, TableScan) { RunTableScanBenchmarks("TableScan", false); }
+
+// NOLINTNEXTLINE
+TEST(ScanReadAheadBench, ParallelTableScan) { RunTableScanBenchmarks("ParallelTableScan", true); }
+
+// NOLINTNEXTLINE
+TEST(ScanReadAheadBench, IndexScan) { RunIndexScanBenchmarks("IndexScan", false); }
+
+// NOLINTNEXTLINE
+TEST(ScanReadAheadBench, ParallelIndexScan) { RunIndexScanBenchmarks("ParallelIndexScan", true); }
+
+}  // namespace bustub